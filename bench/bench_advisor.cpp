@@ -0,0 +1,55 @@
+// bench_advisor – Advisor candidate scoring latency against corpus size.
+//
+// Fills an Advisor with synthetic telemetry (one in four entries trapped)
+// and times score(), the indexed exact-match check, and likelihoodScore(),
+// the opcode trigram pre-filter, on short mutation sequences.  Both should
+// stay flat as the corpus grows.
+
+#include "nn/advisor.h"
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+int main() {
+    using Clock = std::chrono::steady_clock;
+
+    std::vector<std::vector<uint8_t>> candidates(256);
+    for (size_t k = 0; k < candidates.size(); ++k) {
+        candidates[k].resize(2 + k % 6);
+        for (size_t i = 0; i < candidates[k].size(); ++i)
+            candidates[k][i] = (uint8_t)((k * 31 + i * 17) % 0xC0);
+    }
+
+    float sink = 0.0f;
+    std::printf("%8s %14s %20s\n", "entries", "score ns", "likelihoodScore ns");
+    for (int entries : { 100, 1000, 10000 }) {
+        Advisor adv("nonexistent_dir");
+        for (int e = 0; e < entries; ++e) {
+            TelemetryEntry te;
+            te.generation = e;
+            if (e % 4 == 0) te.trapCode = "unreachable";
+            te.opcodeSequence.resize(64);
+            for (size_t i = 0; i < te.opcodeSequence.size(); ++i)
+                te.opcodeSequence[i] = (uint8_t)((e * 7 + i * 13) % 0xC0);
+            adv.test_addEntry(te);
+        }
+
+        const int rounds = 2000;
+        auto t0 = Clock::now();
+        for (int r = 0; r < rounds; ++r)
+            for (const auto& c : candidates) sink += adv.score(c);
+        double scoreNs = std::chrono::duration<double, std::nano>(Clock::now() - t0).count() /
+                         ((double)rounds * candidates.size());
+
+        auto t1 = Clock::now();
+        for (int r = 0; r < rounds; ++r)
+            for (const auto& c : candidates) sink += adv.likelihoodScore(c);
+        double llNs = std::chrono::duration<double, std::nano>(Clock::now() - t1).count() /
+                      ((double)rounds * candidates.size());
+
+        std::printf("%8d %14.1f %20.1f\n", entries, scoreNs, llNs);
+    }
+    std::printf("(checksum %g)\n", (double)sink);
+    return 0;
+}
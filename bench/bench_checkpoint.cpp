@@ -0,0 +1,57 @@
+// bench_checkpoint – Trainer save/load latency per checkpoint format.
+//
+// Saves and loads the default Trainer model repeatedly in the legacy text
+// format (saveText + the iostream parser) and in the binary format (one
+// streaming write; mmap, CRC check and a memcpy per layer on load), and
+// prints the mean time per operation and the file size of each.
+
+#include "nn/checkpoint.h"
+#include "nn/train.h"
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+template <typename F>
+double meanMicros(int rounds, F&& f) {
+    f();   // warm the page cache
+    auto t0 = Clock::now();
+    for (int r = 0; r < rounds; ++r)
+        if (!f()) return -1.0;
+    return std::chrono::duration<double, std::micro>(Clock::now() - t0).count() / rounds;
+}
+
+} // namespace
+
+int main() {
+    Trainer t;
+    Trainer loader;
+    const std::string textPath = "bench_checkpoint.txt";
+    const std::string binPath  = "bench_checkpoint.dat";
+
+    int params = 0;
+    for (int l = 0; l < t.policy().layerCount(); ++l)
+        params += (int)(t.policy().layerWeights(l).size() + t.policy().layerBiases(l).size());
+    std::printf("model: %d layers, %d parameters\n\n", t.policy().layerCount(), params);
+
+    double textSave = meanMicros(20,  [&] { return t.saveText(textPath); });
+    double textLoad = meanMicros(20,  [&] { return loader.load(textPath); });
+    double binSave  = meanMicros(500, [&] { return t.save(binPath); });
+    double binLoad  = meanMicros(500, [&] { return loader.load(binPath); });
+
+    std::printf("%-8s %12s %12s %10s\n", "format", "save us", "load us", "bytes");
+    std::printf("%-8s %12.1f %12.1f %10llu\n", "text", textSave, textLoad,
+                (unsigned long long)std::filesystem::file_size(textPath));
+    std::printf("%-8s %12.1f %12.1f %10llu\n", "binary", binSave, binLoad,
+                (unsigned long long)std::filesystem::file_size(binPath));
+    std::printf("speedup  %11.1fx %11.1fx\n", textSave / binSave, textLoad / binLoad);
+
+    std::filesystem::remove(textPath);
+    std::filesystem::remove(binPath);
+    return 0;
+}
@@ -0,0 +1,194 @@
+// bench_policy – measure Policy forward-pass throughput per kernel set.
+//
+// Builds the Trainer architecture (1024→32→64→LSTM 64→32→1) and runs the
+// sequence-mode workload: one one-hot opcode vector per forward pass with
+// the LSTM state carried across steps.  Each available SIMD kernel set is
+// timed in turn; the scalar row is the pre-vectorisation baseline.  The last
+// rows swap layer 0 for an embedding layer fed sparse one-hot inputs (the
+// path Trainer uses), on the best kernel set: first in fp32, then through
+// the int8 QuantizedPolicy the evolution loop scores kernels with, then
+// through StaticPolicy (the same network with compile-time dimensions and
+// stack-resident activations).  The final pair scores a population of
+// sequences one at a time and then in lockstep through Policy::forwardBatch.
+
+#include "nn/policy.h"
+#include "nn/quantized.h"
+#include "nn/static_policy.h"
+#include "nn/feature.h"
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+int main() {
+    using Clock = std::chrono::steady_clock;
+
+    Policy p;
+    p.addDense(kFeatSize, 32);
+    p.addDense(32, 64);
+    p.addLSTM(64, 64);
+    p.addDense(64, 32);
+    p.addDense(32, 1);
+    // non-zero dense weights so nothing collapses to a constant
+    for (int l : { 0, 1, 3, 4 }) {
+        std::vector<float> w(p.layerWeights(l).size());
+        for (size_t k = 0; k < w.size(); ++k) w[k] = 0.001f * (float)((k * 31) % 17) - 0.008f;
+        p.setLayerWeights(l, w);
+    }
+
+    // a pseudo-kernel's worth of opcodes
+    std::vector<std::vector<float>> inputs(256, std::vector<float>(kFeatSize, 0.0f));
+    for (size_t k = 0; k < inputs.size(); ++k) inputs[k][(k * 37) % 256] = 1.0f;
+
+    const simd::Isa best = simd::bestIsa();
+    double baseline = 0.0;
+    float  sink = 0.0f;
+    std::printf("%-8s %12s %12s %9s\n", "kernels", "forwards", "forwards/s", "speedup");
+    for (simd::Isa isa : { simd::Isa::SCALAR, simd::Isa::SSE2, simd::Isa::AVX2 }) {
+        if (isa > best) break;
+        simd::setIsa(isa);
+
+        p.resetState();
+        for (const auto& in : inputs) sink += p.forward(in)[0];   // warm up
+
+        const int rounds = 40;
+        auto t0 = Clock::now();
+        for (int r = 0; r < rounds; ++r) {
+            p.resetState();
+            for (const auto& in : inputs) sink += p.forward(in)[0];
+        }
+        double sec   = std::chrono::duration<double>(Clock::now() - t0).count();
+        double fwdPs = (double)rounds * inputs.size() / sec;
+        if (isa == simd::Isa::SCALAR) baseline = fwdPs;
+        std::printf("%-8s %12zu %12.0f %8.2fx\n", simd::isaName(isa),
+                    (size_t)rounds * inputs.size(), fwdPs, fwdPs / baseline);
+    }
+
+    // sparse path: embedding first layer, one-hot SparseVector inputs
+    Policy e;
+    e.addEmbedding(kFeatSize, 32);
+    e.addDense(32, 64);
+    e.addLSTM(64, 64);
+    e.addDense(64, 32);
+    e.addDense(32, 1);
+    for (int l = 0; l < p.layerCount(); ++l) {
+        if (l == 2) continue;
+        e.setLayerWeights(l, p.layerWeights(l));   // layout differs; only timing matters
+    }
+    std::vector<SparseVector> sparse(inputs.size());
+    for (size_t k = 0; k < inputs.size(); ++k) sparse[k].setOneHot((int)((k * 37) % 256));
+
+    simd::setIsa(best);
+    e.resetState();
+    for (const auto& in : sparse) sink += e.forward(in)[0];
+    const int rounds = 400;
+    auto t0 = Clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        e.resetState();
+        for (const auto& in : sparse) sink += e.forward(in)[0];
+    }
+    double sec   = std::chrono::duration<double>(Clock::now() - t0).count();
+    double fwdPs = (double)rounds * sparse.size() / sec;
+    std::printf("%-8s %12zu %12.0f %8.2fx  (embedding + sparse input)\n", simd::isaName(best),
+                (size_t)rounds * sparse.size(), fwdPs, fwdPs / baseline);
+
+    // int8 path: the same embedding model, quantized
+    {
+        QuantizedPolicy q(e);
+        size_t fp32Bytes = 0;
+        for (int l = 0; l < e.layerCount(); ++l)
+            fp32Bytes += (e.layerWeights(l).size() + e.layerBiases(l).size()) * sizeof(float);
+        QuantizedPolicy::State st;
+        q.prepare(st);
+        for (const auto& in : sparse) sink += q.forward(in, st)[0];
+        auto t1 = Clock::now();
+        for (int r = 0; r < rounds; ++r) {
+            q.resetState(st);
+            for (const auto& in : sparse) sink += q.forward(in, st)[0];
+        }
+        double qsec = std::chrono::duration<double>(Clock::now() - t1).count();
+        double qPs  = (double)rounds * sparse.size() / qsec;
+        std::printf("%-8s %12zu %12.0f %8.2fx  (int8 quantized, %zu KiB vs %zu KiB)\n",
+                    simd::isaName(best), (size_t)rounds * sparse.size(), qPs, qPs / baseline,
+                    q.bytes() / 1024, fp32Bytes / 1024);
+    }
+
+    // compile-time specialised: the same embedding model as a StaticPolicy
+    {
+        using Net = StaticPolicy<static_layers::Embedding<kFeatSize, 32>,
+                                 static_layers::Dense<32, 64>,
+                                 static_layers::Lstm<64, 64>,
+                                 static_layers::Dense<64, 32>,
+                                 static_layers::Dense<32, 1>>;
+        auto net = std::make_unique<Net>();
+        net->load(e);
+        // the dynamic reference is the allocation-free Workspace forward
+        Policy::Workspace ws;
+        e.prepare(ws);
+        auto t0 = Clock::now();
+        for (int r = 0; r < rounds; ++r) {
+            e.resetState();
+            for (const auto& in : sparse) sink += e.forward(in, ws)[0];
+        }
+        double wsec = std::chrono::duration<double>(Clock::now() - t0).count();
+        for (const auto& in : sparse) sink += net->forward(in)[0];
+        auto t1 = Clock::now();
+        for (int r = 0; r < rounds; ++r) {
+            net->resetState();
+            for (const auto& in : sparse) sink += net->forward(in)[0];
+        }
+        double ssec = std::chrono::duration<double>(Clock::now() - t1).count();
+        double sPs  = (double)rounds * sparse.size() / ssec;
+        std::printf("%-8s %12zu %12.0f %8.2fx  (StaticPolicy, %.2fx Policy with a Workspace)\n",
+                    simd::isaName(best), (size_t)rounds * sparse.size(), sPs, sPs / baseline,
+                    sPs * wsec / ((double)rounds * sparse.size()));
+    }
+
+    // population scoring: 64 sequences of mixed length, one by one vs batched
+    {
+        std::vector<std::vector<uint8_t>> pop(64);
+        for (size_t s = 0; s < pop.size(); ++s) {
+            pop[s].resize(128 + (s * 29) % 128);
+            for (size_t k = 0; k < pop[s].size(); ++k) pop[s][k] = (uint8_t)((s * 13 + k * 37) % 256);
+        }
+        size_t steps = 0;
+        for (const auto& seq : pop) steps += seq.size();
+
+        const int popRounds = 10;
+        Policy::Workspace ws;
+        e.prepare(ws);
+        SparseVector x;
+        auto t1 = Clock::now();
+        for (int r = 0; r < popRounds; ++r) {
+            for (const auto& seq : pop) {
+                e.resetState();
+                for (uint8_t op : seq) {
+                    x.setOneHot(op);
+                    sink += e.forward(x, ws)[0];
+                }
+            }
+        }
+        double seqSec = std::chrono::duration<double>(Clock::now() - t1).count();
+
+        Policy::BatchState st;
+        e.prepare(st, (int)pop.size());
+        std::vector<std::vector<float>> outs;
+        auto t2 = Clock::now();
+        for (int r = 0; r < popRounds; ++r) {
+            e.forwardBatch(pop, st, outs);
+            sink += outs[0][0];
+        }
+        double batchSec = std::chrono::duration<double>(Clock::now() - t2).count();
+
+        double seqPs = (double)popRounds * steps / seqSec;
+        double batPs = (double)popRounds * steps / batchSec;
+        std::printf("%-8s %12zu %12.0f %8.2fx  (%zu sequences, one at a time)\n",
+                    simd::isaName(best), popRounds * steps, seqPs, seqPs / baseline, pop.size());
+        std::printf("%-8s %12zu %12.0f %8.2fx  (%zu sequences, forwardBatch)\n",
+                    simd::isaName(best), popRounds * steps, batPs, batPs / baseline, pop.size());
+    }
+
+    std::printf("(checksum %g)\n", (double)sink);
+    return 0;
+}
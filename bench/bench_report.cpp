@@ -0,0 +1,81 @@
+// bench_report – measure telemetry report rendering throughput.
+//
+// Builds synthetic kernels whose code section is roughly 1 KB, 8 KB and
+// 32 KB, then renders FULL reports into a reused ReportWriter buffer and
+// streams them to /dev/null.  Prints kernel MB/s (input) and report MB/s
+// (output) for each size.
+
+#include "exporter.h"
+#include "base64.h"
+#include "wasm/parser.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+
+// Minimal module: header + a code section holding one function body filled
+// with `i32.const N; drop` pairs.  Only the code section matters to the
+// report, so no type/function sections are emitted.
+static std::vector<uint8_t> makeKernel(size_t codeBytes) {
+    std::vector<uint8_t> body;
+    body.push_back(0x00); // no locals
+    while (body.size() + 4 <= codeBytes) {
+        body.push_back(0x41);
+        body.push_back((uint8_t)(body.size() & 0x3F));
+        body.push_back(0x1A);
+    }
+    body.push_back(0x0B);
+
+    std::vector<uint8_t> section;
+    section.push_back(0x01); // one function
+    auto bodyLen = encodeLEB128((uint32_t)body.size());
+    section.insert(section.end(), bodyLen.data, bodyLen.data + bodyLen.length);
+    section.insert(section.end(), body.begin(), body.end());
+
+    std::vector<uint8_t> mod = { 0x00, 0x61, 0x73, 0x6D, 0x01, 0x00, 0x00, 0x00, 0x0A };
+    auto secLen = encodeLEB128((uint32_t)section.size());
+    mod.insert(mod.end(), secLen.data, secLen.data + secLen.length);
+    mod.insert(mod.end(), section.begin(), section.end());
+    return mod;
+}
+
+int main() {
+    using Clock = std::chrono::steady_clock;
+    int devnull = ::open("/dev/null", O_WRONLY);
+    ReportWriter writer;
+
+    std::printf("%-8s %10s %12s %12s %12s\n",
+                "kernel", "reports", "us/report", "kernel MB/s", "report MB/s");
+    for (size_t kb : {1, 8, 32}) {
+        auto bytes = makeKernel(kb * 1024);
+        std::string kernel = base64_encode(bytes);
+        auto instructions  = extractCodeSection(bytes);
+        std::vector<HistoryEntry> history;
+        for (int g = 0; g < 50; ++g)
+            history.push_back({ g, "2026-01-02T03:04:05.678Z", (int)bytes.size(),
+                                "EVOLVE", "Inserted: [i32.const 5, drop] at 3", true });
+        ExportData d;
+        d.generation    = 123;
+        d.currentKernel = kernel;
+        d.instructions  = instructions;
+        d.history       = history;
+
+        // warm up so buffers reach their steady-state capacity
+        writer.writeTo(devnull, d, TelemetryLevel::FULL);
+        size_t reportBytes = writer.build(d, TelemetryLevel::FULL).size();
+
+        const int iters = kb >= 32 ? 200 : 1000;
+        auto t0 = Clock::now();
+        for (int i = 0; i < iters; ++i)
+            writer.writeTo(devnull, d, TelemetryLevel::FULL);
+        double sec = std::chrono::duration<double>(Clock::now() - t0).count();
+
+        double inMB  = (double)bytes.size() * iters / (1024.0 * 1024.0);
+        double outMB = (double)reportBytes * iters / (1024.0 * 1024.0);
+        std::printf("%5zu KB %10d %12.2f %12.1f %12.1f\n",
+                    kb, iters, sec * 1e6 / iters, inMB / sec, outMB / sec);
+    }
+    if (devnull >= 0) ::close(devnull);
+    return 0;
+}
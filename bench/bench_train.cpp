@@ -0,0 +1,238 @@
+// bench_train – training loss versus wall-clock time.
+//
+// Trains on a synthetic corpus of opcode sequences whose target is the
+// fraction of arithmetic opcodes they contain, so the answer depends on the
+// whole sequence and has to be carried by the LSTM.  Two trainers get the
+// same time budget:
+//
+//   legacy   – the previous rule: per opcode, w -= lr * err * input for every
+//              non-LSTM layer (no chain rule, LSTM never trained), two
+//              sequences per step as observe() did with one replay sample
+//   backprop – Trainer::trainBatch: full gradients with truncated BPTT,
+//              Trainer::kBatchSize sequences per Adam step
+//
+// Every interval both models are evaluated (per-step MSE over the whole
+// corpus, the quantity both minimise) and printed side by side.
+//
+// A second table reports data-parallel throughput: sequences per second for
+// Trainer::kCorpusBatch-sized batches at 1, 2, 4, ... threads.
+//
+// A third times the replay bookkeeping of one observe() (a push plus
+// kBatchSize-1 draws and priority updates) against capacity, for the
+// previous vector of TelemetryEntry with erase(begin()) eviction and for
+// ReplayMemory.
+
+#include "nn/train.h"
+#include "nn/feature.h"
+#include "nn/replay.h"
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Corpus {
+    std::vector<std::vector<uint8_t>> seqs;
+    std::vector<float> targets;
+};
+
+Corpus makeCorpus(int count, uint32_t seed) {
+    // local.get/set, i32.const, and the arithmetic ops that define the target
+    const uint8_t plain[] = { 0x20, 0x21, 0x41, 0x0b };
+    const uint8_t arith[] = { 0x6a, 0x6b, 0x6c, 0x71 };
+    std::mt19937 rng(seed);
+    Corpus c;
+    for (int k = 0; k < count; ++k) {
+        int len = 16 + (int)(rng() % 48);
+        float pArith = (float)(rng() % 1000) / 1000.0f;
+        std::vector<uint8_t> s;
+        int hits = 0;
+        for (int i = 0; i < len; ++i) {
+            bool a = (float)(rng() % 1000) / 1000.0f < pArith;
+            s.push_back(a ? arith[rng() % 4] : plain[rng() % 4]);
+            hits += a;
+        }
+        c.seqs.push_back(std::move(s));
+        c.targets.push_back((float)hits / (float)len);
+    }
+    return c;
+}
+
+double evalLoss(Policy p, const Corpus& c) {
+    double loss = 0.0;
+    size_t steps = 0;
+    SparseVector x;
+    for (size_t k = 0; k < c.seqs.size(); ++k) {
+        p.resetState();
+        for (uint8_t op : c.seqs[k]) {
+            x.setOneHot(op);
+            float d = p.forward(x)[0] - c.targets[k];
+            loss += d * d;
+            ++steps;
+        }
+    }
+    return loss / (double)steps;
+}
+
+// the update Trainer used before backpropagation
+struct LegacyTrainer {
+    Policy p;
+    Policy::Workspace ws;
+    SparseVector x;
+
+    LegacyTrainer() {
+        p.addEmbedding(kFeatSize, 32);
+        p.addDense(32, 64);
+        p.addLSTM(64, 64);
+        p.addDense(64, 32);
+        p.addDense(32, 1);
+        p.prepare(ws);
+    }
+
+    void train(const std::vector<uint8_t>& seq, float target) {
+        const float lr = 0.005f;
+        p.resetState();
+        for (uint8_t op : seq) {
+            x.setOneHot(op);
+            const auto& out = p.forward(x, ws);
+            float diff = out[0] - target;
+            for (int l = 0; l < p.layerCount(); ++l) {
+                const auto type = p.layerType(l);
+                if (type == Policy::LayerType::LSTM) continue;
+                const int outl = p.layerOutSize(l);
+                if (type == Policy::LayerType::EMBEDDING) {
+                    float* row = p.embeddingRow(l, op);
+                    for (int o = 0; o < outl; ++o) row[o] -= lr * diff;
+                    continue;
+                }
+                const int inl = p.layerInSize(l);
+                ParamView w = p.layerWeightsMut(l);
+                for (int o = 0; o < outl; ++o)
+                    simd::axpy(-lr * diff, ws.acts[l].data(), w.data + (size_t)o * inl, inl);
+            }
+        }
+    }
+};
+
+} // namespace
+
+int main() {
+    const Corpus corpus = makeCorpus(128, 42);
+    const double budget   = 6.0;    // seconds per trainer
+    const double interval = 0.5;
+
+    std::vector<double> legacyLoss, backpropLoss;
+    std::mt19937 pick(7);
+
+    {
+        LegacyTrainer t;
+        legacyLoss.push_back(evalLoss(t.p, corpus));
+        double spent = 0.0;
+        for (double next = interval; next <= budget + 1e-9; next += interval) {
+            auto t0 = Clock::now();
+            while (spent + std::chrono::duration<double>(Clock::now() - t0).count() < next) {
+                for (int k = 0; k < 2; ++k) {
+                    size_t i = pick() % corpus.seqs.size();
+                    t.train(corpus.seqs[i], corpus.targets[i]);
+                }
+            }
+            spent += std::chrono::duration<double>(Clock::now() - t0).count();
+            legacyLoss.push_back(evalLoss(t.p, corpus));
+        }
+    }
+    {
+        Trainer t;
+        backpropLoss.push_back(evalLoss(t.policy(), corpus));
+        std::vector<std::vector<uint8_t>> seqs(Trainer::kBatchSize);
+        std::vector<float> targets(Trainer::kBatchSize);
+        double spent = 0.0;
+        for (double next = interval; next <= budget + 1e-9; next += interval) {
+            auto t0 = Clock::now();
+            while (spent + std::chrono::duration<double>(Clock::now() - t0).count() < next) {
+                for (int k = 0; k < Trainer::kBatchSize; ++k) {
+                    size_t i = pick() % corpus.seqs.size();
+                    seqs[k]    = corpus.seqs[i];
+                    targets[k] = corpus.targets[i];
+                }
+                t.trainBatch(seqs, targets);
+            }
+            spent += std::chrono::duration<double>(Clock::now() - t0).count();
+            backpropLoss.push_back(evalLoss(t.policy(), corpus));
+        }
+    }
+
+    std::printf("%8s %14s %14s\n", "seconds", "legacy MSE", "backprop MSE");
+    for (size_t k = 0; k < legacyLoss.size(); ++k)
+        std::printf("%8.1f %14.5f %14.5f\n", k * interval, legacyLoss[k], backpropLoss[k]);
+
+    // ── data-parallel scaling ────────────────────────────────────────────────
+    std::vector<std::vector<uint8_t>> seqs(Trainer::kCorpusBatch);
+    std::vector<float> targets(Trainer::kCorpusBatch);
+    for (size_t k = 0; k < seqs.size(); ++k) {
+        seqs[k]    = corpus.seqs[k % corpus.seqs.size()];
+        targets[k] = corpus.targets[k % corpus.seqs.size()];
+    }
+    const int hw = (int)std::max(1u, std::thread::hardware_concurrency());
+    double base = 0.0;
+    std::printf("\n%8s %12s %9s\n", "threads", "seqs/s", "speedup");
+    std::vector<int> counts;
+    for (int n = 1; n < hw; n *= 2) counts.push_back(n);
+    counts.push_back(hw);
+    for (int threads : counts) {
+        Trainer t;
+        t.setThreads(threads);
+        t.trainBatch(seqs, targets);   // warm up
+        const int rounds = 20;
+        auto t0 = Clock::now();
+        for (int r = 0; r < rounds; ++r) t.trainBatch(seqs, targets);
+        double sec  = std::chrono::duration<double>(Clock::now() - t0).count();
+        double rate = (double)rounds * seqs.size() / sec;
+        if (threads == 1) base = rate;
+        std::printf("%8d %12.0f %8.2fx\n", threads, rate, rate / base);
+    }
+
+    // ── replay bookkeeping per observe() ─────────────────────────────────────
+    TelemetryEntry sample;
+    sample.kernelBase64 = std::string(512, 'A');   // a typical kernel's text
+    auto features = std::make_shared<KernelFeatures>();
+    std::printf("\n%9s %14s %14s\n", "capacity", "vector ns", "sum-tree ns");
+    for (size_t cap : { (size_t)256, (size_t)4096, (size_t)100000 }) {
+        const int ops = 20000;
+        std::mt19937 rng(1);
+
+        std::vector<TelemetryEntry> buf;
+        for (size_t k = 0; k < cap; ++k) buf.push_back(sample);
+        float sink = 0.0f;
+        auto t0 = Clock::now();
+        for (int i = 0; i < ops; ++i) {
+            for (int k = 1; k < Trainer::kBatchSize; ++k) {
+                std::uniform_int_distribution<int> pick(0, (int)buf.size() - 1);
+                sink += (float)buf[pick(rng)].generation;
+            }
+            buf.push_back(sample);
+            buf.erase(buf.begin());
+        }
+        double vecNs = std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / ops;
+
+        ReplayMemory mem(cap);
+        for (size_t k = 0; k < cap; ++k) mem.push({ features, (int)k }, 0.5f);
+        t0 = Clock::now();
+        for (int i = 0; i < ops; ++i) {
+            for (int k = 1; k < Trainer::kBatchSize; ++k) {
+                size_t slot = mem.sample(rng);
+                sink += (float)mem.at(slot).generation;
+                mem.update(slot, (float)(i % 10) * 0.1f);
+            }
+            mem.push({ features, i }, 0.5f);
+        }
+        double treeNs = std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / ops;
+        std::printf("%9zu %14.0f %14.0f%s\n", cap, vecNs, treeNs, sink < 0.0f ? " " : "");
+    }
+    return 0;
+}
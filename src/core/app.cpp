@@ -3,6 +3,7 @@
 #include "base64.h"
 #include "util.h"
 #include "exporter.h"
+#include "trace.h"
 #include "nn/feature.h"
 #include "wasm/evolution.h"
 #include "wasm/parser.h"
@@ -15,11 +16,11 @@
 #include <stdexcept>
 #include <filesystem>
 #include <functional>
+#include <thread>
 
 // ── Training-phase constants ─────────────────────────────────────────────────
 // Shared by both the constructor (to compute m_trainingTotal) and tickTraining.
 static constexpr int kTrainMinAnimSteps = 30;
-static constexpr int kTrainEpochs       = 5;
 #include <atomic>
 #include <sys/types.h>
 #include <sys/wait.h>
@@ -29,6 +30,43 @@ static constexpr int kTrainEpochs       = 5;
 #include <sys/file.h>
 #include <unistd.h>
 
+// ── Metrics ──────────────────────────────────────────────────────────────────
+// Handles into the process-wide registry, resolved once on first use.
+namespace {
+struct AppMetrics {
+    Histogram& boot     = metrics().histogram("wqb_boot_seconds", "Module parse and instantiation time");
+    Histogram& exec     = metrics().histogram("wqb_exec_seconds", "Kernel run() execution time");
+    Histogram& validate = metrics().histogram("wqb_validate_seconds", "Quine output verification time");
+    Histogram& evolve   = metrics().histogram("wqb_evolve_seconds", "Mutation time including advisor rerolls");
+    Histogram& train    = metrics().histogram("wqb_train_step_seconds", "Trainer observe() time per entry");
+    Histogram& exportT  = metrics().histogram("wqb_export_seconds", "Telemetry export time per generation");
+    Histogram& gen      = metrics().histogram("wqb_generation_seconds", "Wall time per successful generation");
+    Counter&   gens     = metrics().counter("wqb_generations_total", "Successful generations");
+    Counter&   failures = metrics().counter("wqb_boot_failures_total", "Boot/verification failures");
+    Counter&   mutated  = metrics().counter("wqb_mutations_applied_total", "Mutations applied to a kernel");
+    Counter&   rejected = metrics().counter("wqb_evolution_rejected_total", "Evolution attempts rejected");
+    Counter&   exports  = metrics().counter("wqb_exports_total", "Telemetry reports written");
+    Gauge&     genNow   = metrics().gauge("wqb_generation", "Current generation");
+    Gauge&     kbytes   = metrics().gauge("wqb_kernel_bytes", "Current kernel size in bytes");
+    Gauge&     advisor  = metrics().gauge("wqb_advisor_entries", "Telemetry entries held by the advisor");
+    Gauge&     loss     = metrics().gauge("wqb_trainer_loss", "Most recent trainer loss");
+    Gauge&     blacklist = metrics().gauge("wqb_blacklist_entries", "Heuristic blacklist size");
+    Counter&   trainDropped = metrics().counter("wqb_train_dropped_total", "Telemetry entries dropped by a full --async-train queue");
+    Gauge&     trainBacklog = metrics().gauge("wqb_train_backlog", "Entries waiting in the --async-train queue");
+    Counter&   ngramRerolls = metrics().counter("wqb_ngram_rerolls_total", "Genomes redrawn by the advisor's opcode language model");
+};
+
+// likelihoodScore() below which a genome is redrawn, and how often per
+// evolveBinary call
+constexpr float kNgramRejectScore = 0.2f;
+constexpr int   kNgramRerolls     = 4;
+
+AppMetrics& appMetrics() {
+    static AppMetrics m;
+    return m;
+}
+}
+
 // Global pointer used by the signal handler to notify the running App
 static App* g_appInstance = nullptr;
 // also keep an atomic flag for simple checks
@@ -52,8 +90,17 @@ App::App()
 }
 
 App::~App() {
+    // close the slice for the state we are still in
+    if (trace::enabled())
+        trace::complete(stateStr(m_fsm.current()), "fsm", m_stateEnteredNs,
+                        trace::nowNs() - m_stateEnteredNs, trace::kFsmTrack);
     // persist blacklist on shutdown
     saveBlacklist();
+    // final --save-model checkpoint: stop the trainer thread so the
+    // snapshot holds its last weights, then wait for the write
+    m_bgTrainer.stop();
+    if (!m_opts.saveModelPath.empty()) queueCheckpoint(m_opts.saveModelPath);
+    m_checkpointer.stop();
     // clear global pointer so signal handler won't dereference it
     if (g_appInstance == this) g_appInstance = nullptr;
 }
@@ -64,6 +111,13 @@ App::App(const CliOptions& opts, std::function<uint64_t()> nowFn)
     // register global pointer immediately so signals can be handled
     g_appInstance = this;
 
+    // FSM states show up as slices on their own trace track
+    m_stateEnteredNs = trace::nowNs();
+    trace::setThreadName("BootFsm", trace::kFsmTrack);
+    m_fsm.setTransitionCallback([this](SystemState from, SystemState to) {
+        onStateTransition(from, to);
+    });
+
     // choose time source
     if (nowFn) {
         m_nowFn = std::move(nowFn);
@@ -90,7 +144,7 @@ App::App(const CliOptions& opts, std::function<uint64_t()> nowFn)
     if (!m_opts.telemetryDir.empty()) {
         std::string clean = sanitizeRelativePath(m_opts.telemetryDir);
         if (clean.empty()) {
-            m_logger.log("WARNING: invalid telemetryDir '" + m_opts.telemetryDir + "', falling back to default", "warning");
+            m_logger.log("WARNING: invalid telemetryDir '" + m_opts.telemetryDir + "', falling back to default", LogType::WARNING);
             m_opts.telemetryDir.clear();
         } else {
             m_opts.telemetryDir = clean;
@@ -122,26 +176,40 @@ App::App(const CliOptions& opts, std::function<uint64_t()> nowFn)
     m_logsDir = logsDir;
     m_seqBase = seqBase;
 
-    // create advisor using the telemetry base (without runId appended)
-    m_advisor = Advisor(seqBase.string());
+    // create advisor using the telemetry base (without runId appended).
+    // Our own run directory is skipped: entries from this session are fed
+    // in directly by recordTelemetry().
+    m_advisor = Advisor(seqBase.string(), m_runId);
     // if heuristic blacklist is active we expect to store entries; reserve
     // some initial capacity to avoid rehash churn.
     if (m_opts.heuristic != HeuristicMode::NONE) {
         m_blacklist.reserve(512);
     }
+    {
+        CheckpointPolicy cp;
+        cp.everyGenerations = m_opts.checkpointEvery;
+        m_checkpointer.setPolicy(cp);
+    }
+    {
+        TrainingScheduler::Config sc;
+        sc.interval          = kAutoTrainGen;
+        sc.convergedInterval = 2 * kAutoTrainGen;
+        m_scheduler.setConfig(sc);
+    }
+
     // load model if requested, or auto-load the most recent checkpoint
     if (!m_opts.loadModelPath.empty()) {
         if (!m_trainer.load(m_opts.loadModelPath)) {
-            m_logger.log("WARNING: failed to load model from " + m_opts.loadModelPath, "warning");
+            m_logger.log("WARNING: failed to load model from " + m_opts.loadModelPath, LogType::WARNING);
         } else {
-            m_logger.log("Loaded model from " + m_opts.loadModelPath, "info");
+            m_logger.log("Loaded model from " + m_opts.loadModelPath, LogType::INFO);
         }
     } else {
         // look for an auto-saved checkpoint from a previous run
         auto cpPath = telemetryRoot() / "model_checkpoint.dat";
         if (fs::exists(cpPath)) {
             if (m_trainer.load(cpPath.string())) {
-                m_logger.log("Auto-loaded model checkpoint from " + cpPath.string(), "info");
+                m_logger.log("Auto-loaded model checkpoint from " + cpPath.string(), LogType::INFO);
             }
         }
     }
@@ -153,8 +221,13 @@ App::App(const CliOptions& opts, std::function<uint64_t()> nowFn)
     // In headless mode (no GUI) there is no training dashboard: complete
     // training synchronously and allow evolution to begin immediately.
     if (!m_opts.useGui) {
-        for (const auto& e : m_advisor.entries())
-            m_trainer.observe(e);
+        // the corpus pass is the only training whose batches are large
+        // enough to shard, so the worker pool lives only for its duration
+        int threads = m_opts.trainThreads;
+        if (threads <= 0) threads = (int)std::max(1u, std::thread::hardware_concurrency());
+        m_trainer.setThreads(threads);
+        m_trainer.trainCorpus(m_advisor.entries());
+        m_trainer.setThreads(1);
         m_trainingPhase    = TrainingPhase::COMPLETE;
         m_evolutionEnabled = true;
     }
@@ -181,8 +254,25 @@ App::App(const CliOptions& opts, std::function<uint64_t()> nowFn)
     // load any persisted heuristic blacklist from previous sessions
     loadBlacklist();
 
-    // Open buffered log file (flushes every ~1 s; always flushed on exit/signal)
-    m_logger.init((logsDir / ("bootloader_" + nowFileStamp() + ".log")).string());
+    // Open the log: either the crash-persistent mmap ring or a buffered text
+    // file (flushed every ~1 s; always flushed on exit/signal)
+    std::string logStem = "bootloader_" + nowFileStamp();
+    bool mapped = m_opts.logRing &&
+                  m_logger.initMapped((logsDir / (logStem + ".logring")).string());
+    if (!mapped) m_logger.init((logsDir / (logStem + ".log")).string());
+    if (m_opts.logRing && !mapped)
+        m_logger.log("LOG: could not create mmap log ring, using text log", LogType::WARNING);
+
+    // optional live event stream for external monitors
+    if (!m_opts.telemetryStream.empty()) {
+        if (m_publisher.open(m_opts.telemetryStream)) {
+            m_logger.log(std::string("STREAM: publishing events via ") +
+                         (m_publisher.transport() == StreamTransport::SHM ? "shared memory" : "unix socket") +
+                         " (" + m_opts.telemetryStream + ")", LogType::INFO);
+        } else {
+            m_logger.log("STREAM: could not open '" + m_opts.telemetryStream + "'", LogType::WARNING);
+        }
+    }
 
     // Parse initial kernel and populate the instruction list; this also
     // fills the byte cache used by `kernelBytes()`.
@@ -201,15 +291,16 @@ void App::updateKernelData() {
     m_instructions = extractCodeSection(m_currentKernelBytes);
 }
 
-// Recalculate the training/animation step counts from current advisor
-// entries and reset the training phase to LOADING.  This is invoked at
-// startup and also whenever we reload telemetry midway through a run.
+// Plan a training cycle over the current advisor entries and reset the
+// training phase to LOADING.  This is invoked at startup and also whenever
+// the scheduler starts a cycle midway through a run.
 void App::prepareTrainingSteps() {
     int nEntries = (int)m_advisor.size();
+    TrainingScheduler::Plan plan = m_scheduler.begin(m_generation, m_advisor.size());
     int loadSteps  = std::max(kTrainMinAnimSteps, nEntries);
-    int trainSteps = std::max(kTrainMinAnimSteps, nEntries * kTrainEpochs);
+    m_trainingWindow  = plan.window;
     m_trainingLoadEnd = loadSteps;
-    m_trainingTotal   = loadSteps + trainSteps;
+    m_trainingTotal   = loadSteps + plan.steps;
     m_trainingStep    = 0;
     m_trainingPhase   = TrainingPhase::LOADING;
 }
@@ -220,8 +311,24 @@ size_t App::kernelBytes() const {
 
 // ─── FSM helpers ─────────────────────────────────────────────────────────────
 
+void App::onStateTransition(SystemState from, SystemState /*to*/) {
+    uint64_t t = trace::nowNs();
+    if (trace::enabled())
+        trace::complete(stateStr(from), "fsm", m_stateEnteredNs,
+                        t - m_stateEnteredNs, trace::kFsmTrack);
+    m_stateEnteredNs = t;
+}
+
 void App::transitionTo(SystemState s) {
-    m_fsm.transition(s);
+    SystemState from = m_fsm.current();
+    if (m_fsm.transition(s) && m_publisher.isOpen()) {
+        GenerationEvent ev;
+        ev.kind       = (uint32_t)StreamEventKind::STATE;
+        ev.generation = m_generation;
+        ev.fromState  = (uint8_t)from;
+        ev.toState    = (uint8_t)s;
+        m_publisher.publish(ev);
+    }
 }
 
 
@@ -242,11 +349,17 @@ bool App::update() {
     // `m_shouldExit` will be set).  the check is made before the state
     // machine so we abort as soon as the budget is exceeded.
     if (m_opts.maxRunMs > 0 && m_uptimeMs >= m_opts.maxRunMs) {
-        m_logger.log("Max-run-ms limit reached (" + std::to_string(m_opts.maxRunMs) + " ms)", "info");
+        m_logger.log("Max-run-ms limit reached (" + std::to_string(m_opts.maxRunMs) + " ms)", LogType::INFO);
         m_shouldExit = true;
         return false;
     }
 
+    if (m_opts.metricsIntervalMs > 0 &&
+        t - m_lastMetricsWrite >= (uint64_t)m_opts.metricsIntervalMs) {
+        m_lastMetricsWrite = t;
+        writeMetrics();
+    }
+
     if (m_memGrowing && t >= m_memGrowFlashUntil)
         m_memGrowing = false;
 
@@ -256,6 +369,8 @@ bool App::update() {
     // In GUI mode the FSM is gated behind m_evolutionEnabled (set when the
     // user clicks "Start Evolution").  In headless mode both flags are set
     // in the constructor so this path is a no-op.
+    // each tick's wall time counts toward training or evolution
+    const auto tickStart = std::chrono::steady_clock::now();
     if (!m_evolutionEnabled) {
         tickTraining();
         // only re-enable evolution after training is complete AND the
@@ -265,9 +380,18 @@ bool App::update() {
         if (m_trainingPhase == TrainingPhase::COMPLETE && m_modelSaved) {
             m_evolutionEnabled = true;
         }
+        m_scheduler.account(true, (double)nsSince(tickStart) * 1e-9);
         return true;
     }
 
+    // --async-train: from here on the trainer runs on its own thread and
+    // evolution only feeds it
+    if (m_opts.asyncTrain && !m_bgTrainer.running()) {
+        m_bgTrainer.start();
+        m_logger.log("TRAIN: background trainer started; evolution no longer pauses for training",
+                     LogType::TRAIN);
+    }
+
     switch (m_fsm.current()) {
         case SystemState::IDLE:             startBoot();      break;
         case SystemState::BOOTING:          tickBooting();    break;
@@ -278,6 +402,7 @@ bool App::update() {
         case SystemState::SYSTEM_HALT:                        break;
     }
 
+    m_scheduler.account(false, (double)nsSince(tickStart) * 1e-9);
     return true;
 }
 
@@ -329,11 +454,8 @@ void App::tickTraining() {
                 // string only when logging.  assign to `auto` so we keep the
                 // path type and can call `.string()` later.
                 auto path = telemetryRoot() / "model_checkpoint.dat";
-                if (m_trainer.save(path.string())) {
-                    m_logger.log("Saved model checkpoint to " + path.string(), "info");
-                } else {
-                    m_logger.log("WARNING: failed to save model checkpoint", "warning");
-                }
+                queueCheckpoint(path.string());
+                m_logger.log("Saving model checkpoint to " + path.string(), LogType::INFO);
                 m_modelSaved = true;
                 m_savingModel = false;
             }
@@ -351,15 +473,29 @@ void App::tickTraining() {
             m_trainingPhase = TrainingPhase::TRAINING;
         }
     } else if (m_trainingPhase == TrainingPhase::TRAINING) {
-        // Observe one entry per step (cycling through entries)
+        // trainIdx is 1-based within the TRAINING phase
+        int trainIdx = m_trainingStep - m_trainingLoadEnd;
+        // Observe one entry per step, cycling through the newest
+        // m_trainingWindow entries newest first
         if (!entries.empty()) {
-            // trainIdx is 1-based within the TRAINING phase
-            int trainIdx = m_trainingStep - m_trainingLoadEnd;
-            int idx = (trainIdx - 1) % nEntries;
-            m_trainer.observe(entries[idx]);
+            int window = std::max(1, std::min(m_trainingWindow, nEntries));
+            int idx = nEntries - 1 - (trainIdx - 1) % window;
+            {
+                ScopedTimer timer(appMetrics().train);
+                m_trainer.observe(entries[idx]);
+            }
+            if (m_scheduler.step(m_trainer.avgLoss())) {
+                m_logger.log("TRAIN: loss plateaued after " + std::to_string(trainIdx) + " of " +
+                             std::to_string(m_trainingTotal - m_trainingLoadEnd) +
+                             " steps, ending the cycle early", LogType::TRAIN);
+                m_trainingPhase = TrainingPhase::COMPLETE;
+                m_scheduler.finish(trainIdx);
+                return;
+            }
         }
         if (m_trainingStep >= m_trainingTotal) {
             m_trainingPhase = TrainingPhase::COMPLETE;
+            m_scheduler.finish(trainIdx);
         }
     }
 }
@@ -368,7 +504,7 @@ void App::tickTraining() {
 
 void App::startBoot() {
     transitionTo(SystemState::BOOTING);
-    m_logger.log("--- BOOT SEQUENCE INITIATED ---", "system");
+    m_logger.log("--- BOOT SEQUENCE INITIATED ---", LogType::SYSTEM);
     m_instrIndex     = 0;
     m_callExecuted   = false;
     m_quineSuccess   = false;
@@ -385,7 +521,7 @@ void App::tickBooting() {
         transitionTo(SystemState::LOADING_KERNEL);
         m_loadingProgress = 0;
         int kbytes = static_cast<int>(kernelBytes());
-        m_logger.log("Loading Kernel Image: " + std::to_string(kbytes) + " bytes", "info");
+        m_logger.log("Loading Kernel Image: " + std::to_string(kbytes) + " bytes", LogType::INFO);
     }
 }
 
@@ -403,8 +539,9 @@ void App::tickLoading() {
     m_focusAddr = 0;
     m_focusLen  = 0;
 
-    m_logger.log("Instantiating Module...", "info");
+    m_logger.log("Instantiating Module...", LogType::INFO);
     try {
+        ScopedTimer timer(appMetrics().boot);
         m_kernel.bootDynamic(
             m_currentKernel,
             [this](uint32_t ptr, uint32_t len, const uint8_t* mem, uint32_t msz) {
@@ -444,8 +581,9 @@ void App::tickExecuting() {
 
     if (m_instructions.empty()) {
         if (!m_callExecuted) {
-            m_logger.log("EXEC: Blind Run (Parser unavailable)", "warning");
+            m_logger.log("EXEC: Blind Run (Parser unavailable)", LogType::WARNING);
             try {
+                ScopedTimer timer(appMetrics().exec);
                 m_kernel.runDynamic(m_currentKernel);
             } catch (const std::exception& e) {
                 handleBootFailure(e.what());
@@ -457,8 +595,9 @@ void App::tickExecuting() {
 
     if (m_instrIndex >= static_cast<int>(m_instructions.size())) {
         if (!m_callExecuted) {
-            m_logger.log("EXEC: end of instruction stream, executing kernel", "info");
+            m_logger.log("EXEC: end of instruction stream, executing kernel", LogType::INFO);
             try {
+                ScopedTimer timer(appMetrics().exec);
                 m_kernel.runDynamic(m_currentKernel);
             } catch (const std::exception& e) {
                 handleBootFailure(e.what());
@@ -513,12 +652,12 @@ bool App::runWithTimeout(const std::function<void()>& fn) {
             waited++;
         }
         // timeout
-        m_logger.log("EXECUTION: kernel timeout, killing child", "error");
+        m_logger.log("EXECUTION: kernel timeout, killing child", LogType::ERROR);
         kill(pid, SIGKILL);
         waitpid(pid, &status, 0);
         return false;
     } else {
-        m_logger.log("EXECUTION: fork failed for timeout watchdog", "error");
+        m_logger.log("EXECUTION: fork failed for timeout watchdog", LogType::ERROR);
         return false;
     }
 #else
@@ -532,33 +671,85 @@ void App::requestExit() {
     m_shouldExit = true;
 }
 
+std::shared_ptr<const TrainerSnapshot> App::trainerSnapshot() const {
+    if (m_bgTrainer.running()) return m_bgTrainer.snapshot();
+    auto snap = std::make_shared<TrainerSnapshot>();
+    // non-owning view of the live policy (aliasing constructor, no copy)
+    snap->policy           = std::shared_ptr<const Policy>(std::shared_ptr<const Policy>(),
+                                                           &m_trainer.policy());
+    snap->observations     = m_trainer.observations();
+    snap->avgLoss          = m_trainer.avgLoss();
+    snap->lastLoss         = m_trainer.lastLoss();
+    snap->maxReward        = m_trainer.maxReward();
+    snap->lastUsedSequence = m_trainer.test_lastUsedSequence();
+    return snap;   // no int8 model: scoringModel() quantizes on its own cadence
+}
+
+const std::shared_ptr<const QuantizedPolicy>& App::scoringModel() const {
+    // a new model invalidates every cached prefix state, so the weights
+    // are only picked up every few generations rather than after each step
+    if (!m_scoreModel || m_generation < m_scoreModelGen ||
+        m_generation - m_scoreModelGen >= kScoreRefreshGen) {
+        if (m_bgTrainer.running())
+            m_scoreModel = m_bgTrainer.snapshot()->quantized;   // built on the trainer thread
+        else
+            m_scoreModel = std::make_shared<const QuantizedPolicy>(m_trainer.policy());
+        m_scoreModelGen = m_generation;
+    }
+    return m_scoreModel;
+}
+
+float App::predictReward(const std::vector<uint8_t>& seq) const {
+    return m_prefixCache.score(scoringModel(), seq, m_scoreState, m_scoreInput);
+}
+
+void App::queueCheckpoint(const std::string& path) {
+    auto snap = trainerSnapshot();
+    // the background trainer's snapshot is already an immutable copy; the
+    // synchronous view has to be copied before another training step
+    std::shared_ptr<const Policy> model = m_bgTrainer.running()
+        ? snap->policy
+        : std::make_shared<const Policy>(*snap->policy);
+    CheckpointStats stats;
+    stats.observations = snap->observations;
+    stats.avgLoss      = snap->avgLoss;
+    stats.maxReward    = snap->maxReward;
+    m_checkpointer.submit(std::move(model), stats, path);
+}
+
 void App::trainAndMaybeSave(const TelemetryEntry& te,
                             const std::vector<uint8_t>& mutSeq) {
-    // run the full sequence through a policy copy so the LSTM processes
-    // every opcode, not just the last one.  The copy is necessary because
-    // we need resetState() which is non-const.
+    TRACE_SCOPE("App::trainAndMaybeSave", "train");
+    // score the full sequence with the int8 policy so the LSTM processes
+    // every opcode, not just the last one.  The quantized model is
+    // immutable and keeps its LSTM state in m_scoreState, so neither mode
+    // needs a copy of the fp32 weights here; the prefix shared with the
+    // previous kernel is resumed from m_prefixCache.
     float predBefore = 0.0f;
     int seqLen = 0;
     if (!te.kernelBase64.empty()) {
-        auto seq = Feature::extractSequence(te);
+        auto features = Feature::kernel(te);
+        const auto& seq = features->opcodes;
         seqLen = (int)seq.size();
         if (!seq.empty()) {
-            Policy pol = m_trainer.policy(); // copy
-            pol.resetState();
-            for (auto op : seq) {
-                std::vector<float> feat(kFeatSize, 0.0f);
-                if (op < kFeatSize) feat[op] = 1.0f;
-                auto out = pol.forward(feat);
-                predBefore = out.empty() ? 0.0f : out[0];
-            }
+            predBefore = predictReward(seq);
         } else {
-            auto feat = Feature::extract(te);
-            auto out = m_trainer.policy().forward(feat);
+            const auto& model = scoringModel();
+            model->resetState(m_scoreState);
+            Feature::extractSparse(te, m_scoreInput);
+            const auto& out = model->forward(m_scoreInput, m_scoreState);
             predBefore = out.empty() ? 0.0f : out[0];
         }
     }
 
-    m_trainer.observe(te);
+    const bool async = m_bgTrainer.running();
+    if (async) {
+        // never wait for the trainer; a full queue drops the entry
+        if (!m_bgTrainer.submit(te)) appMetrics().trainDropped.inc();
+    } else {
+        ScopedTimer timer(appMetrics().train);
+        m_trainer.observe(te);
+    }
 
     // build a compact description of the mutation opcodes
     std::string mutDesc;
@@ -570,12 +761,14 @@ void App::trainAndMaybeSave(const TelemetryEntry& te,
         }
     }
 
-    // log NN feedback: generation, mutation, model prediction, loss
+    // log NN feedback: generation, mutation, model prediction, loss (with
+    // --async-train the statistics are those of the latest snapshot)
     {
+        auto snap = trainerSnapshot();
         float reward = static_cast<float>(te.generation);
-        float loss = m_trainer.lastLoss();
-        float avgLoss = m_trainer.avgLoss();
-        int obs = m_trainer.observations();
+        float loss = snap->lastLoss;
+        float avgLoss = snap->avgLoss;
+        int obs = snap->observations;
         std::ostringstream ss;
         ss << std::fixed;
         ss << "NN: gen=" << te.generation
@@ -588,12 +781,19 @@ void App::trainAndMaybeSave(const TelemetryEntry& te,
            << " loss=" << std::setprecision(6) << loss
            << " avgLoss=" << std::setprecision(6) << avgLoss
            << " obs=" << obs
-           << (m_trainer.test_lastUsedSequence() ? " [SEQ]" : " [HIST]");
-        m_logger.log(ss.str(), "info");
+           << (snap->lastUsedSequence ? " [SEQ]" : " [HIST]")
+           << (async ? " [ASYNC]" : "");
+        m_logger.log(ss.str(), LogType::INFO);
     }
 
+    // throttled: every --checkpoint-every generations or when the loss has
+    // improved, written off this thread
     if (!m_opts.saveModelPath.empty()) {
-        m_trainer.save(m_opts.saveModelPath);
+        float avgLoss = trainerSnapshot()->avgLoss;
+        if (m_checkpointer.due(m_generation, avgLoss)) {
+            queueCheckpoint(m_opts.saveModelPath);
+            m_checkpointer.mark(m_generation, avgLoss);
+        }
     }
 }
 
@@ -617,7 +817,11 @@ void App::onWasmLog(uint32_t ptr, uint32_t len,
         return;
     }
 
+    TRACE_SCOPE("App::onWasmLog");
+    auto validateStart = std::chrono::steady_clock::now();
     std::string output(reinterpret_cast<const char*>(mem + ptr), len);
+    bool verified = output == m_currentKernel;
+    appMetrics().validate.observeNs(nsSince(validateStart));
 
     m_logger.log("STDOUT: Received " + std::to_string(len) +
                  " bytes from 0x" + [&]{
@@ -625,31 +829,45 @@ void App::onWasmLog(uint32_t ptr, uint32_t len,
                      ss << std::uppercase << std::hex << std::setw(4)
                         << std::setfill('0') << ptr;
                      return ss.str();
-                 }(), "info");
+                 }(), LogType::INFO);
 
-    if (output == m_currentKernel) {
-        m_logger.log("VERIFICATION: MEMORY INTEGRITY CONFIRMED", "success");
-        m_logger.log("EXEC: QUINE SUCCESS -> INITIATING REBOOT...", "system");
+    if (verified) {
+        m_logger.log("VERIFICATION: MEMORY INTEGRITY CONFIRMED", LogType::SUCCESS);
+        m_logger.log("EXEC: QUINE SUCCESS -> INITIATING REBOOT...", LogType::SYSTEM);
 
         m_stableKernel = m_currentKernel;
         m_retryCount   = 0;
+        // this kernel ran clean: the reason of an earlier trap must not
+        // label it (or the telemetry recorded for it) as trapped
+        m_lastTrapReason.clear();
         m_logger.addHistory({ m_generation, nowIso(), (int)kernelBytes(),
                                "EXECUTE", "Verification Success", true });
 
         // Evolve
         try {
+            auto evolveStart = std::chrono::steady_clock::now();
             int seed = m_generation + 1;
-            auto evo = evolveBinary(m_currentKernel, m_knownInstructions, seed,
-                                        m_opts.mutationStrategy);
+            // cheap opcode language-model pre-filter: evolveBinary redraws
+            // genomes that look far more like trapped kernels than
+            // successful ones before it builds and validates a candidate
+            MutationFilter ngramFilter = [this](const std::vector<uint8_t>& seq) {
+                return m_advisor.likelihoodScore(seq) >= kNgramRejectScore;
+            };
+            auto evolve = [&](int s) {
+                auto r = evolveBinary(m_currentKernel, m_knownInstructions, s,
+                                      m_opts.mutationStrategy, ngramFilter, kNgramRerolls);
+                appMetrics().ngramRerolls.inc((uint64_t)r.rerolls);
+                return r;
+            };
+            auto evo = evolve(seed);
             // ask the advisor to score the candidate sequence
             {
                 float sc = m_advisor.score(evo.mutationSequence);
-                m_logger.log("ADVISOR SCORE: " + std::to_string(sc), "info");
+                m_logger.log("ADVISOR SCORE: " + std::to_string(sc), LogType::INFO);
                 if (sc < 0.05f) {
-                    m_logger.log("ADVISOR: extremely low score, rerolling", "warning");
+                    m_logger.log("ADVISOR: extremely low score, rerolling", LogType::WARNING);
                     seed++;
-                    evo = evolveBinary(m_currentKernel, m_knownInstructions, seed,
-                                        m_opts.mutationStrategy);
+                    evo = evolve(seed);
                 }
             }
             // if the mutation is blacklisted and heuristic enabled, retry a few times
@@ -657,12 +875,12 @@ void App::onWasmLog(uint32_t ptr, uint32_t len,
             while (m_opts.heuristic != HeuristicMode::NONE &&
                    !evo.mutationSequence.empty() &&
                    isBlacklisted(evo.mutationSequence) && tries < 8) {
-                m_logger.log("EVOLUTION: mutation sequence blacklisted, reroll", "warning");
+                m_logger.log("EVOLUTION: mutation sequence blacklisted, reroll", LogType::WARNING);
                 seed++;
-                evo = evolveBinary(m_currentKernel, m_knownInstructions, seed,
-                                        m_opts.mutationStrategy);
+                evo = evolve(seed);
                 tries++;
             }
+            appMetrics().evolve.observeNs(nsSince(evolveStart));
             auto evolved = base64_decode(evo.binary);
             if (evolved.size() < 8 || evolved[0] != 0x00 || evolved[1] != 0x61 ||
                 evolved[2] != 0x73 || evolved[3] != 0x6D)
@@ -674,6 +892,8 @@ void App::onWasmLog(uint32_t ptr, uint32_t len,
             m_evolutionAttempts++;
             if (!evo.mutationSequence.empty()) {
                 m_mutationsApplied++;
+                appMetrics().mutated.inc();
+                m_lastMutationAction = (int)evo.actionUsed;
                 switch (evo.actionUsed) {
                     case EvolutionAction::MODIFY: m_mutationModify++; break;
                     case EvolutionAction::INSERT: m_mutationInsert++; break;
@@ -681,26 +901,28 @@ void App::onWasmLog(uint32_t ptr, uint32_t len,
                     case EvolutionAction::DELETE: m_mutationDelete++; break;
                 }
             }
-            m_logger.log("EVOLUTION: " + evo.description, "mutation");
+            m_logger.log("EVOLUTION: " + evo.description, LogType::MUTATION);
             m_logger.addHistory({ m_generation, nowIso(), (int)kernelBytes(),
                                    "EVOLVE", evo.description, true });
             // train on this generation
             {
                 TelemetryEntry te;
                 te.generation = m_generation;
-                te.kernelBase64 = m_currentKernel;
-                te.trapCode = m_lastTrapReason;
+                te.kernelBase64 = m_currentKernel;   // verified, so no trap code
+                te.features = Feature::kernel(te);   // shared with the trainer and advisor
                 trainAndMaybeSave(te, evo.mutationSequence);
             }
         } catch (const EvolutionException& ee) {
             std::string msg = std::string("EVOLUTION REJECTED: ") + ee.what();
             if (!ee.binary.empty())
                 msg += " candidate=" + ee.binary;
-            m_logger.log(msg, "warning");
+            m_logger.log(msg, LogType::WARNING);
+            appMetrics().rejected.inc();
             m_nextKernel.clear();
             m_pendingMutation.clear();
         } catch (const std::exception& e) {
-            m_logger.log(std::string("EVOLUTION REJECTED: ") + e.what(), "warning");
+            m_logger.log(std::string("EVOLUTION REJECTED: ") + e.what(), LogType::WARNING);
+            appMetrics().rejected.inc();
             m_nextKernel.clear();
             m_pendingMutation.clear();
         }
@@ -720,13 +942,13 @@ void App::onGrowMemory(uint32_t /*pages*/) {
 void App::spawnInstance(const std::string& kernel) {
     if (!kernel.empty()) {
         m_instances.push_back(kernel);
-        m_logger.log("SPAWN: recorded new instance (total=" + std::to_string(m_instances.size()) + ")", "info");
+        m_logger.log("SPAWN: recorded new instance (total=" + std::to_string(m_instances.size()) + ")", LogType::INFO);
     }
 }
 
 void App::killInstance(int index) {
     if (index < 0 || index >= (int)m_instances.size()) return;
-    m_logger.log("KILL: removing instance " + std::to_string(index), "info");
+    m_logger.log("KILL: removing instance " + std::to_string(index), LogType::INFO);
     m_instances.erase(m_instances.begin() + index);
 }
 
@@ -781,16 +1003,19 @@ void App::decayBlacklist() {
 // ─── Failure / Repair ────────────────────────────────────────────────────────
 
 void App::handleBootFailure(const std::string& reason) {
-    m_logger.log("CRITICAL: " + reason, "error");
+    TRACE_SCOPE("App::handleBootFailure");
+    m_logger.log("CRITICAL: " + reason, LogType::ERROR);
+    appMetrics().failures.inc();
     m_logger.addHistory({ m_generation, nowIso(), (int)kernelBytes(),
                           "REPAIR", reason, false });
 
-    // record trap reason for telemetry
+    // record trap reason for telemetry, and the kernel it belongs to
     m_lastTrapReason = reason;
+    m_trappedKernel  = m_currentKernel;
     // add the mutation that just produced the failing kernel to blacklist
     if (!m_pendingMutation.empty() && m_opts.heuristic != HeuristicMode::NONE) {
         addToBlacklist(m_pendingMutation);
-        m_logger.log("HEURISTIC: blacklisted mutation sequence", "warning");
+        m_logger.log("HEURISTIC: blacklisted mutation sequence", LogType::WARNING);
     }
 
     m_retryCount++;
@@ -801,12 +1026,12 @@ void App::handleBootFailure(const std::string& reason) {
         m_currentKernel  = evo.binary;
         m_nextKernel.clear();
         m_pendingMutation = evo.mutationSequence;
-        m_logger.log("ADAPTATION: " + evo.description, "mutation");
+        m_logger.log("ADAPTATION: " + evo.description, LogType::MUTATION);
         updateKernelData();
     } catch (...) {
         m_currentKernel = m_stableKernel;
         m_pendingMutation.clear();
-        m_logger.log("ADAPTATION: Fallback to base stable kernel", "system");
+        m_logger.log("ADAPTATION: Fallback to base stable kernel", LogType::SYSTEM);
         updateKernelData();
     }
 
@@ -818,6 +1043,13 @@ void App::handleBootFailure(const std::string& reason) {
 }
 
 void App::doReboot(bool success) {
+    TRACE_SCOPE("App::doReboot");
+    // the generation's telemetry describes the kernel that ran, not the
+    // evolved child swapped in below or the repair candidate that
+    // handleBootFailure() already installed
+    std::string ranKernel = success || m_trappedKernel.empty() ? m_currentKernel
+                                                              : std::move(m_trappedKernel);
+    m_trappedKernel.clear();
     m_kernel.terminate();
     m_programCounter = -1;
     m_focusAddr      = 0;
@@ -830,33 +1062,56 @@ void App::doReboot(bool success) {
         m_lastGenDurationMs = (nowTicks - m_genStartTime) / 1000.0; // ticks are us?
         if (m_opts.profile) {
             m_logger.log("PROFILE: gen " + std::to_string(m_generation) +
-                          " took " + std::to_string(m_lastGenDurationMs) + " ms", "info");
+                          " took " + std::to_string(m_lastGenDurationMs) + " ms", LogType::INFO);
         }
     }
 
     if (success) {
+        if (m_genWallStart != std::chrono::steady_clock::time_point{})
+            appMetrics().gen.observeNs(nsSince(m_genWallStart));
+        appMetrics().gens.inc();
         m_generation++;
         // record generation start time
         m_genStartTime = now();
-
-        // if we have reached the automatic training generation threshold,
-        // or a later multiple of it, disable evolution and prepare to load the
-        // new telemetry data.  this allows endless alternating cycles of
-        // evolution and training.
-        if (m_generation > 0 && m_generation % kAutoTrainGen == 0) {
+        m_genWallStart = std::chrono::steady_clock::now();
+
+        // when the scheduler says a training cycle is due (see
+        // TrainingScheduler: new telemetry, staleness, loss plateau),
+        // disable evolution and prepare to load the new telemetry data.
+        // this allows endless alternating cycles of evolution and
+        // training.  --async-train only checkpoints every kAutoTrainGen.
+        if (m_generation > 0 && m_generation % kAutoTrainGen == 0 && m_bgTrainer.running()) {
+            // evolution keeps going: hand exports from other runs to the
+            // trainer thread and have it write the usual checkpoint
+            size_t from  = m_advisor.entries().size();
+            size_t added = m_advisor.rescan();
+            const auto& entries = m_advisor.entries();
+            for (size_t i = from; i < entries.size(); ++i)
+                if (!m_bgTrainer.submit(entries[i])) appMetrics().trainDropped.inc();
+            queueCheckpoint((telemetryRoot() / "model_checkpoint.dat").string());
             m_logger.log("AUTO: reached generation " + std::to_string(m_generation) +
-                          ", switching to training", "info");
-            m_evolutionEnabled = false;
-            // clear any previous checkpoint flag so we will save again later
-            m_modelSaved = false;
-            // wipe the trainer statistics/replay buffer so the next train cycle
-            // starts from a clean slate (weights remain unchanged)
-            m_trainer.reset();
-            // re-scan telemetry so the advisor sees the latest entries
-            namespace fs = std::filesystem;
-            fs::path seqBase = telemetryRoot();
-            m_advisor = Advisor(seqBase.string());
-            prepareTrainingSteps();
+                          ", checkpointing; training continues in background (" +
+                          std::to_string(added) + " new entries from other runs)", LogType::INFO);
+        } else if (!m_bgTrainer.running() && m_evolutionEnabled &&
+                   m_generation - m_scheduler.lastCycleGeneration() >=
+                       m_scheduler.config().minInterval) {
+            // this run's entries are already in the advisor; pick up the
+            // exports other runs have written since the last scan.  Only
+            // those can make the model stale early (see TrainingScheduler).
+            m_scheduler.addForeign(m_advisor.rescan());
+            if (m_scheduler.due(m_generation, m_advisor.size())) {
+                m_logger.log("AUTO: generation " + std::to_string(m_generation) + ", " +
+                              std::to_string(m_scheduler.newEntries(m_advisor.size())) +
+                              " new entries (" + std::to_string(m_scheduler.foreignEntries()) +
+                              " from other runs), switching to training", LogType::INFO);
+                m_evolutionEnabled = false;
+                // clear any previous checkpoint flag so we will save again later
+                m_modelSaved = false;
+                // wipe the trainer statistics/replay buffer so the next train
+                // cycle starts from a clean slate (weights remain unchanged)
+                m_trainer.reset();
+                prepareTrainingSteps();
+            }
         }
 
         // check against user-specified generation limit as well
@@ -899,23 +1154,78 @@ void App::doReboot(bool success) {
         m_pendingMutation.clear();
     }
 
-    // automatically export telemetry for this generation/session
+    // feed this generation to the advisor and export it for other runs
+    recordTelemetry(ranKernel);
+    publishGeneration();
     autoExport();
 
     transitionTo(SystemState::IDLE);
 }
 
+// Push the telemetry entry describing the generation's kernel straight into
+// the advisor.  The opcode sequence comes from the feature cache (or the
+// cached bytes of the current kernel) so nothing is read back from disk.
+void App::recordTelemetry(const std::string& kernel) {
+    TRACE_SCOPE("App::recordTelemetry");
+    TelemetryEntry te;
+    te.generation     = m_generation;
+    te.kernelBase64   = kernel;
+    te.trapCode       = m_lastTrapReason;
+    // usually already cached by trainAndMaybeSave or an earlier boot;
+    // otherwise parse the bytes we hold rather than decoding the base64
+    te.features       = FeatureCache::global().get(
+        kernel, kernel == m_currentKernel ? &m_currentKernelBytes : nullptr);
+    te.opcodeSequence = te.features->opcodes;
+    m_advisor.append(std::move(te));
+}
+
+void App::publishGeneration() {
+    if (!m_publisher.isOpen()) return;
+    GenerationEvent ev;
+    ev.kind       = (uint32_t)StreamEventKind::GENERATION;
+    ev.generation = m_generation;
+    ev.fromState  = ev.toState = (uint8_t)m_fsm.current();
+    ev.action     = (int8_t)m_lastMutationAction;
+    ev.kernelSize = (uint32_t)m_currentKernelBytes.size();
+    ev.durationMs = (float)m_lastGenDurationMs;
+    ev.loss       = trainerSnapshot()->lastLoss;
+    setTrapCode(ev, m_lastTrapReason);
+    m_publisher.publish(ev);
+}
+
+void App::writeMetrics() {
+    TRACE_SCOPE("App::writeMetrics", "export");
+    auto& m = appMetrics();
+    m.genNow.set(m_generation);
+    m.kbytes.set((double)m_currentKernelBytes.size());
+    m.advisor.set((double)m_advisor.entryCount());
+    m.loss.set(trainerSnapshot()->lastLoss);
+    m.trainBacklog.set((double)m_bgTrainer.backlog());
+    m.blacklist.set((double)m_blacklist.size());
+    try {
+        std::filesystem::path root = telemetryRoot();
+        std::filesystem::create_directories(root);
+        if (!metrics().writeTextfile((root / "bootloader.prom").string()))
+            m_logger.log("METRICS: failed to write " + (root / "bootloader.prom").string(), LogType::WARNING);
+    } catch (const std::exception& e) {
+        m_logger.log(std::string("METRICS: ") + e.what(), LogType::WARNING);
+    }
+}
+
 // ─── Export ──────────────────────────────────────────────────────────────────
 
 #include <filesystem>  // for auto-export
 
 
 std::string App::exportHistory() const {
+    return buildReport(makeExportData());
+}
+
+ExportData App::makeExportData() const {
     ExportData d;
     d.generation    = m_generation;
     d.currentKernel = m_currentKernel;
     d.instructions  = m_instructions;
-    d.logs          = m_logger.logs();
     d.history       = m_logger.history();
     // telemetry metrics
     d.mutationsAttempted = m_evolutionAttempts;
@@ -933,7 +1243,7 @@ std::string App::exportHistory() const {
     // heuristic summary
     d.heuristicBlacklistCount = (int)m_blacklist.size();
     d.advisorEntryCount       = (int)m_advisor.entryCount();
-    return buildReport(d);
+    return d;
 }
 
 // Write the current telemetry and kernel blob to the session directory.
@@ -1005,7 +1315,9 @@ void App::exportNow() {
 }
 
 void App::autoExport() {
+    TRACE_SCOPE("App::autoExport", "export");
     namespace fs = std::filesystem;
+    ScopedTimer timer(appMetrics().exportT);
     try {
         fs::path base = telemetryRoot() / m_runId;
         fs::create_directories(base);
@@ -1021,9 +1333,9 @@ void App::autoExport() {
         fs::path lockPath = base / "export.lock";
         lockfd = ::open(lockPath.string().c_str(), O_CREAT | O_RDWR, 0666);
         if (lockfd >= 0) flock(lockfd, LOCK_EX);
-        std::ofstream r(reportFile);
-        if (r) {
-            if (m_opts.telemetryFormat == TelemetryFormat::JSON) {
+        if (m_opts.telemetryFormat == TelemetryFormat::JSON) {
+            std::ofstream r(reportFile);
+            if (r) {
                 // simple JSON object; callers can parse as needed
                 r << "{\n";
                 r << "  \"generation\": " << m_generation << ",\n";
@@ -1037,16 +1349,40 @@ void App::autoExport() {
                 r << "  \"heuristicBlacklistCount\": " << (int)m_blacklist.size() << "\n";
                 r << "  \"advisorEntryCount\": " << (int)m_advisor.entryCount() << "\n";
                 r << "}\n";
-            } else {
-                if (m_opts.telemetryLevel == TelemetryLevel::BASIC) {
-                    r << "WASM QUINE BOOTLOADER - SYSTEM HISTORY EXPORT\n";
-                    r << "Generated: " << nowIso() << "\n";
-                    r << "Final Generation: " << m_generation << "\n";
-                } else {
-                    r << exportHistory();
+            }
+        } else {
+            // only history added since the last export goes into this
+            // report; the run's complete ledger is history.log, which grows
+            // by the same entries so export cost stays flat over a long run
+            ExportData d = makeExportData();
+            Span<HistoryEntry> newHistory =
+                Span<HistoryEntry>(m_logger.history()).subspan(m_historyExported);
+            d.history = newHistory;
+
+            // stream the text report straight into the file; the writer
+            // only renders the sections the telemetry level asks for
+            int fd = ::open(reportFile.string().c_str(),
+                            O_CREAT | O_WRONLY | O_TRUNC, 0644);
+            if (fd >= 0) {
+                if (!m_reportWriter.writeTo(fd, d, m_opts.telemetryLevel))
+                    m_logger.log("autoExport: short write to " + reportFile.string(), LogType::WARNING);
+                close(fd);
+            }
+
+            if (m_opts.telemetryLevel == TelemetryLevel::FULL && !newHistory.empty()) {
+                fs::path historyFile = base / "history.log";
+                int hfd = ::open(historyFile.string().c_str(),
+                                 O_CREAT | O_WRONLY | O_APPEND, 0644);
+                if (hfd >= 0) {
+                    if (m_reportWriter.appendHistoryTo(hfd, newHistory))
+                        m_historyExported += newHistory.size();
+                    else
+                        m_logger.log("autoExport: short write to " + historyFile.string(), LogType::WARNING);
+                    close(hfd);
                 }
             }
         }
+        appMetrics().exports.inc();
         // also dump raw kernel base64 for easier consumption if full
         if (m_opts.telemetryLevel == TelemetryLevel::FULL) {
             fs::path kernelFile = base / ("kernel_" + std::to_string(m_generation) + ".b64");
@@ -1059,6 +1395,6 @@ void App::autoExport() {
         }
     } catch (const std::exception& e) {
         // logging may not be initialized yet
-        m_logger.log(std::string("autoExport failed: ") + e.what(), "error");
+        m_logger.log(std::string("autoExport failed: ") + e.what(), LogType::ERROR);
     }
 }
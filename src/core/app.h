@@ -3,11 +3,19 @@
 #include "types.h"
 #include "fsm.h"
 #include "log.h"
+#include "exporter.h"
+#include "telemetry_stream.h"
+#include "metrics.h"
 #include "wasm/kernel.h"
 #include "wasm/parser.h"
 #include "cli.h"
 #include "nn/advisor.h"
 #include "nn/train.h"
+#include "nn/background_trainer.h"
+#include "nn/checkpointer.h"
+#include "nn/prefix_cache.h"
+#include "nn/train_scheduler.h"
+#include <chrono>
 #include <climits>
 #include <functional>
 #include <map>
@@ -18,9 +26,14 @@
 #include <vector>
 #include <cstdint>
 
-// automatic transition threshold; tests reference this value to drive
-// evolution/training cycles without hard-coding the number.
+// training cadence while the loss still improves (TrainingScheduler
+// interval; --async-train checkpoints on it).  tests reference this value
+// to drive evolution/training cycles without hard-coding the number; a
+// cycle may start earlier when new telemetry makes the model stale.
 static constexpr int kAutoTrainGen = 50;
+// generations the scoring model may lag the trainer; prefix states cached
+// for kernel scoring stay valid for that long
+static constexpr int kScoreRefreshGen = 8;
 
 // ── App ───────────────────────────────────────────────────────────────────────
 //
@@ -52,7 +65,10 @@ public:
     bool         isSystemReading()     const { return m_sysReading; }
     size_t       kernelBytes()         const;
 
-    const std::deque<LogEntry>&               logs()         const { return m_logger.logs(); }
+    std::vector<LogEntry>                     logs()         const { return m_logger.logs(); }
+    // Copy the log ring into `out` (reuses its capacity; GUI per-frame path).
+    void      snapshotLogs(std::vector<LogEntry>& out) const { m_logger.snapshot(out); }
+    uint64_t  lastLogId()                              const { return m_logger.lastId(); }
     const std::vector<Instruction>&           instructions() const { return m_instructions; }
     const std::string&                        currentKernel() const { return m_currentKernel; }
     const std::string&                        stableKernel()  const { return m_stableKernel; }
@@ -76,11 +92,11 @@ public:
     // convenient logging wrapper for UI and tests; preferring this avoids
     // callers having to grab the internal logger and bypass the const
     // guarantee of `logs()`.
-    void log(const std::string& msg, const std::string& type = "info") {
+    void log(std::string_view msg, LogType type = LogType::INFO) {
         m_logger.log(msg, type);
     }
 
-    // Build and return a telemetry report string.
+    // Build and return a telemetry report string (full history).
     std::string exportHistory() const;
 
     // Execute a callback with a per-run timeout.  On platforms that support
@@ -104,9 +120,27 @@ public:
     // access CLI options
     const CliOptions& options() const { return m_opts; }
 
-    // expose trainer for tests
+    // expose trainer for tests.  With --async-train the trainer belongs to
+    // the background thread once evolution starts; use trainerSnapshot().
     const Trainer& trainer() const { return m_trainer; }
 
+    // Current policy weights and trainer statistics, safe to read from the
+    // GUI and evolution paths in both modes.  Synchronous mode returns a
+    // view of the live trainer (valid until the next training step).
+    std::shared_ptr<const TrainerSnapshot> trainerSnapshot() const;
+    // true once the --async-train trainer thread is running
+    bool backgroundTraining() const { return m_bgTrainer.running(); }
+    // Predicted reward for an opcode sequence from the int8-quantized
+    // policy (at most kScoreRefreshGen generations behind the trainer),
+    // resuming from cached prefix states where the sequence matches a
+    // recently scored one.  Evolution thread only.
+    float predictReward(const std::vector<uint8_t>& seq) const;
+
+    // Model checkpoints are written by a background Checkpointer; block
+    // until every queued checkpoint is on disk.
+    void flushCheckpoints() { m_checkpointer.flush(); }
+    const Checkpointer& checkpointer() const { return m_checkpointer; }
+
     // expose advisor for GUI or tests
     const Advisor& advisor() const { return m_advisor; }
 
@@ -134,6 +168,8 @@ public:
 
     // query whether the evolution FSM is currently enabled (used by GUI)
     bool          evolutionEnabled() const { return m_evolutionEnabled; }
+    // when to train, cycle budgets and the evolution/training time split
+    const TrainingScheduler& scheduler() const { return m_scheduler; }
 
     // test helpers
     // simulate a boot failure triggered by the given mutation sequence
@@ -148,6 +184,7 @@ public:
     void test_forceEvolutionEnabled(bool v) { m_evolutionEnabled = v; }
     void test_forceTrainingPhase(TrainingPhase p) { m_trainingPhase = p; }
     void test_forceModelSaved(bool v) { m_modelSaved = v; }
+    TrainingScheduler& test_scheduler() { return m_scheduler; }
     // expose internal counters for unit tests
     int test_trainingStep() const { return m_trainingStep; }
     int test_trainingLoadEnd() const { return m_trainingLoadEnd; }
@@ -191,8 +228,9 @@ public:
 
     // helpers used by tests to validate constructor path decisions
 
-    // recompute training step counts from the current advisor entries
-    // and reset the phase to LOADING; used when telemetry is reloaded.
+    // plan a training cycle over the current advisor entries (see
+    // TrainingScheduler) and reset the phase to LOADING; used at startup
+    // and when a cycle starts.
     void          prepareTrainingSteps();
     std::filesystem::path logsDir() const { return m_logsDir; }
     std::filesystem::path seqBaseDir() const { return m_seqBase; }
@@ -209,6 +247,11 @@ private:
     // FSM helpers
     void transitionTo(SystemState s);
 
+    // Snapshot the current weights and queue them for writing to `path`.
+    void queueCheckpoint(const std::string& path);
+    // the int8 scoring model, refreshed from trainerSnapshot() when stale
+    const std::shared_ptr<const QuantizedPolicy>& scoringModel() const;
+
     // Training tick: advance the startup RL training phase by one step.
     // Called every frame from update() until training is complete.
     void tickTraining();
@@ -223,6 +266,18 @@ private:
 
     // Export helpers
     void autoExport();
+    // view of the state rendered into telemetry reports; borrows App's
+    // containers, so it must not outlive the current call
+    ExportData makeExportData() const;
+    // append this generation's entry for `kernel`, the kernel that actually
+    // ran (and trapped, if m_lastTrapReason is set), to the in-memory advisor
+    void recordTelemetry(const std::string& kernel);
+    // push a GENERATION event to the live stream (no-op when disabled)
+    void publishGeneration();
+    // refresh gauges and rewrite <telemetry root>/bootloader.prom
+    void writeMetrics();
+    // BootFsm transition hook: closes the trace slice of the state we left
+    void onStateTransition(SystemState from, SystemState to);
 
     // WASM host callbacks
     void onWasmLog(uint32_t ptr, uint32_t len, const uint8_t* mem, uint32_t memSize);
@@ -236,6 +291,13 @@ private:
     BootFsm   m_fsm;
     AppLogger m_logger;
     WasmKernel m_kernel;
+    // reused between exports so report rendering does not reallocate
+    ReportWriter m_reportWriter;
+    // number of history entries already written to <run>/history.log;
+    // autoExport() only renders the entries after this index
+    size_t m_historyExported = 0;
+    // live event stream (--telemetry-stream); closed unless requested
+    TelemetryPublisher m_publisher;
 
     // directory paths computed during construction (exposed for tests)
     std::filesystem::path m_logsDir;
@@ -244,6 +306,22 @@ private:
     // for learning & advice
     Advisor m_advisor;
     Trainer m_trainer;
+    // --async-train: owns m_trainer while evolution runs; declared after it
+    // so the thread is joined first
+    BackgroundTrainer m_bgTrainer{m_trainer};
+    // writes model checkpoints off the evolution thread (--save-model,
+    // training-cycle checkpoints)
+    Checkpointer m_checkpointer;
+    mutable QuantizedPolicy::State m_scoreState;
+    mutable SparseVector m_scoreInput;
+    // int8 model used for kernel scoring, quantized from the trainer (or
+    // taken from the background trainer's snapshot) every kScoreRefreshGen
+    // generations, and the LSTM states along recently
+    // scored kernels so a child kernel only runs the opcodes after its
+    // mutation point
+    mutable std::shared_ptr<const QuantizedPolicy> m_scoreModel;
+    mutable int m_scoreModelGen = 0;
+    mutable PrefixStateCache m_prefixCache;
 
     // ── State ─────────────────────────────────────────────────────────────────
     // era tracking removed; visual themes not required
@@ -279,10 +357,17 @@ private:
     std::unordered_map<std::vector<uint8_t>, int, VecHash> m_blacklist;
     // profiling / telemetry timing
     uint64_t m_genStartTime   = 0; // steady ticks at generation start
+    std::chrono::steady_clock::time_point m_genWallStart{}; // for wqb_generation_seconds
+    uint64_t m_lastMetricsWrite = 0; // now() of the last textfile write
+    uint64_t m_stateEnteredNs   = 0; // trace::nowNs() when the FSM entered its state
     double   m_lastGenDurationMs = 0.0;
     int      m_kernelSizeMin  = INT_MAX;
     int      m_kernelSizeMax  = 0;
     std::string m_lastTrapReason;
+    // the kernel that trapped, kept by handleBootFailure() after it replaces
+    // m_currentKernel with a repair candidate; recorded by doReboot(false)
+    std::string m_trappedKernel;
+    int m_lastMutationAction = -1; // EvolutionAction of the last mutation
     int    m_programCounter    = -1;
 
     std::string m_stableKernel;
@@ -330,6 +415,8 @@ private:
     int           m_trainingStep     = 0;     // monotonically-increasing step counter
     int           m_trainingTotal    = 0;     // total steps (set in constructor)
     int           m_trainingLoadEnd  = 0;     // step at which LOADING phase ends
+    int           m_trainingWindow   = 0;     // newest entries the cycle trains on
+    TrainingScheduler m_scheduler;
 
 
     // optional time source (default uses SDL_GetTicks).  tests inject a fake
@@ -24,8 +24,14 @@ static const uint8_t DECODE_TABLE[256] = {
     64,64,64,64,64,64,64,64,64,64,64,64,64,64,64,64
 };
 
-std::vector<uint8_t> base64_decode(const std::string& encoded) {
+std::vector<uint8_t> base64_decode(std::string_view encoded) {
     std::vector<uint8_t> out;
+    base64_decode(encoded, out);
+    return out;
+}
+
+void base64_decode(std::string_view encoded, std::vector<uint8_t>& out) {
+    out.clear();
     out.reserve((encoded.size() / 4) * 3);
 
     uint32_t buf = 0;
@@ -41,5 +47,4 @@ std::vector<uint8_t> base64_decode(const std::string& encoded) {
             out.push_back((uint8_t)((buf >> bits) & 0xFF));
         }
     }
-    return out;
 }
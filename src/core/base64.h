@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <cstdint>
 #include <stdexcept>
@@ -29,4 +30,7 @@ inline std::string base64_encode(const std::vector<uint8_t>& data) {
 }
 
 // decode helper now lives in base64.cpp; non-inline to keep header small
-std::vector<uint8_t> base64_decode(const std::string& encoded);
+std::vector<uint8_t> base64_decode(std::string_view encoded);
+
+// decode into a caller-owned buffer so hot paths can reuse its capacity
+void base64_decode(std::string_view encoded, std::vector<uint8_t>& out);
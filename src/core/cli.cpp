@@ -53,12 +53,19 @@ CliOptions parseCli(int argc, char** argv) {
         {"save-model",       required_argument, nullptr, 's'},
         {"load-model",       required_argument, nullptr, 'L'},
         {"kernel",          required_argument, nullptr, 'k'},
+        {"telemetry-stream",required_argument, nullptr, 'S'},
+        {"metrics-interval-ms",required_argument, nullptr, 'I'},
+        {"trace",           required_argument, nullptr, 't'},
+        {"log-ring",        no_argument,       nullptr, 'R'},
+        {"train-threads",   required_argument, nullptr, 'j'},
+        {"async-train",     no_argument,       nullptr, 'A'},
+        {"checkpoint-every",required_argument, nullptr, 'C'},
         {nullptr, 0, nullptr, 0}
     };
 
     int opt;
     int longIndex = 0;
-    const char* optString = "ghfwpl:d:F:m:H:M:TX:s:L:k:";
+    const char* optString = "ghfwpl:d:F:m:H:M:TX:s:L:k:S:I:t:Rj:AC:";
     while ((opt = getopt_long(argc, argv, optString, longOpts, &longIndex)) != -1) {
         switch (opt) {
             case 'g':
@@ -155,12 +162,60 @@ CliOptions parseCli(int argc, char** argv) {
                     }
                 }
                 break;
+            case 'I':
+                if (optarg) {
+                    char* end;
+                    long v = std::strtol(optarg, &end, 10);
+                    if (*end != '\0' || v < 0) {
+                        std::cerr << "Warning: invalid metrics-interval-ms '" << optarg << "'\n";
+                        opts.parseError = true;
+                    } else {
+                        opts.metricsIntervalMs = static_cast<int>(v);
+                    }
+                }
+                break;
             case 's':
                 if (optarg) opts.saveModelPath = optarg;
                 break;
             case 'L':
                 if (optarg) opts.loadModelPath = optarg;
                 break;
+            case 't':
+                if (optarg) opts.tracePath = optarg;
+                break;
+            case 'R':
+                opts.logRing = true;
+                break;
+            case 'A':
+                opts.asyncTrain = true;
+                break;
+            case 'C':
+                if (optarg) {
+                    char* end;
+                    long v = std::strtol(optarg, &end, 10);
+                    if (*end != '\0' || v < 0) {
+                        std::cerr << "Warning: invalid checkpoint-every '" << optarg << "'\n";
+                        opts.parseError = true;
+                    } else {
+                        opts.checkpointEvery = static_cast<int>(v);
+                    }
+                }
+                break;
+            case 'j':
+                if (optarg) {
+                    char* end;
+                    long v = std::strtol(optarg, &end, 10);
+                    if (*end != '\0' || v < 0) {
+                        std::cerr << "Warning: invalid train-threads '" << optarg << "'\n";
+                        opts.parseError = true;
+                    } else {
+                        opts.trainThreads = static_cast<int>(v);
+                    }
+                }
+                break;
+            case 'S':
+                if (optarg) opts.telemetryStream = optarg;
+                break;
             case 'k':
                 if (optarg) {
                     if (std::strcmp(optarg, "seq") == 0) {
@@ -24,9 +24,28 @@ struct CliOptions {
     TelemetryLevel telemetryLevel = TelemetryLevel::FULL;
     TelemetryFormat telemetryFormat = TelemetryFormat::TEXT;
     std::string telemetryDir;    // override export path
+    // live event stream: shm ring name, or "unix:<path>" (empty = disabled)
+    std::string telemetryStream;
     MutationStrategy mutationStrategy = MutationStrategy::RANDOM;
     HeuristicMode heuristic = HeuristicMode::NONE; // NONE=no blacklist, BLACKLIST=block repeats, DECAY=block then slowly forget
     bool profile = false;
+    // how often the Prometheus textfile (<telemetry root>/bootloader.prom)
+    // is rewritten, in milliseconds; 0 disables it
+    int metricsIntervalMs = 5000;
+    // write Chrome trace-event JSON to this file (empty = tracing off)
+    std::string tracePath;
+    // log into a crash-persistent mmap ring (<logs>/bootloader_<stamp>.logring,
+    // decoded with log_decode) instead of the buffered text log
+    bool logRing = false;
+    // threads used for the headless startup corpus pass; the pool is
+    // stopped once it finishes.  0 = one per hardware thread
+    int trainThreads = 0;
+    // train on a background thread fed by a telemetry queue instead of
+    // pausing evolution every kAutoTrainGen generations
+    bool asyncTrain = false;
+    // --save-model checkpoint cadence: at most every N generations (plus on
+    // a 5% avg-loss improvement and at shutdown); 0 = only those triggers
+    int checkpointEvery = 10;
     int maxGen = 0;             // 0 = unlimited
 
     // model persistence paths
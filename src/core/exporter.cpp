@@ -4,142 +4,323 @@
 #include "wasm/parser.h"
 
 #include <cstdio>
+#include <cstring>
 #include <iostream>
-#include <sstream>
-#include <iomanip>
+#include <unistd.h>
 
-std::string buildReport(const ExportData& d) {
-    // ── Disassembly ────────────────────────────────────────────────────────────
-    std::string disasm = "No instructions available.";
-    if (!d.instructions.empty()) {
-        std::ostringstream ss;
-        for (int i = 0; i < (int)d.instructions.size(); i++) {
-            const auto& inst = d.instructions[i];
-            std::string name = getOpcodeName(inst.opcode);
-            std::string args;
-            for (int ai = 0; ai < inst.argLen; ++ai) {
-                if (!args.empty()) args += ' ';
-                char hex[8];
-                std::snprintf(hex, sizeof(hex), "0x%02X", (unsigned)inst.args[ai]);
-                args += hex;
-            }
-            ss << std::setw(3) << std::setfill('0') << i
-               << " | 0x" << std::uppercase << std::hex
-               << std::setw(4) << std::setfill('0') << inst.originalOffset
-               << " | " << std::setw(12) << std::setfill(' ') << std::left
-               << name << " " << args << '\n';
-        }
-        disasm = ss.str();
-    }
+static const char kHexDigits[] = "0123456789ABCDEF";
+static constexpr int kRuleWidth = 80;
 
-    // ── Hex dump ──────────────────────────────────────────────────────────────
-    auto raw = base64_decode(d.currentKernel);
-    if (raw.empty() && !d.currentKernel.empty()) {
-        std::cerr << "Exporter: decoded kernel is empty (input base64 length="
-                  << d.currentKernel.size() << ")\n";
-    }
-    std::ostringstream hd;
-    for (size_t i = 0; i < raw.size(); i += 16) {
-        hd << "0x" << std::uppercase << std::hex
-           << std::setw(4) << std::setfill('0') << i << "  ";
-        std::string ascii;
-        for (size_t j = 0; j < 16; j++) {
-            if (i + j < raw.size()) {
-                hd << std::uppercase << std::hex
-                   << std::setw(2) << std::setfill('0') << (int)raw[i + j] << ' ';
-                char c = (char)raw[i + j];
-                ascii += (c >= 32 && c <= 126) ? c : '.';
-            } else {
-                hd << "   ";
-                ascii += ' ';
-            }
+// ── Small formatting helpers ─────────────────────────────────────────────────
+
+void ReportWriter::appendRule() {
+    m_buf.append(kRuleWidth, '-');
+    m_buf += '\n';
+}
+
+void ReportWriter::appendInt(long long v, int width, char fill) {
+    char tmp[24];
+    char* end = tmp + sizeof(tmp);
+    char* p = end;
+    unsigned long long u = v < 0 ? 0ULL - (unsigned long long)v : (unsigned long long)v;
+    do {
+        *--p = (char)('0' + u % 10);
+        u /= 10;
+    } while (u);
+    if (v < 0) *--p = '-';
+    int n = (int)(end - p);
+    if (n < width) m_buf.append(width - n, fill);
+    m_buf.append(p, n);
+}
+
+// Opcode mnemonics padded to the 12-column disassembly field, built once so
+// the per-instruction path does no string formatting.
+namespace {
+struct OpcodeNameTable {
+    char name[256][16];
+    uint8_t len[256];
+    OpcodeNameTable() {
+        for (int op = 0; op < 256; ++op) {
+            std::string n = getOpcodeName((uint8_t)op);
+            size_t l = n.size() < sizeof(name[op]) ? n.size() : sizeof(name[op]);
+            std::memcpy(name[op], n.data(), l);
+            len[op] = (uint8_t)l;
         }
-        hd << " |" << ascii << "|\n";
     }
+};
+}
 
-    // ── History log ───────────────────────────────────────────────────────────
-    std::ostringstream hist;
-    for (const auto& h : d.history) {
-        std::string ts = h.timestamp.size() > 11 ? h.timestamp.substr(11, 12) : h.timestamp;
-        hist << "[GEN " << std::setw(4) << std::setfill('0') << h.generation << "] "
-             << ts << " | " << std::setw(10) << std::setfill(' ') << std::left << h.action
-             << " | " << (h.success ? "OK  " : "FAIL") << " | " << h.details << '\n';
+static const OpcodeNameTable& opcodeNames() {
+    static const OpcodeNameTable table;
+    return table;
+}
+
+// append `v` as exactly `digits` upper-case hex characters
+static inline void appendHex(std::string& out, uint32_t v, int digits) {
+    char tmp[8];
+    for (int i = digits - 1; i >= 0; --i) {
+        tmp[i] = kHexDigits[v & 0xF];
+        v >>= 4;
     }
+    out.append(tmp, digits);
+}
+
+// ── Sections ─────────────────────────────────────────────────────────────────
 
-    // ── Era name ──────────────────────────────────────────────────────────────
+void ReportWriter::appendHeader(const ExportData& d) {
+    m_buf += "WASM QUINE BOOTLOADER - SYSTEM HISTORY EXPORT\n";
+    m_buf += "Generated: ";
+    m_buf += nowIso();
+    m_buf += "\nFinal Generation: ";
+    appendInt(d.generation);
+    m_buf += '\n';
+}
 
-    // ── Assemble report ───────────────────────────────────────────────────────
-    std::ostringstream out;
-    out << "WASM QUINE BOOTLOADER - SYSTEM HISTORY EXPORT\n"
-        << "Generated: " << nowIso() << '\n'
-        << "Final Generation: " << d.generation << '\n'
-        << "Kernel Size: " << raw.size() << " bytes\n";
+void ReportWriter::appendMetrics(const ExportData& d) {
+    m_buf += "Kernel Size: ";
+    appendInt((long long)m_raw.size());
+    m_buf += " bytes\n";
     if (d.mutationsAttempted || d.mutationsApplied) {
-        out << "Mutations Attempted: " << d.mutationsAttempted << '\n'
-            << "Mutations Applied: " << d.mutationsApplied << '\n'
-            << "Mutation Breakdown: insert=" << d.mutationInsert
-            << ", delete=" << d.mutationDelete
-            << ", modify=" << d.mutationModify
-            << ", append=" << d.mutationAdd << "\n";
+        m_buf += "Mutations Attempted: ";  appendInt(d.mutationsAttempted);
+        m_buf += "\nMutations Applied: ";  appendInt(d.mutationsApplied);
+        m_buf += "\nMutation Breakdown: insert="; appendInt(d.mutationInsert);
+        m_buf += ", delete=";  appendInt(d.mutationDelete);
+        m_buf += ", modify=";  appendInt(d.mutationModify);
+        m_buf += ", append=";  appendInt(d.mutationAdd);
+        m_buf += '\n';
     }
     if (!d.trapCode.empty()) {
-        out << "Traps: " << d.trapCode << "\n";
+        m_buf += "Traps: ";
+        m_buf += d.trapCode;
+        m_buf += '\n';
     }
     if (d.genDurationMs > 0.0) {
-        out << "Gen Duration: " << d.genDurationMs << " ms\n";
+        char tmp[32];
+        int n = std::snprintf(tmp, sizeof(tmp), "%g", d.genDurationMs);
+        m_buf += "Gen Duration: ";
+        m_buf.append(tmp, n);
+        m_buf += " ms\n";
     }
     if (d.kernelSizeMin || d.kernelSizeMax) {
-        out << "Kernel Size Min/Max: " << d.kernelSizeMin
-            << "/" << d.kernelSizeMax << "\n";
+        m_buf += "Kernel Size Min/Max: "; appendInt(d.kernelSizeMin);
+        m_buf += '/';                     appendInt(d.kernelSizeMax);
+        m_buf += '\n';
     }
     if (d.heuristicBlacklistCount) {
-        out << "Heuristic Blacklist Entries: " << d.heuristicBlacklistCount << "\n";
+        m_buf += "Heuristic Blacklist Entries: ";
+        appendInt(d.heuristicBlacklistCount);
+        m_buf += '\n';
     }
     if (d.advisorEntryCount) {
-        out << "Advisor Entries: " << d.advisorEntryCount << "\n";
+        m_buf += "Advisor Entries: ";
+        appendInt(d.advisorEntryCount);
+        m_buf += '\n';
     }
     if (!d.instances.empty()) {
-        out << "INSTANCES: " << d.instances.size() << "\n";
+        m_buf += "INSTANCES: ";
+        appendInt((long long)d.instances.size());
+        m_buf += '\n';
         for (const auto& inst : d.instances) {
-            out << "  " << inst << "\n";
+            m_buf += "  ";
+            m_buf += inst;
+            m_buf += '\n';
+        }
+    }
+}
+
+void ReportWriter::appendOpcodeSequence() {
+    // opcodes come from the bytes decoded for the hex dump; the kernel is
+    // not decoded a second time
+    auto ops = extractCodeSectionOpcodes(m_raw);
+    for (uint8_t op : ops) {
+        appendInt(op);
+        m_buf += ' ';
+    }
+    m_buf += '\n';
+}
+
+void ReportWriter::appendHexDump() {
+    // one line per 16 bytes: "0xAAAA  HH HH ... HH  |ascii|\n", assembled
+    // in a stack buffer and appended in a single call
+    char line[96];
+    for (size_t i = 0; i < m_raw.size(); i += 16) {
+        char* p = line;
+        *p++ = '0';
+        *p++ = 'x';
+        uint32_t off = (uint32_t)i;
+        int digits = off > 0xFFFF ? 8 : 4;
+        for (int k = digits - 1; k >= 0; --k)
+            *p++ = kHexDigits[(off >> (k * 4)) & 0xF];
+        *p++ = ' ';
+        *p++ = ' ';
+        char ascii[16];
+        for (size_t j = 0; j < 16; j++) {
+            if (i + j < m_raw.size()) {
+                uint8_t b = m_raw[i + j];
+                *p++ = kHexDigits[b >> 4];
+                *p++ = kHexDigits[b & 0xF];
+                *p++ = ' ';
+                ascii[j] = (b >= 32 && b <= 126) ? (char)b : '.';
+            } else {
+                *p++ = ' ';
+                *p++ = ' ';
+                *p++ = ' ';
+                ascii[j] = ' ';
+            }
         }
+        *p++ = ' ';
+        *p++ = '|';
+        std::memcpy(p, ascii, sizeof(ascii));
+        p += sizeof(ascii);
+        *p++ = '|';
+        *p++ = '\n';
+        m_buf.append(line, (size_t)(p - line));
+        maybeDrain();
     }
-    // Note: exporter itself doesn't perform file I/O; caller should handle
-    // errors when writing the string.  This function now warns if decoded
-    // raw bytes are unexpectedly empty.
-    out << "\n"
-        << "CURRENT KERNEL (BASE64):\n"
-        << std::string(80, '-') << '\n'
-        << d.currentKernel << '\n'
-        << std::string(80, '-') << "\n\n"
-        // include decoded opcode sequence for models that want to consume it
-        << "OPCODE SEQUENCE:\n"
-        << std::string(80, '-') << '\n';
-    {
-        // replicate minimal sequence extraction: decode, parse code section
-        auto bytes = base64_decode(d.currentKernel);
-        auto instrs = extractCodeSection(bytes);
-        for (auto& inst : instrs) {
-            out << (int)inst.opcode << " ";
+}
+
+void ReportWriter::appendDisassembly(const ExportData& d) {
+    if (d.instructions.empty()) {
+        m_buf += "No instructions available.";
+        return;
+    }
+    const auto& names = opcodeNames();
+    for (int i = 0; i < (int)d.instructions.size(); i++) {
+        const auto& inst = d.instructions[i];
+        appendInt(i, 3, '0');
+        m_buf += " | 0x";
+        appendHex(m_buf, (uint32_t)inst.originalOffset, 4);
+        m_buf += " | ";
+        int nameLen = names.len[inst.opcode];
+        m_buf.append(names.name[inst.opcode], nameLen);
+        if (nameLen < 12) m_buf.append(12 - nameLen, ' ');
+        m_buf += ' ';
+        for (int ai = 0; ai < inst.argLen; ++ai) {
+            if (ai) m_buf += ' ';
+            m_buf += "0x";
+            appendHex(m_buf, inst.args[ai], 2);
         }
-        out << '\n';
-    }
-    out << std::string(80, '-') << "\n\n"
-        << "HEX DUMP:\n"
-        << std::string(80, '-') << '\n'
-        << hd.str()
-        << std::string(80, '-') << "\n\n"
-        << "DISASSEMBLY:\n"
-        << std::string(80, '-') << '\n'
-        << "IDX | ADDR   | OPCODE       ARGS\n"
-        << std::string(80, '-') << '\n'
-        << disasm
-        << std::string(80, '-') << "\n\n"
-        << "HISTORY LOG:\n"
-        << std::string(80, '-') << '\n'
-        << hist.str()
-        << std::string(80, '-') << '\n'
-        << "END OF REPORT\n";
-
-    return out.str();
+        m_buf += '\n';
+        maybeDrain();
+    }
+}
+
+void ReportWriter::appendHistory(Span<HistoryEntry> history) {
+    for (const auto& h : history) {
+        m_buf += "[GEN ";
+        appendInt(h.generation, 4, '0');
+        m_buf += "] ";
+        if (h.timestamp.size() > 11)
+            m_buf.append(h.timestamp, 11, 12);
+        else
+            m_buf += h.timestamp;
+        m_buf += " | ";
+        m_buf += h.action;
+        if (h.action.size() < 10) m_buf.append(10 - h.action.size(), ' ');
+        m_buf += " | ";
+        m_buf += h.success ? "OK  " : "FAIL";
+        m_buf += " | ";
+        m_buf += h.details;
+        m_buf += '\n';
+        maybeDrain();
+    }
+}
+
+// ── Driver ───────────────────────────────────────────────────────────────────
+
+void ReportWriter::render(const ExportData& d, TelemetryLevel level) {
+    m_buf.clear();
+    m_ioError = false;
+    if (level == TelemetryLevel::NONE) return;
+
+    appendHeader(d);
+    if (level == TelemetryLevel::BASIC) return;
+
+    base64_decode(d.currentKernel, m_raw);
+    if (m_raw.empty() && !d.currentKernel.empty()) {
+        std::cerr << "Exporter: decoded kernel is empty (input base64 length="
+                  << d.currentKernel.size() << ")\n";
+    }
+
+    appendMetrics(d);
+    m_buf += "\nCURRENT KERNEL (BASE64):\n";
+    appendRule();
+    m_buf += d.currentKernel;
+    m_buf += '\n';
+    appendRule();
+    // include decoded opcode sequence for models that want to consume it
+    m_buf += "\nOPCODE SEQUENCE:\n";
+    appendRule();
+    appendOpcodeSequence();
+    appendRule();
+    m_buf += "\nHEX DUMP:\n";
+    appendRule();
+    appendHexDump();
+    appendRule();
+    m_buf += "\nDISASSEMBLY:\n";
+    appendRule();
+    m_buf += "IDX | ADDR   | OPCODE       ARGS\n";
+    appendRule();
+    appendDisassembly(d);
+    appendRule();
+    m_buf += "\nHISTORY LOG:\n";
+    appendRule();
+    appendHistory(d.history);
+    appendRule();
+    m_buf += "END OF REPORT\n";
+}
+
+const std::string& ReportWriter::build(const ExportData& d, TelemetryLevel level) {
+    m_fd = -1;
+    render(d, level);
+    return m_buf;
+}
+
+bool ReportWriter::writeTo(int fd, const ExportData& d, TelemetryLevel level) {
+    if (fd < 0) return false;
+    m_fd = fd;
+    render(d, level);
+    bool ok = drain() && !m_ioError;
+    m_fd = -1;
+    return ok;
+}
+
+bool ReportWriter::appendHistoryTo(int fd, Span<HistoryEntry> history) {
+    if (fd < 0) return false;
+    m_fd = fd;
+    m_buf.clear();
+    m_ioError = false;
+    appendHistory(history);
+    bool ok = drain() && !m_ioError;
+    m_fd = -1;
+    return ok;
+}
+
+void ReportWriter::maybeDrain() {
+    if (m_fd >= 0 && m_buf.size() >= kFlushBytes)
+        drain();
+}
+
+bool ReportWriter::drain() {
+    if (m_fd < 0) return true;
+    const char* p = m_buf.data();
+    size_t left = m_buf.size();
+    while (left > 0) {
+        ssize_t n = ::write(m_fd, p, left);
+        if (n <= 0) {
+            m_ioError = true;
+            break;
+        }
+        p += n;
+        left -= (size_t)n;
+    }
+    m_buf.clear();
+    return !m_ioError;
+}
+
+std::string buildReport(const ExportData& d) {
+    // exporter itself doesn't perform file I/O; callers that write files
+    // should prefer ReportWriter::writeTo() and reuse the writer.
+    ReportWriter w;
+    return w.build(d, TelemetryLevel::FULL);
 }
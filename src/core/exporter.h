@@ -1,22 +1,49 @@
 #pragma once
 
 #include "types.h"
+#include "cli.h"  // TelemetryLevel
 #include "wasm/parser.h"
+#include <cstddef>
 #include <string>
+#include <string_view>
 #include <vector>
-#include <deque>
 
 // ── Exporter ──────────────────────────────────────────────────────────────────
 //
 // Produces a human-readable telemetry report from the current simulation state.
 // ─────────────────────────────────────────────────────────────────────────────
 
+// Read-only view over a contiguous array.  ExportData is rebuilt every
+// generation, so it borrows the caller's containers instead of copying them;
+// the viewed storage must outlive the report call.
+template <typename T>
+struct Span {
+    const T* ptr   = nullptr;
+    size_t   count = 0;
+
+    Span() = default;
+    Span(const T* p, size_t n) : ptr(p), count(n) {}
+    Span(const std::vector<T>& v) : ptr(v.data()), count(v.size()) {}
+
+    const T* begin() const { return ptr; }
+    const T* end()   const { return ptr + count; }
+    size_t   size()  const { return count; }
+    bool     empty() const { return count == 0; }
+    const T& operator[](size_t i) const { return ptr[i]; }
+
+    // entries from `offset` to the end (empty if offset is past the end)
+    Span subspan(size_t offset) const {
+        return offset >= count ? Span() : Span(ptr + offset, count - offset);
+    }
+};
+
 struct ExportData {
-    int                        generation;
-    std::string                currentKernel;   // base64
-    std::vector<Instruction>   instructions;
-    std::deque<LogEntry>       logs;
-    std::vector<HistoryEntry>  history;
+    int                        generation = 0;
+    std::string_view           currentKernel;   // base64
+    Span<Instruction>          instructions;
+    // history entries to render; App::autoExport() passes only the entries
+    // added since the previous export (see App::m_historyExported)
+    Span<HistoryEntry>         history;
 
     // telemetry metrics (optional)
     int mutationsAttempted = 0;
@@ -25,7 +52,7 @@ struct ExportData {
     int mutationDelete     = 0;
     int mutationModify     = 0;
     int mutationAdd        = 0;
-    std::string trapCode;
+    std::string_view trapCode;
     double genDurationMs   = 0.0;
     int kernelSizeMin      = 0;
     int kernelSizeMax      = 0;
@@ -35,7 +62,60 @@ struct ExportData {
 
     // if multi-instance support is active, the current set of base64
     // kernels that have been spawned and not yet killed.
-    std::vector<std::string> instances;
+    Span<std::string> instances;
+};
+
+// ── ReportWriter ──────────────────────────────────────────────────────────────
+//
+// Streaming report builder.  Sections are appended straight into an internal
+// buffer that keeps its capacity between calls, hex digits come from a lookup
+// table instead of iostream manipulators, and the kernel is base64-decoded
+// exactly once per report.  Only the sections required by the telemetry level
+// are generated:
+//   NONE  – nothing
+//   BASIC – header lines only (generation, timestamp)
+//   FULL  – header, metrics, kernel, opcode sequence, hex dump, disassembly,
+//           history log
+// ─────────────────────────────────────────────────────────────────────────────
+
+class ReportWriter {
+public:
+    // Render a report into the internal buffer and return it.  The reference
+    // stays valid until the next call.
+    const std::string& build(const ExportData& data,
+                             TelemetryLevel level = TelemetryLevel::FULL);
+
+    // Render a report and write it to an open file descriptor.  The buffer is
+    // drained whenever it grows past kFlushBytes so large kernels do not
+    // balloon memory.  Returns false if any write fails.
+    bool writeTo(int fd, const ExportData& data,
+                 TelemetryLevel level = TelemetryLevel::FULL);
+
+    // Append history lines (same format as the HISTORY LOG section) to an
+    // open file descriptor.  Used for the run's append-only history.log.
+    bool appendHistoryTo(int fd, Span<HistoryEntry> history);
+
+    static constexpr size_t kFlushBytes = 64 * 1024;
+
+private:
+    void render(const ExportData& d, TelemetryLevel level);
+    void appendHeader(const ExportData& d);
+    void appendMetrics(const ExportData& d);
+    void appendOpcodeSequence();
+    void appendHexDump();
+    void appendDisassembly(const ExportData& d);
+    void appendHistory(Span<HistoryEntry> history);
+    void appendRule();
+    void appendInt(long long v, int width = 0, char fill = ' ');
+
+    // drain the buffer to m_fd when streaming and it is large enough
+    void maybeDrain();
+    bool drain();
+
+    std::string          m_buf;
+    std::vector<uint8_t> m_raw;     // decoded kernel, reused between reports
+    int                  m_fd = -1; // destination while inside writeTo()
+    bool                 m_ioError = false;
 };
 
 // Build a full text report (hex dump, disassembly, history) from the given data.
@@ -3,26 +3,48 @@
 
 #include <SDL3/SDL.h>
 
+#include <algorithm>
 #include <csignal>
-#include <sstream>
-#include <iomanip>
+#include <cstdio>
+#include <cstring>
 #include <fcntl.h>
+#include <poll.h>
 #include <sys/file.h>
 #include <unistd.h>
 
 // ── Global pointer for signal/atexit handler ──────────────────────────────────
 static AppLogger* s_loggerInstance = nullptr;
+static std::atomic<int> s_wakeFd{-1};
 
+// Only write(2) here: the flush thread picks the byte up and drains the ring,
+// which keeps the handler async-signal-safe.
 static void flushSignalHandler(int /*sig*/) {
-    if (s_loggerInstance) s_loggerInstance->flush();
+    int fd = s_wakeFd.load(std::memory_order_relaxed);
+    if (fd >= 0) {
+        char b = 1;
+        ssize_t r = write(fd, &b, 1);
+        (void)r;
+    }
 }
 
 // ── Lifecycle ─────────────────────────────────────────────────────────────────
 
+AppLogger::AppLogger() : m_ring(new LogEntry[MAX_LOG_ENTRIES]) {}
+
 AppLogger::~AppLogger() {
+    if (m_flushThread.joinable()) {
+        m_stopping.store(true, std::memory_order_release);
+        wakeFlusher();
+        m_flushThread.join();
+    }
     flush();
     if (m_logFile.is_open()) m_logFile.close();
-    if (s_loggerInstance == this) s_loggerInstance = nullptr;
+    if (s_loggerInstance == this) {
+        s_wakeFd.store(-1, std::memory_order_relaxed);
+        s_loggerInstance = nullptr;
+    }
+    for (int fd : m_wakeFds)
+        if (fd >= 0) close(fd);
 }
 
 void AppLogger::init(const std::string& logFilePath) {
@@ -30,59 +52,180 @@ void AppLogger::init(const std::string& logFilePath) {
     m_logFile.open(logFilePath, std::ios::app);
     if (!m_logFile.is_open()) return;
 
-    m_fileLogging = true;
-    m_lastFlushMs = static_cast<uint64_t>(SDL_GetTicks());
+    // Write session header.
+    m_logFile << "=== Session started " << nowIso() << " ===\n";
+    m_logFile.flush();
+
+    m_flushBatch.reserve(MAX_LOG_ENTRIES);
+    m_flushText.reserve(64 * 1024);
+    m_fileLogging.store(true, std::memory_order_release);
+
+    if (pipe(m_wakeFds) == 0) {
+        for (int fd : m_wakeFds)
+            fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+        m_flushThread = std::thread(&AppLogger::flushThreadMain, this);
+    }
 
     // Register global pointer so signal/atexit handlers can reach us.
     s_loggerInstance = this;
+    s_wakeFd.store(m_wakeFds[1], std::memory_order_relaxed);
     std::signal(SIGINT,  flushSignalHandler);
     std::signal(SIGTERM, flushSignalHandler);
+}
 
-    // Write session header.
-    m_logFile << "=== Session started " << nowIso() << " ===\n";
-    m_logFile.flush();
+bool AppLogger::initMapped(const std::string& ringPath, size_t capacity) {
+    std::lock_guard<std::mutex> lock(m_ringMutex);
+    return m_mapped.open(ringPath, capacity);
 }
 
 // ── Logging ───────────────────────────────────────────────────────────────────
 
-void AppLogger::log(const std::string& msg, const std::string& type) {
+void AppLogger::log(std::string_view msg, LogType type) {
     uint64_t t = static_cast<uint64_t>(SDL_GetTicks());
-
-    // Deduplicate within 100 ms
-    if (!m_logs.empty()) {
-        const auto& last = m_logs.back();
-        if (last.message == msg && (t - last.timestamp) < 100)
-            return;
+    // an over-long message keeps its head (cut on a UTF-8 boundary) and
+    // ends in the truncation mark
+    constexpr std::string_view mark = LogEntry::TRUNCATED_MARK;
+    size_t keep = msg.size();
+    std::string_view tail;
+    if (msg.size() > LogEntry::MAX_MESSAGE) {
+        keep = LogEntry::MAX_MESSAGE - mark.size();
+        while (keep > 0 && ((unsigned char)msg[keep] & 0xC0) == 0x80) --keep;
+        tail = mark;
     }
+    const size_t n = keep + tail.size();
+    uint64_t id;
+    {
+        std::lock_guard<std::mutex> lock(m_ringMutex);
+        uint64_t last = m_lastId.load(std::memory_order_relaxed);
+
+        // Deduplicate within 100 ms
+        if (last) {
+            const LogEntry& prev = m_ring[(last - 1) % MAX_LOG_ENTRIES];
+            if (prev.length == n && (t - prev.timestamp) < 100 &&
+                std::memcmp(prev.text, msg.data(), keep) == 0 &&
+                std::memcmp(prev.text + keep, tail.data(), tail.size()) == 0)
+                return;
+        }
 
-    m_logs.push_back({ randomId(), t, msg, type });
-    if (m_logs.size() > MAX_LOG_ENTRIES)
-        m_logs.pop_front();
-
-    if (m_fileLogging) {
-        // Format: [<ms>] [TYPE] message
-        std::ostringstream ss;
-        ss << '[' << std::setw(10) << std::setfill('0') << t
-           << "] [" << type << "] " << msg;
-        m_pendingLines.push_back(ss.str());
-        maybeFlush(t);
+        id = last + 1;
+        LogEntry& e = m_ring[(id - 1) % MAX_LOG_ENTRIES];
+        e.id        = id;
+        e.timestamp = t;
+        e.type      = type;
+        e.length    = (uint16_t)n;
+        std::memcpy(e.text, msg.data(), keep);
+        std::memcpy(e.text + keep, tail.data(), tail.size());
+        e.text[n] = '\0';
+        m_mapped.write(e);
+        m_lastId.store(id, std::memory_order_release);
     }
+
+    // Kick the flusher early once half the ring is waiting, so a burst of
+    // messages between timed flushes is not overwritten before it is written.
+    if (m_fileLogging.load(std::memory_order_relaxed) &&
+        id - m_flushedId.load(std::memory_order_relaxed) == MAX_LOG_ENTRIES / 2)
+        wakeFlusher();
 }
 
 void AppLogger::addHistory(const HistoryEntry& entry) {
     m_history.push_back(entry);
 }
 
+// ── Snapshots ─────────────────────────────────────────────────────────────────
+
+void AppLogger::snapshot(std::vector<LogEntry>& out) const {
+    // nothing logged since the previous snapshot: no lock, no copy
+    uint64_t have = out.empty() ? 0 : out.back().id;
+    if (have == lastId()) return;
+
+    uint64_t first;
+    {
+        std::lock_guard<std::mutex> lock(m_ringMutex);
+        uint64_t last = m_lastId.load(std::memory_order_relaxed);
+        first = last > MAX_LOG_ENTRIES ? last - MAX_LOG_ENTRIES + 1 : 1;
+        // a snapshot the ring has lapped (or one from elsewhere) is
+        // rebuilt from scratch; otherwise only the new tail is copied
+        if (have > last || have + 1 < first) {
+            out.clear();
+            have = first - 1;
+        }
+        for (uint64_t id = have + 1; id <= last; ++id)
+            out.push_back(m_ring[(id - 1) % MAX_LOG_ENTRIES]);
+    }
+    // drop the entries overwritten since the last call, outside the lock
+    size_t stale = 0;
+    while (stale < out.size() && out[stale].id < first) ++stale;
+    out.erase(out.begin(), out.begin() + (std::ptrdiff_t)stale);
+}
+
+std::vector<LogEntry> AppLogger::logs() const {
+    std::vector<LogEntry> out;
+    out.reserve(size());
+    snapshot(out);
+    return out;
+}
+
+size_t AppLogger::size() const {
+    return (size_t)std::min<uint64_t>(lastId(), MAX_LOG_ENTRIES);
+}
+
 // ── Flush helpers ─────────────────────────────────────────────────────────────
 
-void AppLogger::maybeFlush(uint64_t nowMs) {
-    if (!m_fileLogging) return;
-    if (nowMs - m_lastFlushMs >= FLUSH_INTERVAL_MS)
+void AppLogger::wakeFlusher() {
+    if (m_wakeFds[1] < 0) return;
+    char b = 1;
+    ssize_t r = write(m_wakeFds[1], &b, 1);  // full pipe == already pending
+    (void)r;
+}
+
+void AppLogger::flushThreadMain() {
+    pollfd pfd{ m_wakeFds[0], POLLIN, 0 };
+    while (!m_stopping.load(std::memory_order_acquire)) {
+        int r = poll(&pfd, 1, (int)FLUSH_INTERVAL_MS);
+        if (r > 0) {
+            char buf[64];
+            while (read(m_wakeFds[0], buf, sizeof(buf)) > 0) {}
+        }
         flush();
+    }
 }
 
 void AppLogger::flush() {
-    if (!m_fileLogging || m_pendingLines.empty()) return;
+    if (!m_fileLogging.load(std::memory_order_acquire)) return;
+    std::lock_guard<std::mutex> lock(m_fileMutex);
+    drainLocked();
+}
+
+void AppLogger::drainLocked() {
+    uint64_t from = m_flushedId.load(std::memory_order_relaxed);
+    if (lastId() == from) return;
+
+    // Copy the unflushed tail out of the ring; formatting happens without
+    // holding m_ringMutex.
+    m_flushBatch.clear();
+    uint64_t dropped = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_ringMutex);
+        uint64_t last  = m_lastId.load(std::memory_order_relaxed);
+        uint64_t first = from + 1;
+        if (last - from > MAX_LOG_ENTRIES) {
+            dropped = last - from - MAX_LOG_ENTRIES;
+            first   = last - MAX_LOG_ENTRIES + 1;
+        }
+        for (uint64_t id = first; id <= last; ++id)
+            m_flushBatch.push_back(m_ring[(id - 1) % MAX_LOG_ENTRIES]);
+        m_flushedId.store(last, std::memory_order_relaxed);
+    }
+
+    m_flushText.clear();
+    if (dropped) {
+        char head[48];
+        int n = std::snprintf(head, sizeof(head), "[... %llu entries dropped ...]\n",
+                              (unsigned long long)dropped);
+        m_flushText.append(head, n);
+    }
+    for (const auto& e : m_flushBatch)
+        appendLogLine(m_flushText, e);
 
     // Attempt to obtain advisory lock on companion lockfile.  This prevents
     // interleaved writes when multiple processes share the same log path.
@@ -95,14 +238,23 @@ void AppLogger::flush() {
         }
     }
 
-    for (const auto& line : m_pendingLines)
-        m_logFile << line << '\n';
+    m_logFile.write(m_flushText.data(), (std::streamsize)m_flushText.size());
     m_logFile.flush();
-    m_pendingLines.clear();
-    m_lastFlushMs = static_cast<uint64_t>(SDL_GetTicks());
 
     if (lockfd >= 0) {
         flock(lockfd, LOCK_UN);
         close(lockfd);
     }
 }
+
+// ── Formatting ────────────────────────────────────────────────────────────────
+
+void appendLogLine(std::string& out, const LogEntry& e) {
+    // Format: [<ms>] [TYPE] message
+    char head[40];
+    int n = std::snprintf(head, sizeof(head), "[%010llu] [%s] ",
+                          (unsigned long long)e.timestamp, logTypeName(e.type));
+    out.append(head, n);
+    out.append(e.text, e.length);
+    out += '\n';
+}
@@ -1,8 +1,13 @@
 #pragma once
 
 #include "types.h"
+#include "log_ring.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <string>
-#include <deque>
+#include <string_view>
+#include <thread>
 #include <vector>
 #include <fstream>
 
@@ -10,11 +15,23 @@
 //
 // Manages the live log ring-buffer and the immutable history ledger.
 //
+// The ring holds the last MAX_LOG_ENTRIES entries in fixed 512-byte slots
+// allocated once at construction.  log() copies the message into the next
+// slot under a short critical section and never allocates, so it is cheap
+// enough for the per-generation hot path.  Every entry gets a monotonic id;
+// readers (the GUI log panel) take a consistent snapshot with snapshot().
+//
 // File logging (optional):
-//   Call init(path) once at startup.  Log entries are buffered in memory and
-//   flushed to disk at most once per FLUSH_INTERVAL_MS (default 1 000 ms).
-//   The buffer is always flushed unconditionally on destruction and on
+//   Call init(path) once at startup.  A background thread formats new ring
+//   entries and appends them to the file at most once per FLUSH_INTERVAL_MS
+//   (default 1 000 ms), or sooner when half the ring is unflushed.  The
+//   buffer is always flushed unconditionally on destruction and on
 //   SIGINT / SIGTERM so no entries are lost on crash or clean exit.
+//
+// Mapped ring (optional, `--log-ring`):
+//   Call initMapped(path) instead of init().  Every entry is also copied into
+//   a file-backed mmap ring (see log_ring.h), which survives SIGKILL and
+//   crashes with no flushing at all; decode it with the log_decode tool.
 // ─────────────────────────────────────────────────────────────────────────────
 
 class AppLogger {
@@ -22,35 +39,78 @@ public:
     static constexpr size_t   MAX_LOG_ENTRIES   = 1000;
     static constexpr uint64_t FLUSH_INTERVAL_MS = 1000;
 
+    AppLogger();
     ~AppLogger();
 
-    // Open a log file for buffered writes.  Safe to call before SDL_Init.
+    AppLogger(const AppLogger&) = delete;
+    AppLogger& operator=(const AppLogger&) = delete;
+
+    // Open a log file for buffered writes and start the flush thread.
+    // Safe to call before SDL_Init.
     void init(const std::string& logFilePath);
 
+    // Mirror every entry into a crash-persistent mmap ring at `ringPath`
+    // instead of a buffered text file.  No flush thread or signal handler is
+    // installed.  Returns false (and leaves the logger unchanged) if the ring
+    // cannot be created.
+    bool initMapped(const std::string& ringPath,
+                    size_t capacity = MappedLogRing::kDefaultCapacity);
+    bool isMapped() const { return m_mapped.isOpen(); }
+
     // Append a new log entry.  Entries are deduplicated within 100 ms.
-    // type: "info" | "success" | "warning" | "error" | "system" | "mutation"
-    void log(const std::string& msg, const std::string& type = "info");
+    // Safe to call from any thread; does not allocate.
+    void log(std::string_view msg, LogType type = LogType::INFO);
 
     // Append a permanent history record.
     void addHistory(const HistoryEntry& entry);
 
-    // Write all buffered lines to disk immediately.
+    // Write all unflushed entries to disk immediately (on the calling
+    // thread).
     void flush();
 
-    const std::deque<LogEntry>&      logs()    const { return m_logs; }
+    // Bring `out` up to date with the ring, oldest first.  `out` must be
+    // empty or the result of an earlier snapshot() of this logger: only
+    // entries logged since then are copied under the ring lock, and when
+    // nothing was logged the call returns without taking it.  A caller
+    // that keeps the vector around (the GUI log panel, every frame) does
+    // not allocate after the first call.
+    void snapshot(std::vector<LogEntry>& out) const;
+    // Convenience copy of the whole ring (tests, one-off readers).
+    std::vector<LogEntry> logs() const;
+
+    // number of entries currently held (<= MAX_LOG_ENTRIES)
+    size_t   size()   const;
+    // id of the newest entry, 0 when nothing has been logged
+    uint64_t lastId() const { return m_lastId.load(std::memory_order_acquire); }
+
     const std::vector<HistoryEntry>& history() const { return m_history; }
 
 private:
-    // Check elapsed time and flush if FLUSH_INTERVAL_MS has passed.
-    void maybeFlush(uint64_t nowMs);
+    // Write entries (m_flushedId, lastId] to the file.  Caller holds
+    // m_fileMutex.
+    void drainLocked();
+    void flushThreadMain();
+    void wakeFlusher();
+
+    std::unique_ptr<LogEntry[]> m_ring;       // MAX_LOG_ENTRIES slots
+    mutable std::mutex          m_ringMutex;  // guards m_ring
+    std::atomic<uint64_t>       m_lastId{0};
+    MappedLogRing               m_mapped;     // written under m_ringMutex
 
-    std::deque<LogEntry>      m_logs;
     std::vector<HistoryEntry> m_history;
 
     // ── File-logging state ────────────────────────────────────────────────────
+    std::mutex               m_fileMutex;      // one writer at a time
     std::ofstream            m_logFile;
     std::string              m_logFilePath;    // path used for locking
-    std::vector<std::string> m_pendingLines;
-    uint64_t                 m_lastFlushMs = 0;
-    bool                     m_fileLogging = false;
+    std::vector<LogEntry>    m_flushBatch;     // reused by drainLocked()
+    std::string              m_flushText;      // reused by drainLocked()
+    std::atomic<uint64_t>    m_flushedId{0};
+    std::atomic<bool>        m_fileLogging{false};
+    std::atomic<bool>        m_stopping{false};
+    std::thread              m_flushThread;
+    int                      m_wakeFds[2] = { -1, -1 };  // self-pipe
 };
+
+// Append `e` to `out` in the text log format: "[<ms>] [type] message\n".
+void appendLogLine(std::string& out, const LogEntry& e);
@@ -0,0 +1,113 @@
+#include "log_ring.h"
+#include "log.h"
+#include "util.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+static constexpr size_t kSlotsOffset = sizeof(LogEntry);
+
+// ── Writer ────────────────────────────────────────────────────────────────────
+
+bool MappedLogRing::open(const std::string& path, size_t capacity) {
+    close();
+    if (capacity == 0) return false;
+    int fd = ::open(path.c_str(), O_CREAT | O_TRUNC | O_RDWR, 0644);
+    if (fd < 0) return false;
+
+    size_t size = kSlotsOffset + capacity * sizeof(LogEntry);
+    void* mem = MAP_FAILED;
+    if (ftruncate(fd, (off_t)size) == 0)
+        mem = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);  // the mapping keeps the file referenced
+    if (mem == MAP_FAILED) return false;
+
+    // ftruncate zero-fills, so every slot starts out empty (id 0)
+    m_header = new (mem) LogRingHeader();
+    m_header->magic    = LogRingHeader::kMagic;
+    m_header->version  = LogRingHeader::kVersion;
+    m_header->slotSize = (uint32_t)sizeof(LogEntry);
+    m_header->capacity = (uint32_t)capacity;
+    std::string session = nowIso();
+    std::strncpy(m_header->session, session.c_str(), sizeof(m_header->session) - 1);
+    m_slots = reinterpret_cast<LogEntry*>(static_cast<char*>(mem) + kSlotsOffset);
+    m_size  = size;
+    return true;
+}
+
+void MappedLogRing::close() {
+    if (!m_header) return;
+    munmap(m_header, m_size);
+    m_header = nullptr;
+    m_slots  = nullptr;
+    m_size   = 0;
+}
+
+void MappedLogRing::write(const LogEntry& e) {
+    if (!m_header) return;
+    LogEntry& slot = m_slots[(e.id - 1) % m_header->capacity];
+    // invalidate, copy the payload, then publish the id
+    __atomic_store_n(&slot.id, (uint64_t)0, __ATOMIC_RELEASE);
+    slot.timestamp = e.timestamp;
+    slot.type      = e.type;
+    slot.length    = e.length;
+    std::memcpy(slot.text, e.text, (size_t)e.length + 1);
+    __atomic_store_n(&slot.id, e.id, __ATOMIC_RELEASE);
+    m_header->lastId.store(e.id, std::memory_order_release);
+}
+
+// ── Decoder ───────────────────────────────────────────────────────────────────
+
+bool decodeLogRing(const std::string& path, std::string& out) {
+    std::ifstream f(path, std::ios::binary);
+    if (!f) return false;
+    std::string raw((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+    if (raw.size() < kSlotsOffset) return false;
+
+    uint32_t magic, version, slotSize, capacity;
+    std::memcpy(&magic,    raw.data() + offsetof(LogRingHeader, magic),    4);
+    std::memcpy(&version,  raw.data() + offsetof(LogRingHeader, version),  4);
+    std::memcpy(&slotSize, raw.data() + offsetof(LogRingHeader, slotSize), 4);
+    std::memcpy(&capacity, raw.data() + offsetof(LogRingHeader, capacity), 4);
+    if (magic != LogRingHeader::kMagic || version != LogRingHeader::kVersion ||
+        slotSize != sizeof(LogEntry) || capacity == 0 ||
+        raw.size() < kSlotsOffset + (size_t)capacity * sizeof(LogEntry))
+        return false;
+
+    char session[sizeof(LogRingHeader::session) + 1] = {};
+    std::memcpy(session, raw.data() + offsetof(LogRingHeader, session),
+                sizeof(LogRingHeader::session));
+
+    // Collect the valid slots.  A slot is trusted only if its id maps back
+    // to its own index; empty and half-written slots have id 0.
+    std::vector<LogEntry> entries;
+    entries.reserve(capacity);
+    for (uint32_t i = 0; i < capacity; ++i) {
+        LogEntry e;
+        std::memcpy(&e, raw.data() + kSlotsOffset + (size_t)i * sizeof(LogEntry), sizeof(LogEntry));
+        if (e.id == 0 || (e.id - 1) % capacity != i) continue;
+        e.length = (uint16_t)std::min<size_t>(e.length, LogEntry::MAX_MESSAGE);
+        e.text[e.length] = '\0';
+        entries.push_back(e);
+    }
+    std::sort(entries.begin(), entries.end(),
+              [](const LogEntry& a, const LogEntry& b) { return a.id < b.id; });
+
+    out.clear();
+    out.reserve(entries.size() * 64 + 64);
+    out += "=== Session started ";
+    out += session;
+    out += " ===\n";
+    if (!entries.empty() && entries.front().id > 1) {
+        out += "[... " + std::to_string(entries.front().id - 1) +
+               " earlier entries overwritten ...]\n";
+    }
+    for (const auto& e : entries)
+        appendLogLine(out, e);
+    return true;
+}
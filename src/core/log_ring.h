@@ -0,0 +1,68 @@
+#pragma once
+
+#include "types.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// ── Mapped log ring ───────────────────────────────────────────────────────────
+//
+// Crash-persistent log backend.  Entries are copied straight into a
+// file-backed MAP_SHARED mapping, so they live in the kernel page cache the
+// moment log() returns and reach the file even if the process is killed
+// (SIGKILL, a wasm3 crash) without ever running a flush.
+//
+// File layout (host byte order):
+//   [0, 512)            LogRingHeader, zero padded
+//   [512 + i*512, ...)  slot i: a LogEntry, i = (id - 1) % capacity
+//
+// A slot's id is cleared before the entry is copied in and stored last, so a
+// slot caught mid-write reads as empty rather than torn.  decodeLogRing()
+// (and the log_decode tool) turns a ring file back into the text log format.
+// ─────────────────────────────────────────────────────────────────────────────
+
+struct LogRingHeader {
+    static constexpr uint32_t kMagic   = 0x4C425157; // "WQBL"
+    static constexpr uint32_t kVersion = 1;
+
+    uint32_t magic    = 0;
+    uint32_t version  = 0;
+    uint32_t slotSize = 0;   // sizeof(LogEntry)
+    uint32_t capacity = 0;   // slots
+    std::atomic<uint64_t> lastId{0};  // newest fully written id
+    char     session[40] = {};        // ISO time the ring was created
+};
+static_assert(sizeof(LogRingHeader) <= sizeof(LogEntry), "header must fit the first slot");
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "the mapped ring needs lock-free 64-bit atomics");
+
+class MappedLogRing {
+public:
+    static constexpr size_t kDefaultCapacity = 16384;  // 8 MiB file
+
+    MappedLogRing() = default;
+    ~MappedLogRing() { close(); }
+
+    MappedLogRing(const MappedLogRing&) = delete;
+    MappedLogRing& operator=(const MappedLogRing&) = delete;
+
+    // Create (or truncate) `path` and map it.  Returns false on failure.
+    bool open(const std::string& path, size_t capacity = kDefaultCapacity);
+    void close();
+    bool isOpen() const { return m_header != nullptr; }
+
+    // Copy `e` (e.id must be set) into its slot.  Single writer: the caller
+    // serialises calls (AppLogger holds its ring mutex).
+    void write(const LogEntry& e);
+
+private:
+    LogRingHeader* m_header = nullptr;
+    LogEntry*      m_slots  = nullptr;
+    size_t         m_size   = 0;
+};
+
+// Render a ring file in the text log format ("=== Session started ... ==="
+// followed by one "[<ms>] [type] message" line per entry, oldest first).
+// Returns false if the file is missing or not a log ring.
+bool decodeLogRing(const std::string& path, std::string& out);
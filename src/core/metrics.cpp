@@ -0,0 +1,155 @@
+#include "metrics.h"
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+
+// ── Histogram ────────────────────────────────────────────────────────────────
+
+static inline int log2Floor(uint64_t v) {
+    return 63 - __builtin_clzll(v);
+}
+
+int Histogram::bucketIndex(uint64_t ns) {
+    if (ns < (uint64_t)kSubBuckets) return (int)ns;
+    int e = log2Floor(ns);
+    if (e > kMaxExp) return kBuckets - 1;
+    int sub = (int)((ns >> (e - kSubBits)) & (kSubBuckets - 1));
+    return (e - kSubBits + 1) * kSubBuckets + sub;
+}
+
+uint64_t Histogram::bucketUpperNs(int index) {
+    if (index < kSubBuckets) return (uint64_t)index + 1;
+    int group = index / kSubBuckets;
+    int sub   = index % kSubBuckets;
+    int shift = group - 1;  // == exponent - kSubBits
+    uint64_t lower = (uint64_t)(kSubBuckets + sub) << shift;
+    return lower + (1ULL << shift);
+}
+
+void Histogram::observeNs(uint64_t ns) {
+    m_buckets[bucketIndex(ns)].fetch_add(1, std::memory_order_relaxed);
+    m_sumNs.fetch_add(ns, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t Histogram::countBelow(uint64_t ns) const {
+    uint64_t n = 0;
+    for (int i = 0; i < kBuckets && bucketUpperNs(i) <= ns; ++i)
+        n += m_buckets[i].load(std::memory_order_relaxed);
+    return n;
+}
+
+double Histogram::quantileSeconds(double q) const {
+    uint64_t total = count();
+    if (total == 0) return 0.0;
+    uint64_t target = (uint64_t)std::ceil(q * (double)total);
+    if (target == 0) target = 1;
+    uint64_t seen = 0;
+    for (int i = 0; i < kBuckets; ++i) {
+        seen += m_buckets[i].load(std::memory_order_relaxed);
+        if (seen >= target) return (double)bucketUpperNs(i) * 1e-9;
+    }
+    return (double)bucketUpperNs(kBuckets - 1) * 1e-9;
+}
+
+// ── Registry ─────────────────────────────────────────────────────────────────
+
+template <typename T>
+static T& findOrAdd(std::deque<T>& list, const std::string& name, const std::string& help) {
+    for (auto& e : list)
+        if (e.name == name) return e;
+    list.emplace_back(name, help);
+    return list.back();
+}
+
+Counter& MetricsRegistry::counter(const std::string& name, const std::string& help) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return findOrAdd(m_counters, name, help).metric;
+}
+
+Gauge& MetricsRegistry::gauge(const std::string& name, const std::string& help) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return findOrAdd(m_gauges, name, help).metric;
+}
+
+Histogram& MetricsRegistry::histogram(const std::string& name, const std::string& help) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return findOrAdd(m_histograms, name, help).metric;
+}
+
+static void appendHeader(std::string& out, const std::string& name,
+                         const std::string& help, const char* type) {
+    out += "# HELP "; out += name; out += ' '; out += help; out += '\n';
+    out += "# TYPE "; out += name; out += ' '; out += type; out += '\n';
+}
+
+static void appendNumber(std::string& out, double v) {
+    char tmp[32];
+    int n = std::snprintf(tmp, sizeof(tmp), "%.9g", v);
+    out.append(tmp, n);
+}
+
+// exported `le` boundaries: 2^kFirstLe .. 2^kLastLe ns (~1 µs .. ~69 s)
+static constexpr int kFirstLe = 10;
+static constexpr int kLastLe  = 36;
+
+std::string MetricsRegistry::renderPrometheus() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::string out;
+    out.reserve(4096);
+    for (const auto& e : m_counters) {
+        appendHeader(out, e.name, e.help, "counter");
+        out += e.name; out += ' ';
+        out += std::to_string(e.metric.value());
+        out += '\n';
+    }
+    for (const auto& e : m_gauges) {
+        appendHeader(out, e.name, e.help, "gauge");
+        out += e.name; out += ' ';
+        appendNumber(out, e.metric.value());
+        out += '\n';
+    }
+    for (const auto& e : m_histograms) {
+        appendHeader(out, e.name, e.help, "histogram");
+        // read the total first: concurrent observations can only make the
+        // bucket sums larger, and +Inf must not be below any bucket
+        uint64_t total = e.metric.count();
+        for (int k = kFirstLe; k <= kLastLe; ++k) {
+            uint64_t n = e.metric.countBelow(1ULL << k);
+            if (n > total) total = n;
+            out += e.name; out += "_bucket{le=\"";
+            appendNumber(out, (double)(1ULL << k) * 1e-9);
+            out += "\"} ";
+            out += std::to_string(n);
+            out += '\n';
+        }
+        out += e.name; out += "_bucket{le=\"+Inf\"} ";
+        out += std::to_string(total);
+        out += '\n';
+        out += e.name; out += "_sum ";
+        appendNumber(out, e.metric.sumSeconds());
+        out += '\n';
+        out += e.name; out += "_count ";
+        out += std::to_string(total);
+        out += '\n';
+    }
+    return out;
+}
+
+bool MetricsRegistry::writeTextfile(const std::string& path) const {
+    std::string text = renderPrometheus();
+    std::string tmp = path + ".tmp";
+    {
+        std::ofstream f(tmp, std::ios::binary | std::ios::trunc);
+        if (!f) return false;
+        f << text;
+        if (!f) return false;
+    }
+    return std::rename(tmp.c_str(), path.c_str()) == 0;
+}
+
+MetricsRegistry& metrics() {
+    static MetricsRegistry registry;
+    return registry;
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+
+// ── Metrics ───────────────────────────────────────────────────────────────────
+//
+// Lightweight process-wide metrics: atomic counters, gauges and log-linear
+// latency histograms.  Recording is a handful of relaxed atomic operations
+// and never allocates; registration (by name, idempotent) takes a mutex and
+// is meant to happen once, with callers keeping the returned reference.
+//
+// The registry renders the Prometheus text exposition format and can write
+// it atomically (temp file + rename) so node-exporter's textfile collector
+// can scrape it without any network service in the bootloader.
+// ─────────────────────────────────────────────────────────────────────────────
+
+class Counter {
+public:
+    void     inc(uint64_t n = 1) { m_value.fetch_add(n, std::memory_order_relaxed); }
+    uint64_t value() const       { return m_value.load(std::memory_order_relaxed); }
+private:
+    std::atomic<uint64_t> m_value{0};
+};
+
+class Gauge {
+public:
+    void   set(double v)   { m_value.store(v, std::memory_order_relaxed); }
+    double value() const   { return m_value.load(std::memory_order_relaxed); }
+private:
+    std::atomic<double> m_value{0.0};
+};
+
+// Latency histogram with kSubBuckets linear buckets per power of two
+// (HDR-style), recording nanoseconds.  Relative bucket error is at most
+// 1/kSubBuckets; values above 2^kMaxExp ns land in the last bucket.
+class Histogram {
+public:
+    static constexpr int kSubBits    = 3;
+    static constexpr int kSubBuckets = 1 << kSubBits;
+    static constexpr int kMaxExp     = 45;  // ~9.7 hours
+    static constexpr int kBuckets    = (kMaxExp - kSubBits + 1) * kSubBuckets + kSubBuckets;
+
+    void observeNs(uint64_t ns);
+    void observeSeconds(double s) { observeNs(s <= 0.0 ? 0 : (uint64_t)(s * 1e9)); }
+
+    uint64_t count() const { return m_count.load(std::memory_order_relaxed); }
+    double   sumSeconds() const { return (double)m_sumNs.load(std::memory_order_relaxed) * 1e-9; }
+    // number of observations < `ns` (exact when `ns` is a bucket boundary,
+    // e.g. any power of two)
+    uint64_t countBelow(uint64_t ns) const;
+    // approximate quantile in seconds (upper bound of the containing bucket)
+    double   quantileSeconds(double q) const;
+
+    static int      bucketIndex(uint64_t ns);
+    static uint64_t bucketUpperNs(int index);  // exclusive upper bound
+
+private:
+    std::array<std::atomic<uint64_t>, kBuckets> m_buckets{};
+    std::atomic<uint64_t> m_count{0};
+    std::atomic<uint64_t> m_sumNs{0};
+};
+
+// nanoseconds elapsed since `start` on the steady clock
+inline uint64_t nsSince(std::chrono::steady_clock::time_point start) {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+// Records the lifetime of the scope into a histogram.
+class ScopedTimer {
+public:
+    explicit ScopedTimer(Histogram& h)
+        : m_hist(h), m_start(std::chrono::steady_clock::now()) {}
+    ~ScopedTimer() { m_hist.observeNs(nsSince(m_start)); }
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+private:
+    Histogram& m_hist;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+class MetricsRegistry {
+public:
+    // Look up or create a metric.  Names should follow Prometheus
+    // conventions (snake_case, `_total` for counters, `_seconds` for
+    // histograms).  References stay valid for the registry's lifetime.
+    Counter&   counter(const std::string& name, const std::string& help);
+    Gauge&     gauge(const std::string& name, const std::string& help);
+    Histogram& histogram(const std::string& name, const std::string& help);
+
+    // Prometheus text exposition format (version 0.0.4).  Histogram buckets
+    // are emitted at power-of-two boundaries from ~1 µs to ~69 s.
+    std::string renderPrometheus() const;
+
+    // Write renderPrometheus() to `path` via `path.tmp` + rename so a
+    // scraper never sees a partial file.  Returns false on I/O failure.
+    bool writeTextfile(const std::string& path) const;
+
+private:
+    template <typename T>
+    struct Entry {
+        std::string name;
+        std::string help;
+        T           metric;
+        Entry(const std::string& n, const std::string& h) : name(n), help(h) {}
+    };
+
+    mutable std::mutex           m_mutex;
+    std::deque<Entry<Counter>>   m_counters;   // deque: stable addresses
+    std::deque<Entry<Gauge>>     m_gauges;
+    std::deque<Entry<Histogram>> m_histograms;
+};
+
+// The process-wide registry (App instruments the evolution loop, main.cpp
+// the GUI frame time).
+MetricsRegistry& metrics();
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+// ── SpscQueue ─────────────────────────────────────────────────────────────────
+//
+// Bounded lock-free queue for exactly one producer thread and one consumer
+// thread.  The ring has a power-of-two number of slots allocated once at
+// construction; tryPush()/tryPop() never block and never allocate (element
+// moves aside).  head/tail are free-running counters on separate cache
+// lines, each written by only one side:
+//
+//   producer: writes slot[tail], then publishes tail (release)
+//   consumer: reads slot[head] after acquiring tail, then publishes head
+// ─────────────────────────────────────────────────────────────────────────────
+
+template <typename T>
+class SpscQueue {
+public:
+    // capacity is rounded up to a power of two (minimum 2)
+    explicit SpscQueue(size_t capacity) {
+        size_t n = 2;
+        while (n < capacity) n <<= 1;
+        m_mask  = n - 1;
+        m_slots.reset(new T[n]);
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // Producer side.  Returns false (leaving `v` untouched) when full.
+    bool tryPush(T&& v) {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_headCache == m_mask + 1) {
+            m_headCache = m_head.load(std::memory_order_acquire);
+            if (tail - m_headCache == m_mask + 1) return false;
+        }
+        m_slots[tail & m_mask] = std::move(v);
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side.  Returns false when empty.
+    bool tryPop(T& out) {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tailCache) {
+            m_tailCache = m_tail.load(std::memory_order_acquire);
+            if (head == m_tailCache) return false;
+        }
+        out = std::move(m_slots[head & m_mask]);
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // approximate when called concurrently with push/pop
+    size_t size() const {
+        return m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire);
+    }
+    size_t capacity() const { return m_mask + 1; }
+
+private:
+    std::unique_ptr<T[]> m_slots;
+    size_t m_mask = 0;
+
+    alignas(64) std::atomic<size_t> m_head{0};   // written by the consumer
+    size_t m_tailCache = 0;                      // consumer's view of m_tail
+    alignas(64) std::atomic<size_t> m_tail{0};   // written by the producer
+    size_t m_headCache = 0;                      // producer's view of m_head
+};
@@ -0,0 +1,273 @@
+#include "telemetry_stream.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+void setTrapCode(GenerationEvent& ev, const std::string& s) {
+    size_t n = s.size() < sizeof(ev.trapCode) - 1 ? s.size() : sizeof(ev.trapCode) - 1;
+    std::memcpy(ev.trapCode, s.data(), n);
+    ev.trapCode[n] = '\0';
+}
+
+std::string defaultStreamSocketPath(const std::string& name) {
+    const char* dir = std::getenv("XDG_RUNTIME_DIR");
+    std::string base = (dir && *dir) ? dir : "/tmp";
+    return base + "/" + name + ".sock";
+}
+
+#ifndef _WIN32
+
+static const char kUnixPrefix[] = "unix:";
+
+static bool isUnixSpec(const std::string& spec) {
+    return spec.rfind(kUnixPrefix, 0) == 0;
+}
+
+static std::string shmPath(const std::string& name) {
+    return name.empty() || name[0] != '/' ? "/" + name : name;
+}
+
+// ring size rounded up to a power of two so slot indexing is a mask
+static size_t roundCapacity(size_t n) {
+    size_t c = 2;
+    while (c < n) c <<= 1;
+    return c;
+}
+
+static uint64_t monotonicUs() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)ts.tv_nsec / 1000ULL;
+}
+
+static bool makeSockAddr(const std::string& path, sockaddr_un& addr) {
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(addr.sun_path)) return false;
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+    return true;
+}
+
+// ── TelemetryPublisher ───────────────────────────────────────────────────────
+
+TelemetryPublisher::~TelemetryPublisher() { close(); }
+
+bool TelemetryPublisher::open(const std::string& spec, size_t capacity) {
+    if (isUnixSpec(spec))
+        return openSocket(spec.substr(sizeof(kUnixPrefix) - 1));
+    if (openShm(spec, capacity)) return true;
+    return openSocket(defaultStreamSocketPath(spec));
+}
+
+bool TelemetryPublisher::openShm(const std::string& name, size_t capacity) {
+    close();
+    std::string path = shmPath(name);
+    // a segment left behind by a crashed run would carry stale indices
+    shm_unlink(path.c_str());
+    int fd = shm_open(path.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) return false;
+
+    size_t cap  = roundCapacity(capacity);
+    size_t size = sizeof(StreamRingHeader) + cap * sizeof(GenerationEvent);
+    void* mem = MAP_FAILED;
+    if (ftruncate(fd, (off_t)size) == 0)
+        mem = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mem == MAP_FAILED) {
+        shm_unlink(path.c_str());
+        return false;
+    }
+
+    m_ring = new (mem) StreamRingHeader();
+    m_ring->version   = StreamRingHeader::kVersion;
+    m_ring->capacity  = (uint32_t)cap;
+    m_ring->eventSize = (uint32_t)sizeof(GenerationEvent);
+    m_slots   = reinterpret_cast<GenerationEvent*>(m_ring + 1);
+    m_mapSize = size;
+    m_shmName = path;
+    // publish the magic last so a subscriber never sees a half-built header
+    std::atomic_thread_fence(std::memory_order_release);
+    m_ring->magic = StreamRingHeader::kMagic;
+    m_transport = StreamTransport::SHM;
+    return true;
+}
+
+bool TelemetryPublisher::openSocket(const std::string& path) {
+    close();
+    sockaddr_un addr;
+    if (!makeSockAddr(path, addr)) return false;
+    m_sock = ::socket(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (m_sock < 0) return false;
+    m_sockPath  = path;
+    m_transport = StreamTransport::SOCKET;
+    return true;
+}
+
+void TelemetryPublisher::close() {
+    if (m_ring) {
+        munmap(m_ring, m_mapSize);
+        shm_unlink(m_shmName.c_str());
+        m_ring  = nullptr;
+        m_slots = nullptr;
+        m_shmName.clear();
+    }
+    if (m_sock >= 0) {
+        ::close(m_sock);
+        m_sock = -1;
+        m_sockPath.clear();
+    }
+    m_transport = StreamTransport::NONE;
+}
+
+bool TelemetryPublisher::publish(GenerationEvent ev) {
+    if (m_transport == StreamTransport::NONE) return false;
+    ev.seq         = ++m_seq;
+    ev.timestampUs = monotonicUs();
+
+    if (m_transport == StreamTransport::SHM) {
+        uint64_t head = m_ring->head.load(std::memory_order_relaxed);
+        uint64_t tail = m_ring->tail.load(std::memory_order_acquire);
+        if (head - tail >= m_ring->capacity) {
+            m_ring->dropped.fetch_add(1, std::memory_order_relaxed);
+            ++m_dropped;
+            return false;
+        }
+        m_slots[head & (m_ring->capacity - 1)] = ev;
+        m_ring->head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    sockaddr_un addr;
+    makeSockAddr(m_sockPath, addr);
+    ssize_t n = ::sendto(m_sock, &ev, sizeof(ev), MSG_DONTWAIT,
+                         reinterpret_cast<const sockaddr*>(&addr), sizeof(addr));
+    if (n != (ssize_t)sizeof(ev)) {
+        ++m_dropped;
+        return false;
+    }
+    return true;
+}
+
+// ── TelemetrySubscriber ──────────────────────────────────────────────────────
+
+TelemetrySubscriber::~TelemetrySubscriber() { close(); }
+
+bool TelemetrySubscriber::open(const std::string& spec) {
+    if (isUnixSpec(spec))
+        return openSocket(spec.substr(sizeof(kUnixPrefix) - 1));
+    if (openShm(spec)) return true;
+    return openSocket(defaultStreamSocketPath(spec));
+}
+
+bool TelemetrySubscriber::openShm(const std::string& name) {
+    close();
+    int fd = shm_open(shmPath(name).c_str(), O_RDWR, 0);
+    if (fd < 0) return false;
+    struct stat st;
+    void* mem = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && (size_t)st.st_size >= sizeof(StreamRingHeader))
+        mem = mmap(nullptr, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mem == MAP_FAILED) return false;
+
+    auto* ring = static_cast<StreamRingHeader*>(mem);
+    size_t need = sizeof(StreamRingHeader) + (size_t)ring->capacity * sizeof(GenerationEvent);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (ring->magic != StreamRingHeader::kMagic ||
+        ring->version != StreamRingHeader::kVersion ||
+        ring->eventSize != sizeof(GenerationEvent) ||
+        (size_t)st.st_size < need) {
+        munmap(mem, (size_t)st.st_size);
+        return false;
+    }
+    m_ring    = ring;
+    m_slots   = reinterpret_cast<GenerationEvent*>(ring + 1);
+    m_mapSize = (size_t)st.st_size;
+    // skip whatever queued up before we attached; monitors want live data
+    m_ring->tail.store(m_ring->head.load(std::memory_order_acquire),
+                       std::memory_order_release);
+    m_transport = StreamTransport::SHM;
+    return true;
+}
+
+bool TelemetrySubscriber::openSocket(const std::string& path) {
+    close();
+    sockaddr_un addr;
+    if (!makeSockAddr(path, addr)) return false;
+    m_sock = ::socket(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (m_sock < 0) return false;
+    ::unlink(path.c_str());
+    if (::bind(m_sock, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0) {
+        ::close(m_sock);
+        m_sock = -1;
+        return false;
+    }
+    m_sockPath  = path;
+    m_transport = StreamTransport::SOCKET;
+    return true;
+}
+
+void TelemetrySubscriber::close() {
+    if (m_ring) {
+        munmap(m_ring, m_mapSize);
+        m_ring  = nullptr;
+        m_slots = nullptr;
+    }
+    if (m_sock >= 0) {
+        ::close(m_sock);
+        ::unlink(m_sockPath.c_str());
+        m_sock = -1;
+        m_sockPath.clear();
+    }
+    m_transport = StreamTransport::NONE;
+}
+
+bool TelemetrySubscriber::poll(GenerationEvent& out) {
+    if (m_transport == StreamTransport::SHM) {
+        uint64_t tail = m_ring->tail.load(std::memory_order_relaxed);
+        uint64_t head = m_ring->head.load(std::memory_order_acquire);
+        if (tail == head) return false;
+        out = m_slots[tail & (m_ring->capacity - 1)];
+        m_ring->tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+    if (m_transport == StreamTransport::SOCKET) {
+        ssize_t n = ::recv(m_sock, &out, sizeof(out), MSG_DONTWAIT);
+        return n == (ssize_t)sizeof(out);
+    }
+    return false;
+}
+
+uint64_t TelemetrySubscriber::dropped() const {
+    return m_ring ? m_ring->dropped.load(std::memory_order_relaxed) : 0;
+}
+
+#else  // _WIN32: no shm/Unix-socket transport; the stream stays closed
+
+TelemetryPublisher::~TelemetryPublisher() = default;
+bool TelemetryPublisher::open(const std::string&, size_t) { return false; }
+bool TelemetryPublisher::openShm(const std::string&, size_t) { return false; }
+bool TelemetryPublisher::openSocket(const std::string&) { return false; }
+void TelemetryPublisher::close() {}
+bool TelemetryPublisher::publish(GenerationEvent) { return false; }
+
+TelemetrySubscriber::~TelemetrySubscriber() = default;
+bool TelemetrySubscriber::open(const std::string&) { return false; }
+bool TelemetrySubscriber::openShm(const std::string&) { return false; }
+bool TelemetrySubscriber::openSocket(const std::string&) { return false; }
+void TelemetrySubscriber::close() {}
+bool TelemetrySubscriber::poll(GenerationEvent&) { return false; }
+uint64_t TelemetrySubscriber::dropped() const { return 0; }
+
+#endif
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// ── Live telemetry stream ─────────────────────────────────────────────────────
+//
+// Optional publisher that pushes fixed-size binary events to an external
+// monitor while a run is in progress, so tools no longer need to poll
+// bin/seq/<runId> for new report files.
+//
+// Transport:
+//   shared memory – a POSIX shm segment "/<name>" holding a single-producer /
+//                   single-consumer ring of GenerationEvent slots.  The
+//                   publisher never blocks: when the ring is full the event
+//                   is dropped and counted in the header.
+//   Unix socket   – fallback when shm is unavailable (or forced with a
+//                   "unix:<path>" spec).  Each event is one SOCK_DGRAM
+//                   datagram sent non-blocking; without a listener the
+//                   event is dropped.
+//
+// A stream spec is either a plain name ("wqb"), which tries shm first and
+// falls back to the socket at defaultStreamSocketPath(name), or
+// "unix:<path>" for the socket transport only.  See src/tools/telemetry_tail
+// for a reference consumer.
+// ─────────────────────────────────────────────────────────────────────────────
+
+enum class StreamEventKind : uint32_t {
+    GENERATION = 1,  // end of a generation (doReboot)
+    STATE      = 2,  // FSM transition (fromState -> toState)
+};
+
+// One wire/ring record.  Plain data, fixed 64-byte layout, host byte order.
+struct GenerationEvent {
+    uint64_t seq         = 0;  // assigned by the publisher, starts at 1
+    uint64_t timestampUs = 0;  // CLOCK_MONOTONIC microseconds
+    uint32_t kind        = 0;  // StreamEventKind
+    int32_t  generation  = 0;
+    uint8_t  fromState   = 0;  // SystemState values
+    uint8_t  toState     = 0;
+    int8_t   action      = -1; // EvolutionAction of the last mutation, -1 none
+    uint8_t  reserved    = 0;
+    uint32_t kernelSize  = 0;  // bytes
+    float    durationMs  = 0.f;
+    float    loss        = 0.f;
+    char     trapCode[24] = {}; // truncated, NUL-terminated
+};
+static_assert(sizeof(GenerationEvent) == 64, "GenerationEvent must stay 64 bytes");
+
+// copy `s` into the fixed trap code field (truncating)
+void setTrapCode(GenerationEvent& ev, const std::string& s);
+
+// Shared-memory ring header; the slots follow it in the same mapping.
+struct StreamRingHeader {
+    static constexpr uint32_t kMagic   = 0x57514253; // "WQBS"
+    static constexpr uint32_t kVersion = 1;
+
+    uint32_t magic     = 0;
+    uint32_t version   = 0;
+    uint32_t capacity  = 0;  // slots, power of two
+    uint32_t eventSize = 0;
+    std::atomic<uint64_t> dropped{0};
+    alignas(64) std::atomic<uint64_t> head{0};  // next slot to write (publisher)
+    alignas(64) std::atomic<uint64_t> tail{0};  // next slot to read (subscriber)
+};
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "the shm ring needs lock-free 64-bit atomics");
+
+// $XDG_RUNTIME_DIR/<name>.sock, or /tmp/<name>.sock when unset
+std::string defaultStreamSocketPath(const std::string& name);
+
+enum class StreamTransport { NONE, SHM, SOCKET };
+
+class TelemetryPublisher {
+public:
+    static constexpr size_t kDefaultCapacity = 1024;
+
+    TelemetryPublisher() = default;
+    ~TelemetryPublisher();
+    TelemetryPublisher(const TelemetryPublisher&) = delete;
+    TelemetryPublisher& operator=(const TelemetryPublisher&) = delete;
+
+    // Open according to a stream spec (see above).  Returns false when no
+    // transport could be set up; publish() is then a no-op.
+    bool open(const std::string& spec, size_t capacity = kDefaultCapacity);
+    bool openShm(const std::string& name, size_t capacity = kDefaultCapacity);
+    bool openSocket(const std::string& path);
+    void close();
+
+    // Stamp seq/timestamp and push the event.  Never blocks; returns false
+    // if the event was dropped (ring full, no listener, or not open).
+    bool publish(GenerationEvent ev);
+
+    StreamTransport transport() const { return m_transport; }
+    bool     isOpen()    const { return m_transport != StreamTransport::NONE; }
+    uint64_t published() const { return m_seq; }
+    uint64_t dropped()   const { return m_dropped; }
+
+private:
+    StreamTransport   m_transport = StreamTransport::NONE;
+    StreamRingHeader* m_ring     = nullptr;
+    GenerationEvent*  m_slots    = nullptr;
+    size_t            m_mapSize  = 0;
+    std::string       m_shmName;
+    int               m_sock     = -1;
+    std::string       m_sockPath;
+    uint64_t          m_seq      = 0;
+    uint64_t          m_dropped  = 0;
+};
+
+class TelemetrySubscriber {
+public:
+    TelemetrySubscriber() = default;
+    ~TelemetrySubscriber();
+    TelemetrySubscriber(const TelemetrySubscriber&) = delete;
+    TelemetrySubscriber& operator=(const TelemetrySubscriber&) = delete;
+
+    // Attach to a stream spec.  A plain name attaches to the shm ring if a
+    // publisher has created it, otherwise binds the fallback socket.
+    bool open(const std::string& spec);
+    // Attach to an existing ring; reading starts at the live head.
+    bool openShm(const std::string& name);
+    // Bind a datagram socket at `path` (replacing a stale one).
+    bool openSocket(const std::string& path);
+    void close();
+
+    // Non-blocking read of the next event.
+    bool poll(GenerationEvent& out);
+
+    StreamTransport transport() const { return m_transport; }
+    // events the publisher dropped because the ring was full (shm only)
+    uint64_t dropped() const;
+
+private:
+    StreamTransport   m_transport = StreamTransport::NONE;
+    StreamRingHeader* m_ring    = nullptr;
+    GenerationEvent*  m_slots   = nullptr;
+    size_t            m_mapSize = 0;
+    int               m_sock    = -1;
+    std::string       m_sockPath;
+};
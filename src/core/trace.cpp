@@ -0,0 +1,130 @@
+#include "trace.h"
+
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+
+namespace trace {
+
+namespace detail {
+std::atomic<bool> g_enabled{false};
+}
+
+namespace {
+
+constexpr size_t kFlushBytes = 64 * 1024;
+
+std::mutex   g_mutex;
+std::FILE*   g_file = nullptr;
+std::string  g_buf;
+bool         g_first = true;   // no comma before the first event
+uint64_t     g_originNs = 0;   // timestamps are relative to start()
+std::atomic<int> g_nextTid{1};
+
+int currentTid() {
+    static thread_local int tid = g_nextTid.fetch_add(1, std::memory_order_relaxed);
+    return tid;
+}
+
+void appendEscaped(std::string& out, const char* s) {
+    for (; *s; ++s) {
+        char c = *s;
+        if (c == '"' || c == '\\') out += '\\';
+        if ((unsigned char)c < 0x20) c = ' ';
+        out += c;
+    }
+}
+
+void appendMicros(std::string& out, uint64_t ns) {
+    char tmp[32];
+    int n = std::snprintf(tmp, sizeof(tmp), "%llu.%03u",
+                          (unsigned long long)(ns / 1000), (unsigned)(ns % 1000));
+    out.append(tmp, n);
+}
+
+// caller holds g_mutex
+void beginEvent() {
+    g_buf += g_first ? "\n" : ",\n";
+    g_first = false;
+}
+
+// caller holds g_mutex
+void flushLocked() {
+    if (g_file && !g_buf.empty()) {
+        std::fwrite(g_buf.data(), 1, g_buf.size(), g_file);
+        g_buf.clear();
+    }
+}
+
+} // namespace
+
+uint64_t nowNs() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool start(const std::string& path) {
+    stop();
+    std::lock_guard<std::mutex> lock(g_mutex);
+    g_file = std::fopen(path.c_str(), "wb");
+    if (!g_file) return false;
+    g_buf.clear();
+    g_buf.reserve(kFlushBytes * 2);
+    g_buf += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    g_first    = true;
+    g_originNs = nowNs();
+    detail::g_enabled.store(true, std::memory_order_relaxed);
+    return true;
+}
+
+void stop() {
+    detail::g_enabled.store(false, std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(g_mutex);
+    if (!g_file) return;
+    g_buf += "\n]}\n";
+    flushLocked();
+    std::fclose(g_file);
+    g_file = nullptr;
+}
+
+void complete(const char* name, const char* cat,
+              uint64_t startNs, uint64_t durNs, int tid) {
+    if (!enabled()) return;
+    if (tid < 0) tid = currentTid();
+    std::lock_guard<std::mutex> lock(g_mutex);
+    if (!g_file) return;
+    uint64_t rel = startNs > g_originNs ? startNs - g_originNs : 0;
+    beginEvent();
+    g_buf += "{\"name\":\"";
+    appendEscaped(g_buf, name);
+    g_buf += "\",\"cat\":\"";
+    appendEscaped(g_buf, cat);
+    g_buf += "\",\"ph\":\"X\",\"pid\":1,\"tid\":";
+    g_buf += std::to_string(tid);
+    g_buf += ",\"ts\":";
+    appendMicros(g_buf, rel);
+    g_buf += ",\"dur\":";
+    appendMicros(g_buf, durNs);
+    g_buf += '}';
+    if (g_buf.size() >= kFlushBytes) flushLocked();
+}
+
+void complete(const std::string& name, const char* cat,
+              uint64_t startNs, uint64_t durNs, int tid) {
+    complete(name.c_str(), cat, startNs, durNs, tid);
+}
+
+void setThreadName(const char* name, int tid) {
+    if (!enabled()) return;
+    if (tid < 0) tid = currentTid();
+    std::lock_guard<std::mutex> lock(g_mutex);
+    if (!g_file) return;
+    beginEvent();
+    g_buf += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":";
+    g_buf += std::to_string(tid);
+    g_buf += ",\"args\":{\"name\":\"";
+    appendEscaped(g_buf, name);
+    g_buf += "\"}}";
+}
+
+} // namespace trace
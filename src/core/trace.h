@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// ── Trace ─────────────────────────────────────────────────────────────────────
+//
+// Scoped trace spans written as Chrome trace-event JSON (load the file in
+// chrome://tracing or ui.perfetto.dev).  Tracing is off unless trace::start()
+// is called (`--trace <file>`); a disabled TRACE_SCOPE costs one relaxed
+// atomic load.
+//
+// Spans are emitted as complete ("X") events on the calling thread's track.
+// Each thread gets a small id the first time it records; setThreadName()
+// labels the track.  Virtual tracks (e.g. kFsmTrack for BootFsm state
+// slices) can be targeted explicitly through trace::complete().
+//
+// Events are buffered and appended to the file in blocks; the closing
+// brackets are written by stop().  A trace cut short by a crash is still
+// accepted by both viewers.
+// ─────────────────────────────────────────────────────────────────────────────
+
+namespace trace {
+
+// track id used for BootFsm state slices
+static constexpr int kFsmTrack = 1000;
+
+namespace detail {
+extern std::atomic<bool> g_enabled;
+}
+
+inline bool enabled() { return detail::g_enabled.load(std::memory_order_relaxed); }
+
+// Begin writing to `path`; returns false if the file cannot be created.
+bool start(const std::string& path);
+// Flush buffered events and close the JSON document.
+void stop();
+
+// steady-clock nanoseconds
+uint64_t nowNs();
+
+// Record a finished span.  `tid` < 0 means the calling thread's track.
+void complete(const char* name, const char* cat,
+              uint64_t startNs, uint64_t durNs, int tid = -1);
+void complete(const std::string& name, const char* cat,
+              uint64_t startNs, uint64_t durNs, int tid = -1);
+
+// Label the calling thread's track (or `tid` when given).
+void setThreadName(const char* name, int tid = -1);
+
+} // namespace trace
+
+// RAII span on the current thread.  `name` and `cat` must outlive the scope
+// (string literals).  next() closes the current span and opens a sibling,
+// which lets straight-line code mark consecutive phases without extra
+// braces.
+class TraceScope {
+public:
+    explicit TraceScope(const char* name, const char* cat = "app")
+        : m_name(name), m_cat(cat),
+          m_start(trace::enabled() ? trace::nowNs() : 0) {}
+    ~TraceScope() { end(); }
+
+    void next(const char* name) {
+        end();
+        m_name  = name;
+        m_start = trace::enabled() ? trace::nowNs() : 0;
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    void end() {
+        if (m_start) {
+            trace::complete(m_name, m_cat, m_start, trace::nowNs() - m_start);
+            m_start = 0;
+        }
+    }
+
+    const char* m_name;
+    const char* m_cat;
+    uint64_t    m_start;  // 0 when tracing was off at scope entry
+};
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b)  TRACE_CONCAT_(a, b)
+#define TRACE_SCOPE(...)    TraceScope TRACE_CONCAT(traceScope_, __LINE__)(__VA_ARGS__)
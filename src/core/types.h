@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <cstdint>
 
 enum class SystemState {
@@ -22,13 +23,51 @@ enum class TrainingPhase {
 
 
 
+// Severity / category of a log line.  Drives the colour in the log panel and
+// the `[tag]` written to the log file (see logTypeName()).
+enum class LogType : uint8_t {
+    INFO,
+    SUCCESS,
+    WARNING,
+    ERROR,
+    SYSTEM,
+    MUTATION,
+    DEBUG,
+    EXPORT,
+    TRAIN,
+};
+
+inline const char* logTypeName(LogType t) {
+    switch (t) {
+        case LogType::INFO:     return "info";
+        case LogType::SUCCESS:  return "success";
+        case LogType::WARNING:  return "warning";
+        case LogType::ERROR:    return "error";
+        case LogType::SYSTEM:   return "system";
+        case LogType::MUTATION: return "mutation";
+        case LogType::DEBUG:    return "debug";
+        case LogType::EXPORT:   return "export";
+        case LogType::TRAIN:    return "train";
+    }
+    return "info";
+}
+
+// Fixed-size so the logger ring can be preallocated once; messages longer
+// than MAX_MESSAGE bytes are cut short and end in TRUNCATED_MARK, so the
+// shortening is visible in the GUI, the log file and the mapped ring.
 struct LogEntry {
-    std::string id;
-    uint64_t    timestamp;
-    std::string message;
-    // types: "info", "success", "warning", "error", "system", "mutation"
-    std::string type;
+    static constexpr size_t MAX_MESSAGE = 491;
+    static constexpr std::string_view TRUNCATED_MARK = "\xE2\x80\xA6[truncated]";   // "…[truncated]"
+
+    uint64_t id        = 0;   // monotonic, 1-based
+    uint64_t timestamp = 0;   // ms since SDL init
+    LogType  type      = LogType::INFO;
+    uint16_t length    = 0;
+    char     text[MAX_MESSAGE + 1] = {};
+
+    std::string_view message() const { return { text, length }; }
 };
+static_assert(sizeof(LogEntry) == 512, "LogEntry should stay one 512-byte slot");
 
 struct HistoryEntry {
     int         generation;
@@ -11,13 +11,15 @@
 // to Dear ImGui color values.  Included by gui.cpp and heatmap.cpp.
 // ─────────────────────────────────────────────────────────────────────────────
 
-inline ImVec4 colorForLogType(const std::string& t) {
-    if (t == "success") return { 0.29f, 0.87f, 0.38f, 1.0f };
-    if (t == "warning") return { 0.98f, 0.82f, 0.10f, 1.0f };
-    if (t == "error")   return { 0.96f, 0.26f, 0.21f, 1.0f };
-    if (t == "system")  return { 0.11f, 0.83f, 0.93f, 1.0f };
-    if (t == "mutation")return { 0.78f, 0.50f, 0.98f, 1.0f };
-    return { 0.63f, 0.63f, 0.63f, 1.0f }; // info
+inline ImVec4 colorForLogType(LogType t) {
+    switch (t) {
+        case LogType::SUCCESS:  return { 0.29f, 0.87f, 0.38f, 1.0f };
+        case LogType::WARNING:  return { 0.98f, 0.82f, 0.10f, 1.0f };
+        case LogType::ERROR:    return { 0.96f, 0.26f, 0.21f, 1.0f };
+        case LogType::SYSTEM:   return { 0.11f, 0.83f, 0.93f, 1.0f };
+        case LogType::MUTATION: return { 0.78f, 0.50f, 0.98f, 1.0f };
+        default:                return { 0.63f, 0.63f, 0.63f, 1.0f }; // info
+    }
 }
 
 inline ImVec4 colorForState(SystemState s) {
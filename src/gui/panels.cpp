@@ -58,18 +58,16 @@ void Gui::renderTrainingScene(App& app, int winW, int winH) {
 
     // ── Side-by-side: telemetry stats | policy architecture ──────────────────
     float halfW = (panelW - 30.0f) * 0.5f;
+    // with --async-train this is the trainer thread's last published state
+    auto snap = app.trainerSnapshot();
 
     ImGui::BeginChild("##TelStats", { halfW, 130.0f * m_uiScale }, true);
     ImGui::TextDisabled("TELEMETRY DATA");
     ImGui::Separator();
     ImGui::Text("Entries loaded : %d", (int)app.advisor().entryCount());
-    ImGui::Text("Observations   : %d", app.trainer().observations());
+    ImGui::Text("Observations   : %d", snap->observations);
     if (app.advisor().entryCount() > 0) {
-        float avgGen = 0.0f;
-        for (const auto& e : app.advisor().entries())
-            avgGen += static_cast<float>(e.generation);
-        avgGen /= static_cast<float>(app.advisor().entryCount());
-        ImGui::Text("Avg generation : %.1f", avgGen);
+        ImGui::Text("Avg generation : %.1f", app.advisor().averageGeneration());
         float score = app.advisor().score({});
         ImGui::Text("Advisor score  : %.3f", score);
     }
@@ -80,7 +78,7 @@ void Gui::renderTrainingScene(App& app, int winW, int winH) {
     ImGui::BeginChild("##PolicyArch", { halfW, 130.0f * m_uiScale }, true);
     ImGui::TextDisabled("POLICY NETWORK");
     ImGui::Separator();
-    const Policy& pol = app.trainer().policy();
+    const Policy& pol = *snap->policy;
     int totalParams = 0;
     for (int l = 0; l < pol.layerCount(); ++l) {
         int w = pol.layerInSize(l) * pol.layerOutSize(l);
@@ -90,8 +88,8 @@ void Gui::renderTrainingScene(App& app, int winW, int winH) {
     }
     ImGui::Separator();
     ImGui::Text("Total params   : %d", totalParams);
-    if (app.trainer().observations() > 0)
-        ImGui::Text("Avg loss (EMA) : %.6f", app.trainer().avgLoss());
+    if (snap->observations > 0)
+        ImGui::Text("Avg loss (EMA) : %.6f", snap->avgLoss);
     ImGui::EndChild();
 
     ImGui::Spacing();
@@ -101,7 +99,7 @@ void Gui::renderTrainingScene(App& app, int winW, int winH) {
     float prog = app.trainingProgress();
     char overlay[64];
     std::snprintf(overlay, sizeof(overlay), "%.0f%%  (%d obs)",
-                  prog * 100.0f, app.trainer().observations());
+                  prog * 100.0f, snap->observations);
     ImGui::PushStyleColor(ImGuiCol_PlotHistogram, { 0.11f, 0.83f, 0.93f, 0.85f });
     ImGui::ProgressBar(prog, { -1.0f, 22.0f * m_uiScale }, overlay);
     ImGui::PopStyleColor();
@@ -236,7 +234,8 @@ void Gui::renderTopBar(App& app, int winW) {
 void Gui::renderLogPanel(const App& app, float w, float h) {
     ImGui::BeginChild("##LogPanel", { w, h }, true,
                       ImGuiWindowFlags_NoScrollbar);
-    ImGui::TextDisabled("SYSTEM LOG  BUF:%d", (int)app.logs().size());
+    app.snapshotLogs(m_logView);
+    ImGui::TextDisabled("SYSTEM LOG  BUF:%d", (int)m_logView.size());
     // filter input
     ImGui::SameLine();
     ImGui::SetCursorPosX(w - 200.0f * m_uiScale);
@@ -250,9 +249,9 @@ void Gui::renderLogPanel(const App& app, float w, float h) {
     ImGui::Separator();
     ImGui::BeginChild("##LogScroll", { 0, 0 }, false,
                       ImGuiWindowFlags_HorizontalScrollbar);
-    for (const auto& log : app.logs()) {
+    for (const auto& log : m_logView) {
         if (!m_logFilter.empty()) {
-            if (log.message.find(m_logFilter) == std::string::npos)
+            if (log.message().find(m_logFilter) == std::string_view::npos)
                 continue;
         }
         uint64_t t = log.timestamp;
@@ -264,12 +263,10 @@ void Gui::renderLogPanel(const App& app, float w, float h) {
         std::snprintf(ts, sizeof ts, "%02d:%02d:%02d.%03d", hr, m, s, ms);
         ImGui::TextDisabled("%s", ts);
         ImGui::SameLine();
-        if (log.type == "system")
-            ImGui::TextColored(colorForLogType(log.type), "-> %s",
-                               log.message.c_str());
+        if (log.type == LogType::SYSTEM)
+            ImGui::TextColored(colorForLogType(log.type), "-> %s", log.text);
         else
-            ImGui::TextColored(colorForLogType(log.type), "%s",
-                               log.message.c_str());
+            ImGui::TextColored(colorForLogType(log.type), "%s", log.text);
     }
     if (m_scrollLogs) {
         ImGui::SetScrollHereY(1.0f);
@@ -429,7 +426,8 @@ void Gui::renderInstancesPanel(App& app, float w, float h) {
 // negative) stacked vertically.  This panel is drawn in the evolution scene
 // above the heap memory heatmap.
 void Gui::renderWeightHeatmaps(const App& app, int winW) {
-    const Policy& pol = app.trainer().policy();
+    auto snap = app.trainerSnapshot();
+    const Policy& pol = *snap->policy;
     int layers = pol.layerCount();
     if (layers == 0) return;
 
@@ -456,9 +454,13 @@ void Gui::renderWeightHeatmaps(const App& app, int winW) {
         // so no allocation or free is necessary.
         const SDL_PixelFormatDetails* fmt =
             SDL_GetPixelFormatDetails(SDL_PIXELFORMAT_RGBA32);
+        // embedding layers store one row per input (in×out)
+        const bool rowPerInput =
+            pol.layerType(l) == Policy::LayerType::EMBEDDING;
         for (int i = 0; i < out; ++i) {
             for (int j = 0; j < in; ++j) {
-                float val = pol.layerWeights(l)[i * in + j];
+                float val = rowPerInput ? pol.layerWeights(l)[j * out + i]
+                                        : pol.layerWeights(l)[i * in + j];
                 float tn = std::tanh(val);
                 uint8_t r = 0, g = 0, b = 0, a = 255;
                 if (tn >= 0) {
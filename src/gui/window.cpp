@@ -109,9 +109,9 @@ void Gui::renderFrame(App& app) {
         m_scrollInstrs = true;
         m_lastIP       = app.programCounter();
     }
-    if (app.logs().size() != m_lastLogSz) {
+    if (app.lastLogId() != m_lastLogId) {
         m_scrollLogs = true;
-        m_lastLogSz  = app.logs().size();
+        m_lastLogId  = app.lastLogId();
     }
 
     ImGui_ImplSDLRenderer3_NewFrame();
@@ -83,10 +83,12 @@ private:
     bool   m_scrollLogs   = true;
     bool   m_scrollInstrs = true;
     int    m_lastIP       = -1;
-    size_t m_lastLogSz    = 0;
+    uint64_t m_lastLogId  = 0;
 
     // filter used in the log panel; matches substring in messages
     std::string m_logFilter;
+    // log ring snapshot, refreshed once per frame (capacity is reused)
+    std::vector<LogEntry> m_logView;
 
     // advisor panel state
     bool   m_showAdvisor    = false;
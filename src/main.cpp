@@ -11,6 +11,8 @@
 #include <signal.h>
 
 #include "cli.h"
+#include "metrics.h"
+#include "trace.h"
 
 // signal handler forwards termination requests to the App singleton
 static void signalHandler(int /*sig*/) {
@@ -27,6 +29,13 @@ int main(int argc, char** argv) {
     ::signal(SIGTERM, signalHandler);
     ::signal(SIGINT, signalHandler);
 
+    if (!opts.tracePath.empty()) {
+        if (trace::start(opts.tracePath))
+            trace::setThreadName("main");
+        else
+            SDL_Log("could not open trace file %s", opts.tracePath.c_str());
+    }
+
     // initialise SDL with video only if GUI is requested; otherwise we
     // skip SDL completely (we only use std::chrono for timing in headless
     // mode).  This avoids pulling in video subsystems on CI.
@@ -72,8 +81,11 @@ int main(int argc, char** argv) {
         gui.init(window, renderer);
 
         App  app(opts);
+        Histogram& frameTime = metrics().histogram(
+            "wqb_gui_frame_seconds", "GUI frame time (events, update, render, present)");
         bool running = true;
         while (running) {
+            ScopedTimer frameTimer(frameTime);
             SDL_Event ev;
             while (SDL_PollEvent(&ev)) {
                 ImGui_ImplSDL3_ProcessEvent(&ev);
@@ -90,7 +102,7 @@ int main(int argc, char** argv) {
                         }
                     }
                     if (ev.key.key == SDLK_H) {      // show a simple help text in logs
-                        app.log("Shortcut: Space=pause, E=export, F=toggle fullscreen, H=help, Q/Esc=quit", "info");
+                        app.log("Shortcut: Space=pause, E=export, F=toggle fullscreen, H=help, Q/Esc=quit", LogType::INFO);
                     }
                     if (ev.key.key == SDLK_Q ||
                         ev.key.key == SDLK_ESCAPE)  running = false;
@@ -126,6 +138,7 @@ int main(int argc, char** argv) {
         }
     }
 
+    trace::stop();
     SDL_Quit();
     return 0;
 }
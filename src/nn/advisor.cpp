@@ -1,38 +1,97 @@
 #include "nn/advisor.h"
 #include "nn/feature.h"
+#include <chrono>
+#include <cmath>
 #include <filesystem>
 #include <fstream>
 #include <sstream>
 #include <regex>
 #include <iostream>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
 
 namespace fs = std::filesystem;
 
-Advisor::Advisor(const std::string& baseDir) {
+Advisor::Advisor(const std::string& baseDir, const std::string& skipRun)
+    : m_baseDir(baseDir), m_skipRun(skipRun)
+{
+    rescan();
+}
+
+size_t Advisor::rescan() {
+    size_t before = m_entries.size();
     try {
-        for (auto& run : fs::directory_iterator(baseDir)) {
-            if (run.is_directory()) {
-                scanDirectory(run.path().string());
-            }
+        for (auto& run : fs::directory_iterator(m_baseDir)) {
+            if (!run.is_directory()) continue;
+            if (!m_skipRun.empty() && run.path().filename() == m_skipRun) continue;
+            // read before listing: a file created after that bumps it again
+            std::error_code ec;
+            auto mtime = fs::last_write_time(run.path(), ec);
+            if (ec) continue;
+            std::string dir = run.path().string();
+            auto known = m_runTimes.find(dir);
+            if (known != m_runTimes.end() && known->second == mtime) continue;   // no new files
+            if (!scanDirectory(dir)) continue;   // retried next time
+            // on coarse-grained timestamps a file created within the same
+            // tick would not change mtime; only trust one that has settled
+            if (fs::file_time_type::clock::now() - mtime > std::chrono::seconds(2))
+                m_runTimes[dir] = mtime;
         }
     } catch (...) {
         // if directory doesn't exist or cannot be read, silently ignore
     }
+    return m_entries.size() - before;
+}
+
+void Advisor::append(TelemetryEntry e) {
+    if (!e.kernelBase64.empty()) {
+        e.features = Feature::kernel(e);
+        if (e.opcodeSequence.empty()) e.opcodeSequence = e.features->opcodes;
+    }
+    add(std::move(e));
 }
 
-void Advisor::scanDirectory(const std::string& runDir) {
+void Advisor::add(TelemetryEntry e) {
+    m_generationSum += e.generation;
+    if (!e.opcodeSequence.empty()) {
+        auto it = m_bestGeneration.emplace(e.opcodeSequence, e.generation).first;
+        if (e.generation > it->second) it->second = e.generation;
+        (e.trapCode.empty() ? m_okModel : m_trapModel).add(e.opcodeSequence);
+    }
+    m_entries.push_back(std::move(e));
+}
+
+bool Advisor::scanDirectory(const std::string& runDir) {
+    // App::autoExport() writes a run's exports under an exclusive flock()
+    // of export.lock; sharing it means no file is caught half-written.
+    // Runs that never exported through it have no lock file.
+    int lockfd = ::open((runDir + "/export.lock").c_str(), O_RDONLY);
+    if (lockfd >= 0 && flock(lockfd, LOCK_SH | LOCK_NB) != 0) {
+        ::close(lockfd);
+        return false;
+    }
+    bool ok = true;
     try {
         for (auto& entry : fs::directory_iterator(runDir)) {
             if (!entry.is_regular_file()) continue;
             const auto& name = entry.path().filename().string();
             if (name.rfind("gen_", 0) == 0 && name.find(".txt") != std::string::npos) {
-                parseFile(entry.path().string());
+                std::string path = entry.path().string();
+                if (m_seenFiles.insert(path).second)
+                    parseFile(path);
             }
         }
     } catch (const std::exception& e) {
         std::cerr << "Advisor: unable to scan directory '" << runDir
                   << "': " << e.what() << "\n";
+        ok = false;
+    }
+    if (lockfd >= 0) {
+        flock(lockfd, LOCK_UN);
+        ::close(lockfd);
     }
+    return ok;
 }
 
 void Advisor::parseFile(const std::string& path) {
@@ -67,8 +126,11 @@ void Advisor::parseFile(const std::string& path) {
 
     if (te.generation || !te.kernelBase64.empty()) {
         // populate sequence now that kernelBase64 is known
-        te.opcodeSequence = Feature::extractSequence(te);
-        m_entries.push_back(std::move(te));
+        if (!te.kernelBase64.empty()) {
+            te.features       = Feature::kernel(te);
+            te.opcodeSequence = te.features->opcodes;
+        }
+        add(std::move(te));
     }
 }
 
@@ -81,22 +143,30 @@ float Advisor::score(const std::vector<uint8_t>& seq) const {
     // the entries we have seen, treat it as "known good" and return top
     // score.  This allows the advisor to reward mutations that reproduce
     // previously successful instruction patterns.
-    for (auto& e : m_entries) {
-        if (!e.opcodeSequence.empty() && e.opcodeSequence == seq) {
-            return 1.0f;
-        }
-    }
+    if (!seq.empty() && m_bestGeneration.count(seq)) return 1.0f;
 
     // fallback heuristic: average generation mapped into (0,1]
-    float total = 0.0f;
-    for (auto& e : m_entries) total += static_cast<float>(e.generation);
-    float avg = total / m_entries.size();
+    float avg = averageGeneration();
     float s = avg <= 0.0f ? 0.1f : avg / (avg + 10.0f);
     if (s < 0.0f) s = 0.0f;
     if (s > 1.0f) s = 1.0f;
     return s;
 }
 
+int Advisor::bestGeneration(const std::vector<uint8_t>& seq) const {
+    if (seq.empty()) return -1;   // entries without a sequence are not indexed
+    auto it = m_bestGeneration.find(seq);
+    return it == m_bestGeneration.end() ? -1 : it->second;
+}
+
+float Advisor::likelihoodScore(const std::vector<uint8_t>& seq) const {
+    if (seq.empty() || m_okModel.sequences() == 0 || m_trapModel.sequences() == 0)
+        return 0.5f;
+    double llr = (m_okModel.logLikelihood(seq) - m_trapModel.logLikelihood(seq)) /
+                 (double)seq.size();
+    return (float)(1.0 / (1.0 + std::exp(-llr)));
+}
+
 bool Advisor::dump(const std::string& path) const {
     try {
         std::ofstream f(path);
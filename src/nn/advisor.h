@@ -1,8 +1,16 @@
 #pragma once
 
+#include "ngram.h"
+
+#include <filesystem>
+#include <memory>
 #include <string>
 #include <vector>
 #include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+
+struct KernelFeatures;   // nn/feature.h
 
 // simple record extracted from a telemetry export
 struct TelemetryEntry {
@@ -11,35 +19,112 @@ struct TelemetryEntry {
     std::string trapCode;
     // decoded opcode sequence (filled by Advisor) for convenience
     std::vector<uint8_t> opcodeSequence;
+    // decoded features of kernelBase64, shared with FeatureCache (filled by
+    // Advisor and App; see Feature::kernel).  Reset it if kernelBase64
+    // changes.
+    std::shared_ptr<const KernelFeatures> features;
 };
 
 // Advisor loads all telemetry exports under a given base
-// directory and makes them available for training/advice.
+// directory and makes them available for training/advice.  Entries produced
+// by the running process are pushed in directly via append(); disk scans are
+// only needed for exports written by other runs.
 class Advisor {
 public:
-    explicit Advisor(const std::string& baseDir = "bin/seq");
+    // `skipRun` names a run subdirectory that is never parsed from disk
+    // (normally the current session, whose entries arrive via append()).
+    explicit Advisor(const std::string& baseDir = "bin/seq",
+                     const std::string& skipRun = "");
 
     // number of entries successfully parsed
     size_t size() const { return m_entries.size(); }
 
     const std::vector<TelemetryEntry>& entries() const { return m_entries; }
 
-    // return a safety score in [0,1] for a candidate mutation sequence
+    // return a safety score in [0,1] for a candidate mutation sequence.
+    // One hash lookup plus the cached aggregate: O(len), independent of the
+    // number of entries.
     float score(const std::vector<uint8_t>& seq) const;
 
+    // Opcode language-model score in (0,1): the logistic of the mean
+    // per-opcode log-likelihood ratio between trigram models of successful
+    // and trapped kernels.  Above 0.5 the sequence looks more like kernels
+    // that ran; 0.5 means no evidence (empty sequence, or one of the two
+    // models has not seen any kernel yet).  A few hundred nanoseconds for a
+    // typical mutation; both models update as entries are added.
+    // The models are trained on whole kernels but usually asked about a
+    // short mutation genome.  Normalizing by length makes the two
+    // comparable: kernels in both corpora share their ancestry, so the
+    // scaffolding trigrams get about the same probability from each model
+    // and cancel in the ratio, leaving the trigrams mutations introduced,
+    // which is what a genome consists of.  Training on genomes instead is
+    // not possible, since exports from other runs only carry kernels.
+    float likelihoodScore(const std::vector<uint8_t>& seq) const;
+
+    // highest generation recorded for an exact opcode sequence, or -1 if
+    // no entry has it
+    int bestGeneration(const std::vector<uint8_t>& seq) const;
+
+    // mean generation over all entries (0 when empty), maintained as
+    // entries are added
+    float averageGeneration() const {
+        return m_entries.empty() ? 0.0f : (float)((double)m_generationSum / (double)m_entries.size());
+    }
+
     // number of telemetry entries loaded from disk
     size_t entryCount() const { return m_entries.size(); }
 
+    // append an entry produced in-process.  If `opcodeSequence` is empty it
+    // is decoded from `kernelBase64`; callers that already hold the decoded
+    // bytes should fill it themselves to avoid the extra decode.
+    void append(TelemetryEntry e);
+
+    // parse export files from other runs that appeared since the last scan.
+    // Run directories whose modification time is unchanged are not listed
+    // again and files already seen are skipped, so the cost is the number
+    // of runs plus the files of runs that gained exports.  A run whose
+    // exporter holds export.lock is left for the next scan rather than
+    // read mid-write.  Returns the number of entries added.
+    size_t rescan();
+
     // test helper: insert an entry directly without reading from filesystem
-    void test_addEntry(const TelemetryEntry& e) { m_entries.push_back(e); }
+    void test_addEntry(const TelemetryEntry& e) { add(e); }
 
     // write the current advisor entries to disk (simple text format).
     // Returns true on success.
     bool dump(const std::string& path) const;
 
 private:
-    void scanDirectory(const std::string& runDir);
+    // parse the new exports of one run under a shared export.lock; false
+    // (nothing read) if a writer holds it or the directory cannot be listed
+    bool scanDirectory(const std::string& runDir);
     void parseFile(const std::string& path);
+    // store `e` and update the sequence index and aggregates
+    void add(TelemetryEntry e);
+
+    struct SeqHash {
+        size_t operator()(const std::vector<uint8_t>& v) const noexcept {
+            // FNV-1a 64-bit
+            size_t h = 1469598103934665603ULL;
+            for (uint8_t b : v) {
+                h ^= b;
+                h *= 1099511628211ULL;
+            }
+            return h;
+        }
+    };
 
     std::vector<TelemetryEntry> m_entries;
+    // non-empty opcode sequence -> best generation seen with it
+    std::unordered_map<std::vector<uint8_t>, int, SeqHash> m_bestGeneration;
+    int64_t m_generationSum = 0;
+    // opcode trigram models of entries without / with a trap
+    OpcodeNgram m_okModel, m_trapModel;
+
+    std::string m_baseDir;
+    std::string m_skipRun;
+    // export files already parsed; lets rescan() pick up only new ones
+    std::unordered_set<std::string> m_seenFiles;
+    // run directory -> modification time when it was last fully scanned
+    std::unordered_map<std::string, std::filesystem::file_time_type> m_runTimes;
 };
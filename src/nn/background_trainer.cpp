@@ -0,0 +1,69 @@
+#include "nn/background_trainer.h"
+#include "trace.h"
+
+#include <chrono>
+
+BackgroundTrainer::BackgroundTrainer(Trainer& trainer) : m_trainer(trainer) {}
+
+BackgroundTrainer::~BackgroundTrainer() {
+    stop();
+}
+
+void BackgroundTrainer::start() {
+    if (running()) return;
+    m_stopping.store(false, std::memory_order_relaxed);
+    publish();
+    m_thread = std::thread(&BackgroundTrainer::threadMain, this);
+}
+
+void BackgroundTrainer::stop() {
+    if (!running()) return;
+    m_stopping.store(true, std::memory_order_release);
+    m_thread.join();
+}
+
+bool BackgroundTrainer::submit(TelemetryEntry entry) {
+    if (m_queue.tryPush(std::move(entry))) return true;
+    m_dropped.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+void BackgroundTrainer::publish() {
+    auto snap = std::make_shared<TrainerSnapshot>();
+    snap->policy           = std::make_shared<const Policy>(m_trainer.policy());
+    snap->quantized        = std::make_shared<const QuantizedPolicy>(m_trainer.policy());
+    snap->observations     = m_trainer.observations();
+    snap->avgLoss          = m_trainer.avgLoss();
+    snap->lastLoss         = m_trainer.lastLoss();
+    snap->maxReward        = m_trainer.maxReward();
+    snap->lastUsedSequence = m_trainer.test_lastUsedSequence();
+    snap->version          = ++m_version;
+    std::atomic_store_explicit(&m_snapshot, std::shared_ptr<const TrainerSnapshot>(std::move(snap)),
+                               std::memory_order_release);
+}
+
+void BackgroundTrainer::threadMain() {
+    if (trace::enabled()) trace::setThreadName("trainer");
+    TelemetryEntry entry;
+    for (;;) {
+        // read the flag before draining so nothing queued ahead of stop()
+        // is left behind
+        bool stopping = m_stopping.load(std::memory_order_acquire);
+        int n = 0;
+        if (m_queue.size() > 0) {
+            TRACE_SCOPE("BackgroundTrainer::drain", "train");
+            while (n < kMaxDrain && m_queue.tryPop(entry)) {
+                m_trainer.observe(entry);
+                ++n;
+            }
+        }
+        if (n > 0) {
+            m_trained.fetch_add((uint64_t)n, std::memory_order_relaxed);
+            publish();
+        }
+        if (n == 0) {
+            if (stopping) break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(kIdleSleepMs));
+        }
+    }
+}
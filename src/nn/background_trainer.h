@@ -0,0 +1,87 @@
+#pragma once
+
+#include "train.h"
+#include "quantized.h"
+#include "spsc_queue.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+// Immutable view of a Trainer published for other threads.  `policy` is a
+// private copy of the weights; run forward passes on a copy of it (forward
+// updates the LSTM state).  `quantized` is the int8 model built from the
+// same weights on the trainer thread, for read-only scoring with a
+// caller-owned State; App's synchronous snapshots leave it null.
+struct TrainerSnapshot {
+    std::shared_ptr<const Policy> policy;
+    std::shared_ptr<const QuantizedPolicy> quantized;
+    int      observations     = 0;
+    float    avgLoss          = 0.0f;
+    float    lastLoss         = 0.0f;
+    float    maxReward        = 1.0f;
+    bool     lastUsedSequence = false;
+    uint64_t version          = 0;   // increases with every publish
+};
+
+// ── BackgroundTrainer ─────────────────────────────────────────────────────────
+//
+// Runs a Trainer on its own thread so evolution never waits for training.
+// The evolution thread submit()s telemetry into a lock-free SPSC queue; the
+// trainer thread drains it, observe()s each entry and then publishes a fresh
+// TrainerSnapshot by atomically swapping a shared_ptr.  Readers call
+// snapshot() and keep the returned pointer for as long as they need it.
+//
+// While running, the wrapped Trainer belongs to the trainer thread: the
+// owner must not touch it until stop() returns.  A full queue drops the
+// entry (counted in dropped()) rather than blocking the producer.
+// ─────────────────────────────────────────────────────────────────────────────
+
+class BackgroundTrainer {
+public:
+    static constexpr size_t kQueueCapacity = 1024;
+    static constexpr int    kMaxDrain      = 64;   // entries between publishes
+    static constexpr int    kIdleSleepMs   = 2;
+
+    explicit BackgroundTrainer(Trainer& trainer);
+    ~BackgroundTrainer();
+
+    BackgroundTrainer(const BackgroundTrainer&) = delete;
+    BackgroundTrainer& operator=(const BackgroundTrainer&) = delete;
+
+    // Publish the current state and start the trainer thread.  The model
+    // is not saved here; checkpoint snapshot()->policy (see Checkpointer).
+    void start();
+    // Train whatever is still queued, publish, and join the thread.
+    void stop();
+    bool running() const { return m_thread.joinable(); }
+
+    // Producer side (one thread).  Returns false if the queue was full and
+    // the entry was dropped.
+    bool submit(TelemetryEntry entry);
+
+    // Latest published state; never null once start() has been called.
+    std::shared_ptr<const TrainerSnapshot> snapshot() const {
+        return std::atomic_load_explicit(&m_snapshot, std::memory_order_acquire);
+    }
+
+    uint64_t trained() const { return m_trained.load(std::memory_order_relaxed); }
+    uint64_t dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+    size_t   backlog() const { return m_queue.size(); }
+
+private:
+    void threadMain();
+    void publish();
+
+    Trainer&                    m_trainer;
+    SpscQueue<TelemetryEntry>   m_queue{kQueueCapacity};
+    std::thread                 m_thread;
+    std::atomic<bool>           m_stopping{false};
+
+    std::shared_ptr<const TrainerSnapshot> m_snapshot;   // atomic access only
+    uint64_t                    m_version = 0;           // trainer thread
+
+    std::atomic<uint64_t>       m_trained{0};
+    std::atomic<uint64_t>       m_dropped{0};
+};
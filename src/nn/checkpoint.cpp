@@ -0,0 +1,225 @@
+#include "nn/checkpoint.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static constexpr size_t kBlobAlign = 64;
+
+static uint64_t alignUp(uint64_t v) {
+    return (v + kBlobAlign - 1) / kBlobAlign * kBlobAlign;
+}
+
+// ── CRC-32 ────────────────────────────────────────────────────────────────────
+// Slicing-by-8: eight 256-entry tables let the loop fold in eight bytes per
+// iteration, which keeps the check well under a millisecond for a full
+// model.
+
+namespace {
+struct CrcTables {
+    uint32_t t[8][256];
+    CrcTables() {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) c = (c >> 1) ^ (0xEDB88320u & (0u - (c & 1u)));
+            t[0][i] = c;
+        }
+        for (uint32_t i = 0; i < 256; ++i)
+            for (int s = 1; s < 8; ++s)
+                t[s][i] = (t[s - 1][i] >> 8) ^ t[0][t[s - 1][i] & 0xFF];
+    }
+};
+} // namespace
+
+uint32_t crc32(const void* data, size_t n, uint32_t crc) {
+    static const CrcTables tables;
+    const auto& t = tables.t;
+    const auto* p = static_cast<const unsigned char*>(data);
+    crc = ~crc;
+    while (n >= 8) {
+        uint32_t lo, hi;
+        std::memcpy(&lo, p, 4);
+        std::memcpy(&hi, p + 4, 4);
+        lo ^= crc;   // little-endian hosts only (see the file layout note)
+        crc = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^ t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24] ^
+              t[3][hi & 0xFF] ^ t[2][(hi >> 8) & 0xFF] ^ t[1][(hi >> 16) & 0xFF] ^ t[0][hi >> 24];
+        p += 8;
+        n -= 8;
+    }
+    while (n--) crc = (crc >> 8) ^ t[0][(crc ^ *p++) & 0xFF];
+    return ~crc;
+}
+
+// ── Writer ────────────────────────────────────────────────────────────────────
+
+bool writeCheckpoint(const std::string& path, const Policy& policy,
+                     const CheckpointStats& stats, uint64_t* bytes) {
+    const int layers = policy.layerCount();
+    CheckpointLayer desc[64];
+    if (layers > (int)(sizeof(desc) / sizeof(desc[0]))) return false;
+
+    // lay out the descriptor table and blobs first so the header (and its
+    // CRC) can be computed in a single streaming pass
+    uint64_t off = sizeof(CheckpointHeader) + (uint64_t)layers * sizeof(CheckpointLayer);
+    for (int l = 0; l < layers; ++l) {
+        CheckpointLayer& d = desc[l];
+        d = CheckpointLayer{};
+        d.type         = (uint32_t)policy.layerType(l);
+        d.inSize       = (uint32_t)policy.layerInSize(l);
+        d.outSize      = (uint32_t)policy.layerOutSize(l);
+        d.weightCount  = policy.layerWeights(l).size();
+        d.weightOffset = off = alignUp(off);
+        off += d.weightCount * sizeof(float);
+        d.biasCount    = policy.layerBiases(l).size();
+        d.biasOffset   = off = alignUp(off);
+        off += d.biasCount * sizeof(float);
+    }
+
+    CheckpointHeader h;
+    h.magic        = CheckpointHeader::kMagic;
+    h.version      = CheckpointHeader::kVersion;
+    h.headerSize   = sizeof(CheckpointHeader);
+    h.layerCount   = (uint32_t)layers;
+    h.fileSize     = off;
+    h.observations = stats.observations;
+    h.avgLoss      = stats.avgLoss;
+    h.maxReward    = stats.maxReward;
+
+    std::FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) return false;
+    static const char kZeros[kBlobAlign] = {};
+    uint64_t pos = 0;
+    uint32_t crc = 0;
+    auto put = [&](const void* p, size_t n) {
+        crc = crc32(p, n, crc);
+        pos += n;
+        return std::fwrite(p, 1, n, f) == n;
+    };
+    auto padTo = [&](uint64_t target) {
+        return target == pos || put(kZeros, (size_t)(target - pos));
+    };
+
+    bool ok = put(&h, sizeof(h)) && put(desc, (size_t)layers * sizeof(CheckpointLayer));
+    for (int l = 0; ok && l < layers; ++l) {
+        const auto& w = policy.layerWeights(l);
+        const auto& b = policy.layerBiases(l);
+        ok = padTo(desc[l].weightOffset) && put(w.data(), w.size() * sizeof(float)) &&
+             padTo(desc[l].biasOffset)   && put(b.data(), b.size() * sizeof(float));
+    }
+    // patch the CRC into the header
+    if (ok) {
+        h.crc = crc;
+        ok = std::fseek(f, 0, SEEK_SET) == 0 && std::fwrite(&h, 1, sizeof(h), f) == sizeof(h);
+    }
+    // on disk before anyone renames it into place
+    ok = ok && std::fflush(f) == 0 && ::fsync(fileno(f)) == 0;
+    ok = (std::fclose(f) == 0) && ok;
+    if (ok && bytes) *bytes = pos;
+    return ok;
+}
+
+bool renameDurable(const std::string& from, const std::string& to) {
+    if (std::rename(from.c_str(), to.c_str()) != 0) return false;
+    size_t slash = to.find_last_of('/');
+    std::string dir = slash == std::string::npos ? "." : slash == 0 ? "/" : to.substr(0, slash);
+    int fd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY);
+    if (fd < 0) return false;
+    bool ok = ::fsync(fd) == 0;
+    ::close(fd);
+    return ok;
+}
+
+bool isBinaryCheckpoint(const std::string& path) {
+    std::FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) return false;
+    uint32_t magic = 0;
+    bool ok = std::fread(&magic, 1, sizeof(magic), f) == sizeof(magic);
+    std::fclose(f);
+    return ok && magic == CheckpointHeader::kMagic;
+}
+
+// ── Reader ────────────────────────────────────────────────────────────────────
+
+bool MappedCheckpoint::open(const std::string& path) {
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    void* mem = MAP_FAILED;
+    size_t size = 0;
+    if (fstat(fd, &st) == 0 && (size_t)st.st_size >= sizeof(CheckpointHeader)) {
+        size = (size_t)st.st_size;
+        mem  = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    ::close(fd);  // the mapping keeps the file referenced
+    if (mem == MAP_FAILED) return false;
+
+    const char* base = static_cast<const char*>(mem);
+    CheckpointHeader h;
+    std::memcpy(&h, base, sizeof(h));
+    bool ok = h.magic == CheckpointHeader::kMagic &&
+              h.version == CheckpointHeader::kVersion &&
+              h.headerSize == sizeof(CheckpointHeader) &&
+              h.fileSize == size &&
+              sizeof(CheckpointHeader) + (uint64_t)h.layerCount * sizeof(CheckpointLayer) <= size;
+
+    if (ok) {
+        // the CRC covers the header with its crc field zeroed
+        uint32_t stored = h.crc;
+        h.crc = 0;
+        uint32_t crc = crc32(&h, sizeof(h));
+        crc = crc32(base + sizeof(h), size - sizeof(h), crc);
+        ok = crc == stored;
+    }
+
+    const auto* layers = reinterpret_cast<const CheckpointLayer*>(base + sizeof(CheckpointHeader));
+    for (uint32_t l = 0; ok && l < h.layerCount; ++l) {
+        const CheckpointLayer& d = layers[l];
+        ok = d.weightOffset % kBlobAlign == 0 && d.biasOffset % kBlobAlign == 0 &&
+             d.weightCount <= size / sizeof(float) && d.biasCount <= size / sizeof(float) &&
+             d.weightOffset + d.weightCount * sizeof(float) <= size &&
+             d.biasOffset   + d.biasCount   * sizeof(float) <= size;
+    }
+    if (!ok) {
+        munmap(mem, size);
+        return false;
+    }
+    m_base   = base;
+    m_layers = layers;
+    m_size   = size;
+    return true;
+}
+
+void MappedCheckpoint::close() {
+    if (!m_base) return;
+    munmap(const_cast<char*>(m_base), m_size);
+    m_base   = nullptr;
+    m_layers = nullptr;
+    m_size   = 0;
+}
+
+CheckpointStats MappedCheckpoint::stats() const {
+    const CheckpointHeader& h = header();
+    CheckpointStats s;
+    s.observations = (int)h.observations;
+    s.avgLoss      = h.avgLoss;
+    s.maxReward    = h.maxReward;
+    return s;
+}
+
+bool MappedCheckpoint::matches(const Policy& policy) const {
+    if (!isOpen() || layerCount() != policy.layerCount()) return false;
+    for (int l = 0; l < layerCount(); ++l) {
+        const CheckpointLayer& d = m_layers[l];
+        if (d.type    != (uint32_t)policy.layerType(l)    ||
+            d.inSize  != (uint32_t)policy.layerInSize(l)  ||
+            d.outSize != (uint32_t)policy.layerOutSize(l) ||
+            d.weightCount != policy.layerWeights(l).size() ||
+            d.biasCount   != policy.layerBiases(l).size())
+            return false;
+    }
+    return true;
+}
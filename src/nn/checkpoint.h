@@ -0,0 +1,112 @@
+#pragma once
+
+#include "policy.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// ── Binary model checkpoint ───────────────────────────────────────────────────
+//
+// Versioned on-disk format for a Policy plus the Trainer statistics.  The
+// file is laid out so a reader can mmap it and use the parameter blobs in
+// place: no text, no per-value parsing.
+//
+// File layout (host byte order, like the log ring):
+//   [0, 64)          CheckpointHeader
+//   [64, ...)        CheckpointLayer[layerCount]   (architecture descriptor)
+//   64-byte aligned  weights of layer 0, biases of layer 0, weights of
+//                    layer 1, ...  (raw float32, each blob starts on a
+//                    64-byte boundary, zero padding in between)
+//
+// `crc` is the CRC-32 (IEEE) of the whole file computed with the crc field
+// itself set to zero, so a truncated or bit-flipped checkpoint is rejected
+// instead of loading garbage weights.  Weights use the in-memory layout of
+// each layer type (see Policy), so they copy straight into the network.
+// ─────────────────────────────────────────────────────────────────────────────
+
+struct CheckpointHeader {
+    static constexpr uint32_t kMagic   = 0x4D425157; // "WQBM"
+    static constexpr uint32_t kVersion = 1;
+
+    uint32_t magic        = 0;
+    uint32_t version      = 0;
+    uint32_t headerSize   = 0;   // sizeof(CheckpointHeader)
+    uint32_t layerCount   = 0;
+    uint64_t fileSize     = 0;
+    int64_t  observations = 0;
+    float    avgLoss      = 0.0f;
+    float    maxReward    = 0.0f;
+    uint32_t crc          = 0;
+    uint32_t reserved[5]  = {};
+};
+static_assert(sizeof(CheckpointHeader) == 64, "header is one cache line");
+
+struct CheckpointLayer {
+    uint32_t type         = 0;   // Policy::LayerType
+    uint32_t inSize       = 0;
+    uint32_t outSize      = 0;
+    uint32_t reserved     = 0;
+    uint64_t weightOffset = 0;   // bytes from the start of the file
+    uint64_t weightCount  = 0;   // floats
+    uint64_t biasOffset   = 0;
+    uint64_t biasCount    = 0;
+};
+static_assert(sizeof(CheckpointLayer) == 48, "layer descriptor layout");
+
+// Trainer state stored next to the weights.
+struct CheckpointStats {
+    int   observations = 0;
+    float avgLoss      = 0.0f;
+    float maxReward    = 1.0f;
+};
+
+// CRC-32 (IEEE 802.3, reflected), continuing from `crc` (0 to start).
+uint32_t crc32(const void* data, size_t n, uint32_t crc = 0);
+
+// Write `policy` and `stats` to `path` in the binary format and fsync()
+// it before closing.  Returns false if the file cannot be written or
+// synced.  `bytes`, if given, receives the file size.
+bool writeCheckpoint(const std::string& path, const Policy& policy,
+                     const CheckpointStats& stats, uint64_t* bytes = nullptr);
+
+// rename() `from` over `to`, then fsync() the directory holding `to` so the
+// new name itself survives a crash.  False if either step fails.
+bool renameDurable(const std::string& from, const std::string& to);
+
+// True if `path` starts with the binary checkpoint magic (cheap sniff used
+// to tell it apart from the legacy text format).
+bool isBinaryCheckpoint(const std::string& path);
+
+// Read-only mapping of a binary checkpoint.  open() validates the header,
+// descriptor bounds and CRC; afterwards weights()/biases() point straight
+// into the mapping and stay valid until close().
+class MappedCheckpoint {
+public:
+    MappedCheckpoint() = default;
+    ~MappedCheckpoint() { close(); }
+
+    MappedCheckpoint(const MappedCheckpoint&) = delete;
+    MappedCheckpoint& operator=(const MappedCheckpoint&) = delete;
+
+    // Map and validate `path`.  Returns false (and stays closed) if the
+    // file is missing, not a checkpoint, a different version or corrupt.
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return m_base != nullptr; }
+
+    const CheckpointHeader& header() const { return *reinterpret_cast<const CheckpointHeader*>(m_base); }
+    CheckpointStats stats() const;
+    int layerCount() const { return (int)header().layerCount; }
+    const CheckpointLayer& layer(int l) const { return m_layers[l]; }
+    const float* weights(int l) const { return reinterpret_cast<const float*>(m_base + m_layers[l].weightOffset); }
+    const float* biases(int l)  const { return reinterpret_cast<const float*>(m_base + m_layers[l].biasOffset); }
+
+    // True if every layer matches `policy` in type and shape.
+    bool matches(const Policy& policy) const;
+
+private:
+    const char*            m_base   = nullptr;
+    const CheckpointLayer* m_layers = nullptr;
+    size_t                 m_size   = 0;
+};
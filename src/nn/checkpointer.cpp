@@ -0,0 +1,125 @@
+#include "nn/checkpointer.h"
+#include "metrics.h"
+#include "trace.h"
+
+#include <chrono>
+#include <cstdio>
+
+namespace {
+struct CheckpointMetrics {
+    Histogram& latency   = metrics().histogram("wqb_checkpoint_seconds", "Checkpoint write and rename time");
+    Counter&   written   = metrics().counter("wqb_checkpoints_total", "Model checkpoints written");
+    Counter&   bytes     = metrics().counter("wqb_checkpoint_bytes_total", "Bytes written to model checkpoints");
+    Counter&   failures  = metrics().counter("wqb_checkpoint_failures_total", "Model checkpoints that failed to write");
+    Counter&   coalesced = metrics().counter("wqb_checkpoints_coalesced_total", "Checkpoints replaced by a newer one before being written");
+};
+
+CheckpointMetrics& checkpointMetrics() {
+    static CheckpointMetrics m;
+    return m;
+}
+} // namespace
+
+Checkpointer::Checkpointer(CheckpointPolicy policy) : m_policy(policy) {
+    checkpointMetrics();   // register the series up front so they export as 0
+}
+
+Checkpointer::~Checkpointer() {
+    stop();
+}
+
+bool Checkpointer::due(int generation, float avgLoss) const {
+    if (m_lastLoss < 0.0f) return true;   // first checkpoint of the run
+    if (m_policy.everyGenerations > 0 &&
+        generation - m_lastGeneration >= m_policy.everyGenerations)
+        return true;
+    if (m_policy.minImprovement > 0.0f &&
+        avgLoss < m_lastLoss * (1.0f - m_policy.minImprovement))
+        return true;
+    return false;
+}
+
+void Checkpointer::mark(int generation, float avgLoss) {
+    m_lastGeneration = generation;
+    m_lastLoss       = avgLoss;
+}
+
+void Checkpointer::submit(std::shared_ptr<const Policy> model, const CheckpointStats& stats,
+                          const std::string& path) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Job* job = nullptr;
+        for (auto& j : m_pending)
+            if (j.path == path) job = &j;
+        if (job) {
+            m_coalesced.fetch_add(1, std::memory_order_relaxed);
+            checkpointMetrics().coalesced.inc();
+        } else {
+            m_pending.emplace_back();
+            job = &m_pending.back();
+            job->path = path;
+        }
+        job->model = std::move(model);
+        job->stats = stats;
+        if (!m_thread.joinable()) {
+            m_stopping = false;
+            m_thread = std::thread(&Checkpointer::threadMain, this);
+        }
+    }
+    m_cv.notify_one();
+}
+
+void Checkpointer::flush() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idleCv.wait(lock, [this] { return m_pending.empty() && !m_busy; });
+}
+
+void Checkpointer::stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_thread.joinable()) return;
+        m_stopping = true;
+    }
+    m_cv.notify_one();
+    m_thread.join();   // the thread drains the pending slot first
+}
+
+bool Checkpointer::write(const Policy& model, const CheckpointStats& stats,
+                         const std::string& path) {
+    TRACE_SCOPE("Checkpointer::write", "train");
+    auto& m = checkpointMetrics();
+    auto start = std::chrono::steady_clock::now();
+    const std::string tmp = path + ".tmp";
+    uint64_t bytes = 0;
+    bool ok = writeCheckpoint(tmp, model, stats, &bytes) && renameDurable(tmp, path);
+    m.latency.observeNs(nsSince(start));
+    if (ok) {
+        m_written.fetch_add(1, std::memory_order_relaxed);
+        m.written.inc();
+        m.bytes.inc(bytes);
+    } else {
+        std::remove(tmp.c_str());
+        m_failures.fetch_add(1, std::memory_order_relaxed);
+        m.failures.inc();
+    }
+    return ok;
+}
+
+void Checkpointer::threadMain() {
+    if (trace::enabled()) trace::setThreadName("checkpointer");
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;) {
+        m_cv.wait(lock, [this] { return !m_pending.empty() || m_stopping; });
+        if (m_pending.empty()) break;   // stopping with nothing left to write
+        Job job = std::move(m_pending.front());
+        m_pending.erase(m_pending.begin());
+        m_busy = true;
+        lock.unlock();
+        write(*job.model, job.stats, job.path);
+        job.model.reset();
+        lock.lock();
+        m_busy = false;
+        if (m_pending.empty()) m_idleCv.notify_all();
+    }
+    m_idleCv.notify_all();
+}
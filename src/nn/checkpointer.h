@@ -0,0 +1,95 @@
+#pragma once
+
+#include "checkpoint.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// When to take a checkpoint.  A generation is due if `everyGenerations`
+// have passed since the last checkpoint, or if the average loss has fallen
+// by at least `minImprovement` (relative) since then.  Shutdown always
+// checkpoints.
+struct CheckpointPolicy {
+    int   everyGenerations = 10;     // 0 disables the periodic trigger
+    float minImprovement   = 0.05f;  // <= 0 disables the improvement trigger
+};
+
+// ── Checkpointer ──────────────────────────────────────────────────────────────
+//
+// Writes model checkpoints on a background thread so the evolution loop only
+// pays for taking a weight snapshot.  submit() hands over an immutable
+// Policy snapshot; the writer thread saves and fsync()s it to `<path>.tmp`,
+// rename()s it over `path` and fsync()s the directory, so readers (and a
+// crash or power loss mid-write) only ever see a complete file.  If a write to the same path is still pending when a new
+// snapshot arrives the older one is replaced (counted as coalesced): only
+// the newest weights matter.
+//
+// Metrics: wqb_checkpoint_seconds (write, sync + rename latency),
+// wqb_checkpoints_total, wqb_checkpoint_bytes_total,
+// wqb_checkpoint_failures_total and wqb_checkpoints_coalesced_total.
+// ─────────────────────────────────────────────────────────────────────────────
+
+class Checkpointer {
+public:
+    explicit Checkpointer(CheckpointPolicy policy = {});
+    ~Checkpointer();
+
+    Checkpointer(const Checkpointer&) = delete;
+    Checkpointer& operator=(const Checkpointer&) = delete;
+
+    void setPolicy(const CheckpointPolicy& policy) { m_policy = policy; }
+    const CheckpointPolicy& policy() const { return m_policy; }
+
+    // True if the trigger policy wants a checkpoint at `generation` given
+    // the current average loss; mark() records one that was taken.  Caller
+    // thread only.
+    bool due(int generation, float avgLoss) const;
+    void mark(int generation, float avgLoss);
+
+    // Queue `model` for writing to `path`.  Starts the writer thread on
+    // first use.
+    void submit(std::shared_ptr<const Policy> model, const CheckpointStats& stats,
+                const std::string& path);
+
+    // Block until every submitted checkpoint has been written (or failed).
+    void flush();
+    // flush() and join the writer thread
+    void stop();
+
+    uint64_t written()   const { return m_written.load(std::memory_order_relaxed); }
+    uint64_t failures()  const { return m_failures.load(std::memory_order_relaxed); }
+    uint64_t coalesced() const { return m_coalesced.load(std::memory_order_relaxed); }
+
+private:
+    struct Job {
+        std::shared_ptr<const Policy> model;
+        CheckpointStats stats;
+        std::string     path;
+    };
+
+    void threadMain();
+    bool write(const Policy& model, const CheckpointStats& stats, const std::string& path);
+
+    CheckpointPolicy m_policy;
+    // trigger state (caller thread)
+    int   m_lastGeneration = 0;
+    float m_lastLoss       = -1.0f;   // < 0: nothing checkpointed yet
+
+    std::thread             m_thread;
+    std::mutex              m_mutex;        // guards the fields below
+    std::condition_variable m_cv;
+    std::condition_variable m_idleCv;
+    std::vector<Job>        m_pending;      // at most one per path, FIFO
+    bool                    m_busy     = false;   // writer holds a job
+    bool                    m_stopping = false;
+
+    std::atomic<uint64_t> m_written{0};
+    std::atomic<uint64_t> m_failures{0};
+    std::atomic<uint64_t> m_coalesced{0};
+};
@@ -1,17 +1,128 @@
 #include "nn/feature.h"
 #include "base64.h"
+#include "metrics.h"
+
+namespace {
+struct FeatureMetrics {
+    Counter& decodes = metrics().counter("wqb_kernel_decodes_total", "Kernels base64-decoded and parsed for features");
+    Counter& hits    = metrics().counter("wqb_feature_cache_hits_total", "Kernel feature lookups served from the cache");
+};
+
+FeatureMetrics& featureMetrics() {
+    static FeatureMetrics m;
+    return m;
+}
+
+std::shared_ptr<const KernelFeatures> decodeKernel(const std::vector<uint8_t>& bytes) {
+    auto f = std::make_shared<KernelFeatures>();
+    f->opcodes = extractCodeSectionOpcodes(bytes);
+    uint32_t counts[256] = {};
+    for (uint8_t op : f->opcodes) ++counts[op];
+    for (int op = 0; op < 256; ++op)
+        if (counts[op]) f->histogram.push(op, (float)counts[op]);
+    return f;
+}
+} // namespace
+
+// ─── FeatureCache ────────────────────────────────────────────────────────────
+
+FeatureCache::FeatureCache(size_t capacity) : m_capacity(capacity ? capacity : 1) {
+    featureMetrics();
+}
+
+FeatureCache& FeatureCache::global() {
+    static FeatureCache cache;
+    return cache;
+}
+
+std::shared_ptr<const KernelFeatures> FeatureCache::get(const std::string& kernelBase64,
+                                                        const std::vector<uint8_t>* decoded) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    auto it = m_map.find(kernelBase64);
+    if (it != m_map.end()) {
+        ++m_hits;
+        featureMetrics().hits.inc();
+        return it->second;
+    }
+    auto pending = m_inFlight.find(kernelBase64);
+    if (pending != m_inFlight.end()) {
+        // another thread is decoding this kernel; wait for its result
+        ++m_hits;
+        featureMetrics().hits.inc();
+        auto result = pending->second;
+        lock.unlock();
+        return result.get();
+    }
+    std::promise<std::shared_ptr<const KernelFeatures>> promise;
+    m_inFlight.emplace(kernelBase64, promise.get_future().share());
+    lock.unlock();
+
+    std::shared_ptr<const KernelFeatures> f;
+    try {
+        f = decoded ? decodeKernel(*decoded) : decodeKernel(base64_decode(kernelBase64));
+    } catch (...) {
+        lock.lock();
+        m_inFlight.erase(kernelBase64);
+        lock.unlock();
+        promise.set_exception(std::current_exception());
+        throw;
+    }
+
+    lock.lock();
+    m_inFlight.erase(kernelBase64);
+    ++m_decodes;
+    featureMetrics().decodes.inc();
+    while (m_map.size() >= m_capacity && !m_order.empty()) {
+        m_map.erase(m_order.front());
+        m_order.pop_front();
+    }
+    m_map.emplace(kernelBase64, f);
+    m_order.push_back(kernelBase64);
+    lock.unlock();
+    promise.set_value(f);
+    return f;
+}
+
+void FeatureCache::clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_map.clear();
+    m_order.clear();
+}
+
+size_t FeatureCache::size() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_map.size();
+}
+
+uint64_t FeatureCache::decodes() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_decodes;
+}
+
+uint64_t FeatureCache::hits() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_hits;
+}
+
+// ─── Feature ─────────────────────────────────────────────────────────────────
+
+std::shared_ptr<const KernelFeatures> Feature::kernel(const TelemetryEntry& entry) {
+    if (entry.features) return entry.features;
+    if (entry.kernelBase64.empty()) {
+        static const auto empty = std::make_shared<const KernelFeatures>();
+        return empty;
+    }
+    return FeatureCache::global().get(entry.kernelBase64);
+}
 
 std::vector<float> Feature::extract(const TelemetryEntry& entry) {
     std::vector<float> vec(kFeatSize, 0.0f);
     if (entry.kernelBase64.empty()) return vec;
 
-    auto bytes = base64_decode(entry.kernelBase64);
-    auto instrs = extractCodeSection(bytes);
-    for (auto& inst : instrs) {
-        uint8_t op = inst.opcode;
-        vec[op] += 1.0f;  // indices 0-255: opcode frequency counts
-        // indices 256-1023: reserved for future features (currently zero)
-    }
+    // indices 0-255: opcode frequency counts
+    // indices 256-1023: reserved for future features (currently zero)
+    const SparseVector& hist = kernel(entry)->histogram;
+    for (size_t k = 0; k < hist.size(); ++k) vec[hist.index[k]] = hist.value[k];
     // simple supplemental feature: if this entry contained a trap code, set
     // a flag in the first spare slot.  This is part of the "feature
     // iteration" task from issue #101.
@@ -21,8 +132,16 @@ std::vector<float> Feature::extract(const TelemetryEntry& entry) {
     return vec;
 }
 
+void Feature::extractSparse(const TelemetryEntry& entry, SparseVector& out) {
+    out.clear();
+    if (entry.kernelBase64.empty()) return;
+    const SparseVector& hist = kernel(entry)->histogram;
+    out.index.assign(hist.index.begin(), hist.index.end());
+    out.value.assign(hist.value.begin(), hist.value.end());
+    if (!entry.trapCode.empty() && kFeatSize > 256) out.push(256, 1.0f);
+}
+
 std::vector<uint8_t> Feature::extractSequence(const TelemetryEntry& entry) {
     if (entry.kernelBase64.empty()) return {};
-    auto bytes = base64_decode(entry.kernelBase64);
-    return extractCodeSectionOpcodes(bytes);
+    return kernel(entry)->opcodes;
 }
@@ -1,20 +1,89 @@
 #pragma once
 
 #include "nn/advisor.h"
+#include "nn/policy.h"   // SparseVector
 #include "wasm/parser.h"
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 // Feature vector size: 256 opcode-frequency slots (indices 0-255) plus
 // 768 reserved slots for future features, giving a total of 1024 features.
 static constexpr int kFeatSize = 1024;
 
+// Everything the models need from one kernel, decoded once.  Immutable and
+// shared: TelemetryEntry::features, the replay buffer and FeatureCache all
+// point at the same instance.
+struct KernelFeatures {
+    std::vector<uint8_t> opcodes;     // code-section opcode sequence
+    SparseVector         histogram;   // opcode -> count, ascending, non-zero only
+};
+
+// ── FeatureCache ──────────────────────────────────────────────────────────────
+//
+// Process-wide map from a kernel's base64 text to its KernelFeatures, so a
+// kernel is base64-decoded and parsed at most once however many times the
+// Advisor, Trainer (observe, replay, corpus training) and App ask for it.
+// Bounded: past `capacity` kernels the oldest entries are dropped (entries
+// that already hold their features keep them).  Thread-safe; the decode
+// runs outside the lock, and callers that miss on a kernel another thread
+// is already decoding wait for that result instead of decoding it twice.
+//
+// Metrics: wqb_kernel_decodes_total and wqb_feature_cache_hits_total.
+// ─────────────────────────────────────────────────────────────────────────────
+
+class FeatureCache {
+public:
+    static constexpr size_t kDefaultCapacity = 4096;
+
+    explicit FeatureCache(size_t capacity = kDefaultCapacity);
+
+    // the instance Feature uses
+    static FeatureCache& global();
+
+    // Features of `kernelBase64`, decoding it on a miss.  Callers that
+    // already hold the decoded module bytes pass them as `decoded` to skip
+    // the base64 step.
+    std::shared_ptr<const KernelFeatures> get(const std::string& kernelBase64,
+                                              const std::vector<uint8_t>* decoded = nullptr);
+
+    void   clear();
+    size_t size() const;
+    // kernels decoded / lookups served from the cache since construction
+    uint64_t decodes() const;
+    uint64_t hits() const;
+
+private:
+    size_t m_capacity;
+    mutable std::mutex m_mutex;
+    std::unordered_map<std::string, std::shared_ptr<const KernelFeatures>> m_map;
+    std::deque<std::string> m_order;   // insertion order, for eviction
+    // kernels being decoded right now, outside the lock
+    std::unordered_map<std::string,
+                       std::shared_future<std::shared_ptr<const KernelFeatures>>> m_inFlight;
+    uint64_t m_decodes = 0;
+    uint64_t m_hits    = 0;
+};
+
 // Convert a telemetry entry (kernel/mutation) into a fixed-length
 // numeric feature vector suitable for feeding into a neural policy.
 // Current implementation counts opcode frequencies in the kernel.
 class Feature {
 public:
+    // Decoded features of the entry's kernel: entry.features when set,
+    // otherwise FeatureCache::global().  Never null (empty for an entry
+    // without a kernel).
+    static std::shared_ptr<const KernelFeatures> kernel(const TelemetryEntry& entry);
+
     // return vector of kFeatSize floats (opcode histogram + extra features)
     static std::vector<float> extract(const TelemetryEntry& entry);
+    // the non-zero slots of extract() in ascending order, into `out`
+    static void extractSparse(const TelemetryEntry& entry, SparseVector& out);
 
     // decode the kernel and return the raw opcode sequence (one byte per
     // instruction).  Useful for sequence-based models and training.
@@ -0,0 +1,53 @@
+#include "nn/ngram.h"
+
+#include <cmath>
+
+static const double kLogBackoff = std::log(OpcodeNgram::kBackoff);
+
+OpcodeNgram::OpcodeNgram()
+    : m_uni(256, 0), m_bi(256 * 256, 0), m_biCtx(256, 0), m_triCtx(256 * 256, 0) {}
+
+void OpcodeNgram::add(const std::vector<uint8_t>& seq) {
+    ++m_sequences;
+    for (size_t i = 0; i < seq.size(); ++i) {
+        const uint32_t c = seq[i];
+        ++m_uni[c];
+        ++m_total;
+        if (i >= 1) {
+            const uint32_t b = seq[i - 1];
+            ++m_bi[b << 8 | c];
+            ++m_biCtx[b];
+            if (i >= 2) {
+                const uint32_t a = seq[i - 2];
+                ++m_tri[a << 16 | b << 8 | c];
+                ++m_triCtx[a << 8 | b];
+            }
+        }
+    }
+}
+
+double OpcodeNgram::logProb(int a, int b, int c) const {
+    double penalty = 0.0;   // kLogBackoff per backoff step
+    if (a >= 0 && m_triCtx[(uint32_t)a << 8 | (uint32_t)b] > 0) {
+        auto it = m_tri.find((uint32_t)a << 16 | (uint32_t)b << 8 | (uint32_t)c);
+        if (it != m_tri.end())
+            return std::log((double)it->second / m_triCtx[(uint32_t)a << 8 | (uint32_t)b]);
+        penalty += kLogBackoff;
+    }
+    if (b >= 0 && m_biCtx[b] > 0) {
+        uint32_t n = m_bi[(uint32_t)b << 8 | (uint32_t)c];
+        if (n > 0) return penalty + std::log((double)n / m_biCtx[b]);
+        penalty += kLogBackoff;
+    }
+    return penalty + std::log((m_uni[c] + 1.0) / ((double)m_total + 256.0));
+}
+
+double OpcodeNgram::logLikelihood(const uint8_t* seq, size_t n) const {
+    double ll = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        int a = i >= 2 ? seq[i - 2] : -1;
+        int b = i >= 1 ? seq[i - 1] : -1;
+        ll += logProb(a, b, seq[i]);
+    }
+    return ll;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// ── OpcodeNgram ───────────────────────────────────────────────────────────────
+//
+// Trigram language model over opcode bytes with "stupid backoff": a trigram
+// seen in training scores count(a,b,c) / count(a,b,·); otherwise the model
+// backs off to the bigram (and then to an add-one unigram), multiplying by
+// kBackoff at each step.  The scores are not normalised probabilities, but
+// they compare well between two models trained the same way, which is all
+// Advisor needs (successful vs trapped kernels).
+//
+// add() is incremental and never rescans earlier sequences.  Unigram and
+// bigram counts live in flat arrays and trigrams in a hash map, so
+// logLikelihood() costs one hash lookup and a few array reads per opcode.
+// ─────────────────────────────────────────────────────────────────────────────
+
+class OpcodeNgram {
+public:
+    static constexpr double kBackoff = 0.4;
+
+    OpcodeNgram();
+
+    // count every unigram, bigram and trigram of `seq`
+    void add(const std::vector<uint8_t>& seq);
+
+    // sum of ln P(op_i | op_{i-2}, op_{i-1}) over `seq` (0 when empty);
+    // the first opcodes use the shorter histories available
+    double logLikelihood(const uint8_t* seq, size_t n) const;
+    double logLikelihood(const std::vector<uint8_t>& seq) const {
+        return logLikelihood(seq.data(), seq.size());
+    }
+
+    size_t   sequences() const { return m_sequences; }
+    uint64_t tokens()    const { return m_total; }
+
+private:
+    double logProb(int a, int b, int c) const;   // a/b < 0: no such history
+
+    std::vector<uint32_t> m_uni;       // [c]
+    std::vector<uint32_t> m_bi;        // [b << 8 | c]
+    std::vector<uint32_t> m_biCtx;     // [b]: bigrams starting with b
+    std::vector<uint32_t> m_triCtx;    // [a << 8 | b]: trigrams starting with a,b
+    std::unordered_map<uint32_t, uint32_t> m_tri;   // a << 16 | b << 8 | c
+    uint64_t m_total     = 0;
+    size_t   m_sequences = 0;
+};
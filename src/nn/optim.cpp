@@ -0,0 +1,91 @@
+#include "nn/optim.h"
+#include <cmath>
+
+void Optimizer::reset() {
+    m_t = 0;
+    m_m.clear();
+    m_v.clear();
+}
+
+void Optimizer::step(Policy& p, const Policy::Gradients& g, float scale) {
+    const int layers = p.layerCount();
+    if ((int)g.w.size() != layers || (int)g.b.size() != layers) return;
+
+    // parameter blocks in a fixed order: weights of every layer, then biases
+    auto param = [&](int k) { return k < layers ? p.layerWeightsMut(k) : p.layerBiasesMut(k - layers); };
+    auto grad  = [&](int k) -> const std::vector<float>& { return k < layers ? g.w[k] : g.b[k - layers]; };
+    const int blocks = 2 * layers;
+
+    if ((int)m_m.size() != blocks) {
+        m_m.assign(blocks, {});
+        m_v.assign(blocks, {});
+        for (int k = 0; k < blocks; ++k) {
+            m_m[k].assign(param(k).size, 0.0f);
+            if (m_cfg.kind == Kind::ADAM) m_v[k].assign(param(k).size, 0.0f);
+        }
+    }
+
+    // Row-sparse embedding blocks are visited only at the rows backward()
+    // touched; every other block is dense.
+    auto forSpans = [&](int k, auto&& fn) {
+        if (k < layers && g.sparse((size_t)k)) {
+            const size_t n = (size_t)g.rowSize[k];
+            for (int r : g.rows[k]) fn((size_t)r * n, n);
+        } else {
+            fn(0, grad(k).size());
+        }
+    };
+
+    if (m_cfg.clipNorm > 0.0f) {
+        double sq = 0.0;
+        for (int k = 0; k < blocks; ++k) {
+            const float* gk = grad(k).data();
+            forSpans(k, [&](size_t off, size_t n) {
+                for (size_t j = off; j < off + n; ++j) sq += (double)gk[j] * gk[j];
+            });
+        }
+        float norm = (float)std::sqrt(sq) * scale;
+        if (norm > m_cfg.clipNorm) scale *= m_cfg.clipNorm / norm;
+    }
+
+    ++m_t;
+    const float lr = m_cfg.lr;
+    if (m_cfg.kind == Kind::SGD_MOMENTUM) {
+        const float mu = m_cfg.momentum;
+        for (int k = 0; k < blocks; ++k) {
+            ParamView w = param(k);
+            const float* gk = grad(k).data();
+            float* vel = m_m[k].data();
+            if (grad(k).size() != w.size) continue;
+            forSpans(k, [&](size_t off, size_t n) {
+                for (size_t j = off; j < off + n; ++j) {
+                    vel[j] = mu * vel[j] + scale * gk[j];
+                    w[j] -= lr * vel[j];
+                }
+            });
+        }
+        return;
+    }
+
+    // Lazy Adam on sparse rows: an untouched row keeps its moments and
+    // weights as they are rather than decaying towards zero every step.
+    const float b1 = m_cfg.beta1, b2 = m_cfg.beta2;
+    const float c1 = 1.0f - std::pow(b1, (float)m_t);
+    const float c2 = 1.0f - std::pow(b2, (float)m_t);
+    const float stepSize = lr * std::sqrt(c2) / c1;   // folds both bias corrections
+    for (int k = 0; k < blocks; ++k) {
+        ParamView w = param(k);
+        const float* gk = grad(k).data();
+        float* m = m_m[k].data();
+        float* v = m_v[k].data();
+        if (grad(k).size() != w.size) continue;
+        forSpans(k, [&](size_t off, size_t n) {
+            for (size_t j = off; j < off + n; ++j) {
+                float gj = scale * gk[j];
+                m[j] = b1 * m[j] + (1.0f - b1) * gj;
+                v[j] = b2 * v[j] + (1.0f - b2) * gj * gj;
+                w[j] -= stepSize * m[j] / (std::sqrt(v[j]) + m_cfg.eps);
+            }
+        });
+    }
+}
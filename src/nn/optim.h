@@ -0,0 +1,54 @@
+#pragma once
+
+#include "nn/policy.h"
+#include <vector>
+
+// ── Optimizer ─────────────────────────────────────────────────────────────────
+//
+// Applies accumulated Policy::Gradients to a Policy in place.  Two update
+// rules are available: SGD with momentum and Adam (the default).  The global
+// gradient norm is clipped to Config::clipNorm before either rule runs, which
+// keeps the first steps through the LSTM from exploding.
+//
+// Embedding gradients are row-sparse (Policy::Gradients::rows), so for those
+// blocks the clip norm, the moments and the update cover only the rows the
+// batch touched; Adam is "lazy" there, leaving untouched rows and their
+// moments as they were.
+//
+// Moment buffers are sized on the first step() and reused afterwards, so an
+// optimizer step does not allocate once training is under way.
+// ─────────────────────────────────────────────────────────────────────────────
+
+class Optimizer {
+public:
+    enum class Kind { SGD_MOMENTUM, ADAM };
+
+    struct Config {
+        Kind  kind     = Kind::ADAM;
+        float lr       = 3e-3f;
+        float momentum = 0.9f;     // SGD_MOMENTUM
+        float beta1    = 0.9f;     // ADAM
+        float beta2    = 0.999f;   // ADAM
+        float eps      = 1e-8f;    // ADAM
+        float clipNorm = 1.0f;     // <= 0 disables clipping
+    };
+
+    Optimizer() = default;
+    explicit Optimizer(const Config& cfg) : m_cfg(cfg) {}
+
+    // p -= update(scale * g).  `scale` is typically 1 / (steps in batch).
+    void step(Policy& p, const Policy::Gradients& g, float scale = 1.0f);
+
+    // forget moment estimates and the step count
+    void reset();
+
+    const Config& config() const { return m_cfg; }
+    long          steps()  const { return m_t; }
+
+private:
+    Config m_cfg;
+    long   m_t = 0;
+    // first/second moments (Adam) or velocity in m_m (SGD); one entry per
+    // weight block then one per bias block
+    std::vector<std::vector<float>> m_m, m_v;
+};
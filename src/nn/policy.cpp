@@ -12,6 +12,16 @@ void Policy::addDense(int inSize, int outSize) {
     m_layers.push_back(std::move(layer));
 }
 
+void Policy::addEmbedding(int inSize, int outSize) {
+    addDense(inSize, outSize);
+    m_layers.back().type = LayerType::EMBEDDING;  // same sizes, row-per-input layout
+}
+
+void Policy::addLinear(int inSize, int outSize) {
+    addDense(inSize, outSize);
+    m_layers.back().type = LayerType::LINEAR;
+}
+
 void Policy::addLSTM(int inSize, int hiddenSize) {
     Layer layer;
     layer.type = LayerType::LSTM;
@@ -37,81 +47,356 @@ void Policy::addLSTM(int inSize, int hiddenSize) {
 
 // ─── LSTM step ───────────────────────────────────────────────────────────────
 
-void Policy::applyLSTM(const Layer& layer, std::vector<float>& current) const {
-    int hidden   = layer.out;
-    int total_in = layer.in + hidden;
-
-    // Concatenate input with previous hidden state: xh = [current; lstmH]
-    std::vector<float> xh(current);
-    xh.insert(xh.end(), layer.lstmH.begin(), layer.lstmH.end());
-
-    // Compute raw gate activations: 4 × hidden
-    std::vector<float> gates(4 * hidden, 0.0f);
-    for (int g = 0; g < 4; ++g) {
-        int woff = g * hidden * total_in;
-        int boff = g * hidden;
-        for (int h = 0; h < hidden; ++h) {
-            float sum = layer.biases[boff + h];
-            for (int x = 0; x < total_in; ++x)
-                sum += layer.weights[woff + h * total_in + x] * xh[x];
-            gates[g * hidden + h] = sum;
-        }
-    }
+void Policy::applyLSTM(const Layer& layer, const std::vector<float>& x,
+                       std::vector<float>& y, Workspace& ws,
+                       LstmTrace* trace) const {
+    const int hidden   = layer.out;
+    const int total_in = layer.in + hidden;
+
+    // Concatenate input with previous hidden state: xh = [x; lstmH]
+    // (inputs shorter than the layer are zero-padded)
+    ws.xh.assign(total_in, 0.0f);
+    std::copy_n(x.begin(), std::min((int)x.size(), layer.in), ws.xh.begin());
+    std::copy(layer.lstmH.begin(), layer.lstmH.end(), ws.xh.begin() + layer.in);
+
+    // Raw gate activations: the [4, hidden, total_in] tensor is one
+    // (4*hidden) x total_in matrix, so all four gates are a single GEMV
+    ws.gates.resize(4 * hidden);
+    simd::gemv(layer.weights.data(), 4 * hidden, total_in, ws.xh.data(),
+               layer.biases.data(), ws.gates.data());
 
     // Apply activations: gates 0,1,3 = sigmoid; gate 2 (cell) = tanh
-    for (int g = 0; g < 4; ++g) {
-        for (int h = 0; h < hidden; ++h) {
-            float& v = gates[g * hidden + h];
-            if (g == 2)
-                v = std::tanh(v);
-            else
-                v = 1.0f / (1.0f + std::exp(-v));
-        }
+    float* f = ws.gates.data();
+    float* i = f + hidden;
+    float* g = i + hidden;
+    float* o = g + hidden;
+    simd::sigmoid(f, 2 * hidden);   // forget + input
+    simd::tanh(g, hidden);          // cell candidate
+    simd::sigmoid(o, hidden);       // output
+
+    if (trace) {
+        trace->xh.assign(ws.xh.begin(), ws.xh.end());
+        trace->gates.assign(ws.gates.begin(), ws.gates.end());
+        trace->cPrev.assign(layer.lstmC.begin(), layer.lstmC.end());
     }
 
     // Update cell and hidden states
     // c = forget * c_prev + input * cell_candidate
     // h = output * tanh(c)
-    for (int h = 0; h < hidden; ++h) {
-        float f = gates[0 * hidden + h]; // forget
-        float i = gates[1 * hidden + h]; // input
-        float g = gates[2 * hidden + h]; // cell candidate
-        float o = gates[3 * hidden + h]; // output
-        layer.lstmC[h] = f * layer.lstmC[h] + i * g;
-        layer.lstmH[h] = o * std::tanh(layer.lstmC[h]);
+    simd::lstmCell(f, i, g, o, layer.lstmC.data(), layer.lstmH.data(), hidden);
+    if (trace) trace->c.assign(layer.lstmC.begin(), layer.lstmC.end());
+    y.assign(layer.lstmH.begin(), layer.lstmH.end());
+}
+
+// ─── Embedding ───────────────────────────────────────────────────────────────
+
+void Policy::applyEmbedding(const Layer& layer, const int* index, const float* value,
+                            size_t nnz, std::vector<float>& y) const {
+    y.assign(layer.biases.begin(), layer.biases.end());
+    for (size_t k = 0; k < nnz; ++k) {
+        int i = index[k];
+        if (i < 0 || i >= layer.in) continue;
+        simd::axpy(value[k], layer.weights.data() + (size_t)i * layer.out,
+                   y.data(), layer.out);
     }
-    current = layer.lstmH;
+    simd::relu(y.data(), layer.out);
 }
 
 // ─── Forward pass ────────────────────────────────────────────────────────────
 
+void Policy::prepare(Workspace& ws) const {
+    ws.acts.resize(m_layers.size() + 1);
+    size_t maxIn = 0, maxXh = 0, maxGates = 0;
+    for (size_t l = 0; l < m_layers.size(); ++l) {
+        const Layer& layer = m_layers[l];
+        ws.acts[l].reserve(layer.in);
+        ws.acts[l + 1].reserve(layer.out);
+        maxIn = std::max(maxIn, (size_t)layer.in);
+        if (layer.type == LayerType::LSTM) {
+            maxXh    = std::max(maxXh, (size_t)(layer.in + layer.out));
+            maxGates = std::max(maxGates, (size_t)(4 * layer.out));
+        }
+    }
+    ws.xh.reserve(maxXh);
+    ws.gates.reserve(maxGates);
+    ws.padded.reserve(maxIn);
+    ws.nzIndex.reserve(maxIn);
+    ws.nzValue.reserve(maxIn);
+}
+
+void Policy::runLayers(size_t first, Workspace& ws, LstmTrace* traces) const {
+    for (size_t l = first; l < m_layers.size(); ++l) {
+        const Layer& layer = m_layers[l];
+        const std::vector<float>& x = ws.acts[l];
+        std::vector<float>& y = ws.acts[l + 1];   // output of layer l
+        if (layer.type == LayerType::DENSE || layer.type == LayerType::LINEAR) {
+            const float* in = x.data();
+            if ((int)x.size() < layer.in) {
+                ws.padded.assign(layer.in, 0.0f);
+                std::copy(x.begin(), x.end(), ws.padded.begin());
+                in = ws.padded.data();
+            }
+            y.resize(layer.out);
+            simd::gemv(layer.weights.data(), layer.out, layer.in, in,
+                       layer.biases.data(), y.data());
+            if (layer.type == LayerType::DENSE) simd::relu(y.data(), layer.out);
+        } else if (layer.type == LayerType::EMBEDDING) {
+            // dense input: gather the rows of the non-zero entries only
+            ws.nzIndex.clear();
+            ws.nzValue.clear();
+            int n = std::min((int)x.size(), layer.in);
+            for (int i = 0; i < n; ++i) {
+                if (x[i] != 0.0f) {
+                    ws.nzIndex.push_back(i);
+                    ws.nzValue.push_back(x[i]);
+                }
+            }
+            applyEmbedding(layer, ws.nzIndex.data(), ws.nzValue.data(),
+                           ws.nzIndex.size(), y);
+        } else {
+            applyLSTM(layer, x, y, ws, traces ? &traces[l] : nullptr);
+        }
+    }
+}
+
+const std::vector<float>& Policy::forward(const std::vector<float>& input,
+                                          Workspace& ws) const {
+    if (ws.acts.size() != m_layers.size() + 1) prepare(ws);
+    ws.acts[0].assign(input.begin(), input.end());   // acts[0] = raw input
+    runLayers(0, ws);
+    return ws.acts.back();
+}
+
+const std::vector<float>& Policy::forward(const SparseVector& input,
+                                          Workspace& ws) const {
+    return forwardSparse(input, ws, nullptr);
+}
+
+const std::vector<float>& Policy::forwardSparse(const SparseVector& input, Workspace& ws,
+                                                LstmTrace* traces) const {
+    if (ws.acts.size() != m_layers.size() + 1) prepare(ws);
+    ws.acts[0].clear();                    // sparse input is not densified
+    if (m_layers.empty()) return ws.acts.back();
+
+    const Layer& first = m_layers[0];
+    std::vector<float>& y = ws.acts[1];
+    if (first.type == LayerType::EMBEDDING) {
+        applyEmbedding(first, input.index.data(), input.value.data(),
+                       input.size(), y);
+    } else if (first.type == LayerType::DENSE || first.type == LayerType::LINEAR) {
+        // column gather over the row-major (out×in) matrix
+        y.assign(first.biases.begin(), first.biases.end());
+        for (size_t k = 0; k < input.size(); ++k) {
+            int i = input.index[k];
+            if (i < 0 || i >= first.in) continue;
+            for (int o = 0; o < first.out; ++o)
+                y[o] += first.weights[(size_t)o * first.in + i] * input.value[k];
+        }
+        if (first.type == LayerType::DENSE) simd::relu(y.data(), first.out);
+    } else {
+        ws.padded.assign(first.in, 0.0f);
+        for (size_t k = 0; k < input.size(); ++k)
+            if (input.index[k] >= 0 && input.index[k] < first.in)
+                ws.padded[input.index[k]] += input.value[k];
+        applyLSTM(first, ws.padded, y, ws, traces);
+    }
+    runLayers(1, ws, traces);
+    return ws.acts.back();
+}
+
 void Policy::forwardActivations(const std::vector<float>& input,
                                 std::vector<std::vector<float>>& activations) const {
-    activations.clear();
-    activations.push_back(input);          // activations[0] = raw input
-    std::vector<float> current = input;
-    for (const auto& layer : m_layers) {
-        if (layer.type == LayerType::DENSE) {
-            std::vector<float> next(layer.out, 0.0f);
-            for (int o = 0; o < layer.out; ++o) {
-                float sum = layer.biases[o];
-                for (int i = 0; i < layer.in; ++i)
-                    sum += layer.weights[o * layer.in + i] * current[i];
-                next[o] = sum;
+    Workspace ws;
+    forward(input, ws);
+    activations = std::move(ws.acts);
+}
+
+void Policy::forwardActivations(const SparseVector& input,
+                                std::vector<std::vector<float>>& activations) const {
+    Workspace ws;
+    forward(input, ws);
+    activations = std::move(ws.acts);
+}
+
+std::vector<float> Policy::forward(const std::vector<float>& input) const {
+    Workspace ws;
+    return forward(input, ws);
+}
+
+std::vector<float> Policy::forward(const SparseVector& input) const {
+    Workspace ws;
+    return forward(input, ws);
+}
+
+// ─── Batched forward ─────────────────────────────────────────────────────────
+
+void Policy::prepare(BatchState& st, int batch) const {
+    st.batch = batch;
+    st.acts.resize(m_layers.size() + 1);
+    st.h.resize(m_layers.size());
+    st.c.resize(m_layers.size());
+    size_t maxXh = 0, maxGates = 0;
+    for (size_t l = 0; l < m_layers.size(); ++l) {
+        const Layer& layer = m_layers[l];
+        st.acts[l].assign((size_t)batch * layer.in, 0.0f);
+        st.acts[l + 1].assign((size_t)batch * layer.out, 0.0f);
+        if (layer.type == LayerType::LSTM) {
+            st.h[l].assign((size_t)batch * layer.out, 0.0f);
+            st.c[l].assign((size_t)batch * layer.out, 0.0f);
+            maxXh    = std::max(maxXh, (size_t)(layer.in + layer.out));
+            maxGates = std::max(maxGates, (size_t)(4 * layer.out));
+        } else {
+            st.h[l].clear();
+            st.c[l].clear();
+        }
+    }
+    st.xh.assign((size_t)batch * maxXh, 0.0f);
+    st.gates.assign((size_t)batch * maxGates, 0.0f);
+    st.inputs.resize(batch);
+    st.order.reserve(batch);
+}
+
+void Policy::resetState(BatchState& st) const {
+    for (auto& h : st.h) std::fill(h.begin(), h.end(), 0.0f);
+    for (auto& c : st.c) std::fill(c.begin(), c.end(), 0.0f);
+}
+
+const std::vector<float>& Policy::forwardBatch(const SparseVector* inputs, int count,
+                                               BatchState& st) const {
+    if (st.acts.size() != m_layers.size() + 1 || count > st.batch)
+        prepare(st, std::max(count, st.batch));
+    if (m_layers.empty() || count <= 0) return st.acts.back();
+
+    for (size_t l = 0; l < m_layers.size(); ++l) {
+        const Layer& layer = m_layers[l];
+        const int in = layer.in, out = layer.out;
+        float* Y = st.acts[l + 1].data();
+
+        if (l == 0 && layer.type != LayerType::LSTM) {
+            // sparse input, per slot as in forwardSparse()
+            for (int b = 0; b < count; ++b) {
+                const SparseVector& x = inputs[b];
+                float* y = Y + (size_t)b * out;
+                std::copy(layer.biases.begin(), layer.biases.end(), y);
+                for (size_t k = 0; k < x.size(); ++k) {
+                    int i = x.index[k];
+                    if (i < 0 || i >= in) continue;
+                    if (layer.type == LayerType::EMBEDDING) {
+                        simd::axpy(x.value[k], layer.weights.data() + (size_t)i * out, y, out);
+                    } else {
+                        for (int o = 0; o < out; ++o)
+                            y[o] += layer.weights[(size_t)o * in + i] * x.value[k];
+                    }
+                }
+                if (layer.type != LayerType::LINEAR) simd::relu(y, out);
+            }
+            continue;
+        }
+        if (l == 0) {
+            // an LSTM first layer takes the densified input
+            std::fill(st.acts[0].begin(), st.acts[0].begin() + (size_t)count * in, 0.0f);
+            for (int b = 0; b < count; ++b)
+                for (size_t k = 0; k < inputs[b].size(); ++k)
+                    if (inputs[b].index[k] >= 0 && inputs[b].index[k] < in)
+                        st.acts[0][(size_t)b * in + inputs[b].index[k]] += inputs[b].value[k];
+        }
+
+        const float* X = st.acts[l].data();
+        if (layer.type == LayerType::DENSE || layer.type == LayerType::LINEAR) {
+            simd::gemm(layer.weights.data(), out, in, X, count, layer.biases.data(), Y);
+            if (layer.type == LayerType::DENSE) simd::relu(Y, count * out);
+        } else if (layer.type == LayerType::EMBEDDING) {
+            for (int b = 0; b < count; ++b) {
+                const float* x = X + (size_t)b * in;
+                float* y = Y + (size_t)b * out;
+                std::copy(layer.biases.begin(), layer.biases.end(), y);
+                for (int i = 0; i < in; ++i)
+                    if (x[i] != 0.0f)
+                        simd::axpy(x[i], layer.weights.data() + (size_t)i * out, y, out);
+                simd::relu(y, out);
             }
-            relu(next);
-            current.swap(next);
         } else {
-            applyLSTM(layer, current);
+            // LSTM: all slots' [x; h_prev] rows through one GEMM
+            const int total = in + out;
+            for (int b = 0; b < count; ++b) {
+                float* xh = st.xh.data() + (size_t)b * total;
+                std::copy_n(X + (size_t)b * in, in, xh);
+                std::copy_n(st.h[l].data() + (size_t)b * out, out, xh + in);
+            }
+            simd::gemm(layer.weights.data(), 4 * out, total, st.xh.data(), count,
+                       layer.biases.data(), st.gates.data());
+            for (int b = 0; b < count; ++b) {
+                float* f = st.gates.data() + (size_t)b * 4 * out;
+                float* i = f + out;
+                float* g = i + out;
+                float* o = g + out;
+                simd::sigmoid(f, 2 * out);
+                simd::tanh(g, out);
+                simd::sigmoid(o, out);
+                float* h = st.h[l].data() + (size_t)b * out;
+                simd::lstmCell(f, i, g, o, st.c[l].data() + (size_t)b * out, h, out);
+                std::copy_n(h, out, Y + (size_t)b * out);
+            }
         }
-        activations.push_back(current);    // activations[l+1] = output of layer l
     }
+    return st.acts.back();
 }
 
-std::vector<float> Policy::forward(const std::vector<float>& input) const {
-    std::vector<std::vector<float>> acts;
-    forwardActivations(input, acts);
-    return acts.empty() ? input : acts.back();
+void Policy::forwardBatch(const std::vector<std::vector<uint8_t>>& seqs, BatchState& st,
+                          std::vector<std::vector<float>>& outputs) const {
+    const int n = (int)seqs.size();
+    outputs.resize(n);
+    for (auto& o : outputs) o.clear();
+    if (st.acts.size() != m_layers.size() + 1 || st.batch < n) prepare(st, n);
+    resetState(st);
+    if (m_layers.empty()) return;
+
+    // slot k runs the k-th longest sequence, so the live slots at any step
+    // are a prefix and finished sequences are masked by shrinking `count`
+    st.order.resize(n);
+    for (int b = 0; b < n; ++b) st.order[b] = b;
+    std::stable_sort(st.order.begin(), st.order.end(),
+                     [&](int a, int b) { return seqs[a].size() > seqs[b].size(); });
+
+    const int outSize = m_layers.back().out;
+    int count = n;
+    for (size_t t = 0; count > 0; ++t) {
+        while (count > 0 && seqs[st.order[count - 1]].size() <= t) --count;
+        if (count == 0) break;
+        for (int k = 0; k < count; ++k) st.inputs[k].setOneHot(seqs[st.order[k]][t]);
+        const std::vector<float>& y = forwardBatch(st.inputs.data(), count, st);
+        // collect the sequences whose last opcode this was
+        for (int k = count - 1; k >= 0 && seqs[st.order[k]].size() == t + 1; --k) {
+            const float* row = y.data() + (size_t)k * outSize;
+            outputs[st.order[k]].assign(row, row + outSize);
+        }
+    }
+}
+
+ParamView Policy::layerWeightsMut(int i) {
+    if (i < 0 || i >= (int)m_layers.size()) return {};
+    auto& w = m_layers[i].weights;
+    return { w.data(), w.size() };
+}
+
+ParamView Policy::layerBiasesMut(int i) {
+    if (i < 0 || i >= (int)m_layers.size()) return {};
+    auto& b = m_layers[i].biases;
+    return { b.data(), b.size() };
+}
+
+float* Policy::embeddingRow(int layer, int index) {
+    if (layer < 0 || layer >= (int)m_layers.size()) return nullptr;
+    auto& l = m_layers[layer];
+    if (l.type != LayerType::EMBEDDING || index < 0 || index >= l.in) return nullptr;
+    return l.weights.data() + (size_t)index * l.out;
+}
+
+SparseVector SparseVector::fromDense(const std::vector<float>& v) {
+    SparseVector s;
+    for (size_t i = 0; i < v.size(); ++i)
+        if (v[i] != 0.0f) s.push((int)i, v[i]);
+    return s;
 }
 
 void Policy::resetState() {
@@ -133,21 +418,248 @@ std::vector<float> Policy::forwardSequence(const std::vector<std::vector<float>>
 }
 
 void Policy::relu(std::vector<float>& v) {
-    for (auto& x : v) if (x < 0.0f) x = 0.0f;
+    simd::relu(v.data(), (int)v.size());
 }
 
 // ─── Layer weight/bias setters ────────────────────────────────────────────────
 
-void Policy::setLayerWeights(int idx, const std::vector<float>& w) {
+void Policy::setLayerWeights(int idx, const float* w, size_t n) {
     if (idx < 0 || idx >= (int)m_layers.size()) return;
     auto& layer = m_layers[idx];
-    if ((int)w.size() == (int)layer.weights.size())
-        layer.weights = w;
+    if (n == layer.weights.size())
+        std::copy_n(w, n, layer.weights.begin());
 }
 
-void Policy::setLayerBiases(int idx, const std::vector<float>& b) {
+void Policy::setLayerBiases(int idx, const float* b, size_t n) {
     if (idx < 0 || idx >= (int)m_layers.size()) return;
     auto& layer = m_layers[idx];
-    if ((int)b.size() == (int)layer.biases.size())
-        layer.biases = b;
+    if (n == layer.biases.size())
+        std::copy_n(b, n, layer.biases.begin());
+}
+
+// ─── Training ────────────────────────────────────────────────────────────────
+
+void Policy::initWeights(uint32_t seed) {
+    uint32_t lcg = seed * 2654435761u + 0x9e3779b9u;
+    for (auto& layer : m_layers) {
+        if (layer.type == LayerType::LSTM) continue;
+        // an embedding row is selected by a single (one-hot) input, so its
+        // effective fan-in is 1 rather than `in`
+        int fanIn = layer.type == LayerType::EMBEDDING ? 1 : layer.in;
+        float bound = std::sqrt(6.0f / static_cast<float>(fanIn + layer.out));
+        for (auto& w : layer.weights) {
+            lcg = lcg * 1664525u + 1013904223u;
+            w = (static_cast<int32_t>(lcg) / 2147483648.0f) * bound;
+        }
+        std::fill(layer.biases.begin(), layer.biases.end(), 0.0f);
+    }
+}
+
+void Policy::Gradients::zero() {
+    for (size_t l = 0; l < w.size(); ++l) {
+        if (sparse(l)) {
+            const size_t n = (size_t)rowSize[l];
+            for (int r : rows[l]) {
+                std::fill_n(w[l].begin() + (size_t)r * n, n, 0.0f);
+                rowMark[l][r] = 0;
+            }
+            rows[l].clear();
+        } else {
+            std::fill(w[l].begin(), w[l].end(), 0.0f);
+        }
+    }
+    for (auto& v : b) std::fill(v.begin(), v.end(), 0.0f);
+}
+
+void Policy::Gradients::add(const Gradients& o) {
+    for (size_t l = 0; l < w.size() && l < o.w.size(); ++l) {
+        if (sparse(l) && o.sparse(l)) {
+            const int n = rowSize[l];
+            for (int r : o.rows[l]) {
+                simd::axpy(1.0f, o.w[l].data() + (size_t)r * n, w[l].data() + (size_t)r * n, n);
+                touch(l, r);
+            }
+        } else {
+            simd::axpy(1.0f, o.w[l].data(), w[l].data(), (int)std::min(w[l].size(), o.w[l].size()));
+        }
+        simd::axpy(1.0f, o.b[l].data(), b[l].data(), (int)std::min(b[l].size(), o.b[l].size()));
+    }
+}
+
+void Policy::prepare(Gradients& g) const {
+    const size_t n = m_layers.size();
+    g.w.resize(n);
+    g.b.resize(n);
+    g.rowSize.assign(n, 0);
+    g.rows.resize(n);
+    g.rowMark.resize(n);
+    for (size_t l = 0; l < n; ++l) {
+        const Layer& layer = m_layers[l];
+        g.w[l].assign(layer.weights.size(), 0.0f);
+        g.b[l].assign(layer.biases.size(), 0.0f);
+        g.rows[l].clear();
+        if (layer.type == LayerType::EMBEDDING) {
+            g.rowSize[l] = layer.out;
+            g.rows[l].reserve(layer.in);   // touch() never allocates
+            g.rowMark[l].assign(layer.in, 0);
+        } else {
+            g.rowMark[l].clear();
+        }
+    }
+}
+
+void Policy::prepare(Tape& tape) const {
+    prepare(tape.ws);
+    tape.clear();
+    size_t widest = 0;
+    for (const auto& layer : m_layers)
+        widest = std::max({ widest, (size_t)(layer.in + layer.out), (size_t)(4 * layer.out) });
+    tape.delta.reserve(widest);
+    tape.deltaPrev.reserve(widest);
+    tape.dz.reserve(widest);
+    tape.dxh.reserve(widest);
+    tape.dh.resize(m_layers.size());
+    tape.dc.resize(m_layers.size());
+    for (size_t l = 0; l < m_layers.size(); ++l) {
+        size_t n = m_layers[l].type == LayerType::LSTM ? (size_t)m_layers[l].out : 0;
+        tape.dh[l].assign(n, 0.0f);
+        tape.dc[l].assign(n, 0.0f);
+    }
+}
+
+const std::vector<float>& Policy::forward(const SparseVector& input, Tape& tape) const {
+    if (tape.ws.acts.size() != m_layers.size() + 1 || tape.dh.size() != m_layers.size())
+        prepare(tape);
+    if (tape.length == tape.steps.size()) tape.steps.emplace_back();
+    Tape::Step& st = tape.steps[tape.length++];
+    st.lstm.resize(m_layers.size());
+    st.input.index.assign(input.index.begin(), input.index.end());
+    st.input.value.assign(input.value.begin(), input.value.end());
+    st.dOut.clear();
+
+    forwardSparse(input, tape.ws, st.lstm.data());
+    st.acts.resize(tape.ws.acts.size());
+    for (size_t l = 0; l < st.acts.size(); ++l)
+        st.acts[l].assign(tape.ws.acts[l].begin(), tape.ws.acts[l].end());
+    return st.acts.back();
+}
+
+void Policy::backward(Tape& tape, Gradients& g) const {
+    if (m_layers.empty()) return;
+    if (g.w.size() != m_layers.size()) prepare(g);
+    for (size_t l = 0; l < tape.dh.size(); ++l) {
+        std::fill(tape.dh[l].begin(), tape.dh[l].end(), 0.0f);
+        std::fill(tape.dc[l].begin(), tape.dc[l].end(), 0.0f);
+    }
+
+    auto& delta     = tape.delta;       // dLoss/d(output of layer l)
+    auto& deltaPrev = tape.deltaPrev;   // dLoss/d(input of layer l)
+    auto& dz        = tape.dz;          // dLoss/d(pre-activation)
+    const size_t outN = (size_t)m_layers.back().out;
+
+    for (size_t t = tape.length; t-- > 0;) {
+        const Tape::Step& st = tape.steps[t];
+        delta.assign(outN, 0.0f);
+        std::copy_n(st.dOut.begin(), std::min(st.dOut.size(), outN), delta.begin());
+
+        for (size_t l = m_layers.size(); l-- > 0;) {
+            const Layer& layer = m_layers[l];
+            const std::vector<float>& x = st.acts[l];   // empty for the sparse input
+            const std::vector<float>& y = st.acts[l + 1];
+            const bool sparseIn = (l == 0);
+            const bool needPrev = (l > 0);
+            float* gw = g.w[l].data();
+            float* gb = g.b[l].data();
+
+            if (layer.type == LayerType::LSTM) {
+                // c = f*c_prev + i*g;  h = o*tanh(c);  gates from one GEMV over xh
+                const LstmTrace& tr = st.lstm[l];
+                const int h = layer.out, tin = layer.in + h;
+                const float* f  = tr.gates.data();
+                const float* in = f + h;
+                const float* cg = in + h;
+                const float* o  = cg + h;
+                auto& dh = tape.dh[l];
+                auto& dc = tape.dc[l];
+                dz.resize(4 * h);
+                for (int u = 0; u < h; ++u) {
+                    float dhu = delta[u] + dh[u];          // from above + from t+1
+                    float tc  = std::tanh(tr.c[u]);
+                    float dcu = dhu * o[u] * (1.0f - tc * tc) + dc[u];
+                    dz[u]         = dcu * tr.cPrev[u] * f[u] * (1.0f - f[u]);
+                    dz[h + u]     = dcu * cg[u] * in[u] * (1.0f - in[u]);
+                    dz[2 * h + u] = dcu * in[u] * (1.0f - cg[u] * cg[u]);
+                    dz[3 * h + u] = dhu * tc * o[u] * (1.0f - o[u]);
+                    dc[u] = dcu * f[u];                    // to c_prev at t-1
+                }
+                tape.dxh.assign(tin, 0.0f);
+                for (int r = 0; r < 4 * h; ++r) {
+                    gb[r] += dz[r];
+                    simd::axpy(dz[r], tr.xh.data(), gw + (size_t)r * tin, tin);
+                    simd::axpy(dz[r], layer.weights.data() + (size_t)r * tin, tape.dxh.data(), tin);
+                }
+                std::copy_n(tape.dxh.begin() + layer.in, h, dh.begin());   // to h_prev at t-1
+                if (needPrev) deltaPrev.assign(tape.dxh.begin(), tape.dxh.begin() + layer.in);
+            } else {
+                const int n = layer.out;
+                dz.resize(n);
+                for (int o = 0; o < n; ++o)
+                    dz[o] = (layer.type == LayerType::LINEAR || y[o] > 0.0f) ? delta[o] : 0.0f;
+                for (int o = 0; o < n; ++o) gb[o] += dz[o];
+
+                if (layer.type == LayerType::EMBEDDING) {
+                    // row i of W (in×out) received x_i
+                    if (sparseIn) {
+                        for (size_t k = 0; k < st.input.size(); ++k) {
+                            int i = st.input.index[k];
+                            if (i >= 0 && i < layer.in) {
+                                simd::axpy(st.input.value[k], dz.data(), gw + (size_t)i * n, n);
+                                g.touch(l, i);
+                            }
+                        }
+                    } else {
+                        int m = std::min((int)x.size(), layer.in);
+                        for (int i = 0; i < m; ++i) {
+                            if (x[i] != 0.0f) {
+                                simd::axpy(x[i], dz.data(), gw + (size_t)i * n, n);
+                                g.touch(l, i);
+                            }
+                        }
+                    }
+                    if (needPrev) {
+                        deltaPrev.assign(layer.in, 0.0f);
+                        for (int i = 0; i < layer.in; ++i) {
+                            const float* row = layer.weights.data() + (size_t)i * n;
+                            float acc = 0.0f;
+                            for (int o = 0; o < n; ++o) acc += row[o] * dz[o];
+                            deltaPrev[i] = acc;
+                        }
+                    }
+                } else {
+                    // W is out×in: dW[o,:] += dz[o] * x
+                    if (sparseIn) {
+                        for (size_t k = 0; k < st.input.size(); ++k) {
+                            int i = st.input.index[k];
+                            if (i < 0 || i >= layer.in) continue;
+                            for (int o = 0; o < n; ++o)
+                                gw[(size_t)o * layer.in + i] += dz[o] * st.input.value[k];
+                        }
+                    } else {
+                        int m = std::min((int)x.size(), layer.in);
+                        for (int o = 0; o < n; ++o)
+                            if (dz[o] != 0.0f) simd::axpy(dz[o], x.data(), gw + (size_t)o * layer.in, m);
+                    }
+                    if (needPrev) {
+                        deltaPrev.assign(layer.in, 0.0f);
+                        for (int o = 0; o < n; ++o)
+                            if (dz[o] != 0.0f)
+                                simd::axpy(dz[o], layer.weights.data() + (size_t)o * layer.in,
+                                           deltaPrev.data(), layer.in);
+                    }
+                }
+            }
+            if (!needPrev) break;
+            delta.swap(deltaPrev);
+        }
+    }
 }
@@ -1,22 +1,153 @@
 #pragma once
 
-#include <vector>
+#include "nn/simd.h"
 #include <cmath>
+#include <cstdint>
+#include <vector>
 
 // Simple feed-forward neural network policy.  Layers are defined by
 // their weight matrices and biases.  This is *not* a production ML
 // library; it only provides the minimal operations we need for on‑device
-// learning.  Supports Dense (fully-connected) and LSTM layer types.
+// learning.  Supports Dense (fully-connected), Linear (dense without the
+// ReLU, for regression outputs), Embedding and LSTM layer types.
+//
+// Weights live in 64-byte aligned buffers and the forward pass runs on the
+// dispatched kernels in nn/simd.h (AVX2/FMA, SSE2 or scalar).  Hot loops
+// (training) call forward() with a caller-owned Workspace and update
+// parameters in place through layerWeightsMut()/layerBiasesMut(), which
+// together perform no heap allocation once the workspace is prepared.
+//
+// Training records a window of forward steps on a Tape and backward()
+// accumulates exact reverse-mode gradients for every layer, including
+// backpropagation through time across the LSTM steps on the tape.
+
+// Sparse input vector: parallel index/value lists into a logical dense
+// vector.  A one-hot opcode is {{op}, {1.0f}}.  Reuse one instance across
+// calls (clear()/setOneHot()) to keep its capacity.
+struct SparseVector {
+    std::vector<int>   index;
+    std::vector<float> value;
+
+    void clear()                { index.clear(); value.clear(); }
+    void push(int i, float v)   { index.push_back(i); value.push_back(v); }
+    void setOneHot(int i)       { clear(); push(i, 1.0f); }
+    size_t size() const         { return index.size(); }
+
+    // collect the non-zero entries of a dense vector
+    static SparseVector fromDense(const std::vector<float>& v);
+};
+
+// Mutable view of a contiguous parameter block (weights or biases of one
+// layer).  Empty for an invalid layer index.
+struct ParamView {
+    float* data = nullptr;
+    size_t size = 0;
+
+    float* begin() const { return data; }
+    float* end()   const { return data + size; }
+    bool   empty() const { return size == 0; }
+    float& operator[](size_t i) const { return data[i]; }
+};
 
 class Policy {
 public:
-    enum class LayerType { DENSE, LSTM };
+    // values are stored in checkpoints; append new types at the end
+    enum class LayerType { DENSE, LSTM, EMBEDDING, LINEAR };
+
+    // Buffers for one forward pass, reused across calls.  acts[l] is the
+    // input of layer l and acts[l+1] its output; for a sparse input
+    // acts[0] stays empty.  Size it once with prepare(); afterwards
+    // forward(x, ws) does not allocate.
+    struct Workspace {
+        std::vector<std::vector<float>> acts;
+        std::vector<float> xh;       // LSTM [input; h_prev]
+        std::vector<float> gates;    // LSTM gate pre-activations
+        std::vector<float> padded;   // short dense input, zero-extended
+        std::vector<int>   nzIndex;  // dense input -> embedding rows
+        std::vector<float> nzValue;
+    };
+
+    // One gradient buffer per parameter block, shaped like the layers.
+    // Embedding weights are row-sparse: only the rows of a step's non-zero
+    // inputs receive gradient, so backward() lists the rows it wrote in
+    // rows[l] and zero(), add() and Optimizer::step() visit only those.
+    struct Gradients {
+        std::vector<std::vector<float>> w, b;
+        std::vector<int> rowSize;                   // embedding: floats per row; else 0
+        std::vector<std::vector<int>> rows;         // touched rows, each listed once
+        std::vector<std::vector<uint8_t>> rowMark;  // [l][i] != 0 iff i is in rows[l]
+
+        bool sparse(size_t l) const { return l < rowSize.size() && rowSize[l] > 0; }
+        void touch(size_t l, int row) {
+            if (!rowMark[l][row]) {
+                rowMark[l][row] = 1;
+                rows[l].push_back(row);
+            }
+        }
+        void zero();
+        // element-wise `*this += o` (shapes must match)
+        void add(const Gradients& o);
+    };
+
+    // Activations of one LSTM layer for one step, kept for the backward
+    // pass.
+    struct LstmTrace {
+        std::vector<float> xh;      // [input; h_prev]
+        std::vector<float> gates;   // activated f, i, g, o
+        std::vector<float> cPrev;   // cell state before the step
+        std::vector<float> c;       // cell state after the step
+    };
+
+    // Forward steps recorded for backpropagation through time.  Gradient
+    // does not flow into the LSTM state from before the first recorded
+    // step (truncated BPTT).  clear() keeps every buffer's capacity, so a
+    // reused tape stops allocating once it has seen its longest window.
+    struct Tape {
+        struct Step {
+            std::vector<std::vector<float>> acts;  // as Workspace::acts
+            std::vector<LstmTrace> lstm;           // indexed by layer
+            SparseVector input;
+            std::vector<float> dOut;  // dLoss/dOutput; set by the caller
+        };
+        std::vector<Step> steps;
+        size_t length = 0;
+        void clear() { length = 0; }
+        Step& last() { return steps[length - 1]; }
+
+        // scratch shared by forward and backward
+        Workspace ws;
+        std::vector<float> delta, deltaPrev, dz, dxh;
+        std::vector<std::vector<float>> dh, dc;    // carried back through time
+    };
+
+    // Per-sequence LSTM state and scratch for forwardBatch().  Slot b holds
+    // sequence b's state as row b of each buffer; the Policy's own LSTM
+    // state is never touched, so a const Policy can be shared.
+    struct BatchState {
+        int batch = 0;                          // slots sized by prepare()
+        std::vector<std::vector<float>> acts;   // acts[l]: batch x width, one row per slot
+        std::vector<std::vector<float>> h, c;   // per LSTM layer: batch x hidden
+        std::vector<float> xh, gates;           // LSTM [input; h_prev] rows / pre-activations
+        std::vector<SparseVector> inputs;       // forwardBatch(seqs) one-hot inputs
+        std::vector<int> order;                 // forwardBatch(seqs): sequences by length
+    };
 
     Policy() = default;
 
     // add a dense layer with given input/output sizes; weights are zeroed
     void addDense(int inSize, int outSize);
 
+    // add an embedding layer: the same maths as a dense layer,
+    // ReLU(W·x + b), but the weights are stored one row per *input*
+    // ([in, out]), so a sparse or one-hot input costs a few out-sized row
+    // gathers instead of a full in×out matrix-vector product.  Zeroed like
+    // addDense().
+    void addEmbedding(int inSize, int outSize);
+
+    // add a dense layer without the ReLU (y = W·x + b); used for the
+    // regression output so its gradient never dies
+    void addLinear(int inSize, int outSize);
+
     // add an LSTM layer; weights are Xavier-initialised; hidden/cell state
     // starts at zero and persists across forward() calls
     void addLSTM(int inSize, int hiddenSize);
@@ -30,27 +161,97 @@ public:
     void forwardActivations(const std::vector<float>& input,
                             std::vector<std::vector<float>>& activations) const;
 
+    // Sparse-input variants.  Entries whose index is outside the first
+    // layer's input range are ignored.  activations[0] is left empty (the
+    // input is never densified); activations[l+1] is as above.
+    std::vector<float> forward(const SparseVector& input) const;
+    void forwardActivations(const SparseVector& input,
+                            std::vector<std::vector<float>>& activations) const;
+
+    // Size `ws` for this architecture (call again after adding layers).
+    void prepare(Workspace& ws) const;
+    // Allocation-free forward passes into a prepared workspace; every
+    // layer's output is left in ws.acts.  Returns the network output
+    // (ws.acts.back()).
+    const std::vector<float>& forward(const SparseVector& input, Workspace& ws) const;
+    const std::vector<float>& forward(const std::vector<float>& input, Workspace& ws) const;
+
+    // ── Batched forward ───────────────────────────────────────────────────────
+    //
+    // Runs many sequences in lockstep: each layer is one simd::gemm over
+    // all live slots instead of one GEMV per sequence, with per-slot LSTM
+    // state in a BatchState.  Outputs match forward() on a freshly reset
+    // Policy to float rounding.
+
+    // Size `st` for `batch` slots and zero their LSTM state.
+    void prepare(BatchState& st, int batch) const;
+    void resetState(BatchState& st) const;
+    // One step for slots [0, count): inputs[b] feeds slot b.  Slots from
+    // `count` on are masked: their state and output rows are left as they
+    // were, so sequences sorted longest first drop out as they finish.
+    // Returns st.acts.back() (batch x output size).
+    const std::vector<float>& forwardBatch(const SparseVector* inputs, int count,
+                                           BatchState& st) const;
+    // Score whole opcode sequences of any lengths from zero state (one-hot
+    // inputs, like Trainer).  outputs[b] is the network output after the
+    // last opcode of seqs[b]; an empty sequence gives an empty output.
+    void forwardBatch(const std::vector<std::vector<uint8_t>>& seqs, BatchState& st,
+                      std::vector<std::vector<float>>& outputs) const;
+
+    // Xavier-uniform initialise the weights of every Dense, Linear and
+    // Embedding layer from `seed` and zero their biases (LSTM layers are
+    // initialised by addLSTM).  Zero weights cannot be trained by
+    // backpropagation, so call this before training.
+    void initWeights(uint32_t seed);
+
+    // ── Training ──────────────────────────────────────────────────────────────
+
+    // Size gradients (zeroed) / tape scratch for this architecture.
+    void prepare(Gradients& g) const;
+    void prepare(Tape& tape) const;
+    // Forward like forward(x, ws) and append the step to `tape`.
+    const std::vector<float>& forward(const SparseVector& input, Tape& tape) const;
+    // Backpropagate every step on `tape`, newest first, accumulating into
+    // `g`.  Each step's dOut is the loss gradient w.r.t. that step's output
+    // (empty = no loss at that step).  Parameters are not modified.
+    void backward(Tape& tape, Gradients& g) const;
+
     // simple ReLU activation applied in-place
     static void relu(std::vector<float>& v);
 
-    // helpers for testing / save-load: set/get layer weights and biases
-    void setLayerWeights(int idx, const std::vector<float>& w);
-    void setLayerBiases(int idx, const std::vector<float>& b);
+    // helpers for testing / save-load: set/get layer weights and biases;
+    // ignored unless `n` matches the layer's parameter count
+    void setLayerWeights(int idx, const float* w, size_t n);
+    void setLayerBiases(int idx, const float* b, size_t n);
+    template <typename Vec>
+    void setLayerWeights(int idx, const Vec& w) { setLayerWeights(idx, w.data(), w.size()); }
+    template <typename Vec>
+    void setLayerBiases(int idx, const Vec& b)  { setLayerBiases(idx, b.data(), b.size()); }
 
     // read-only accessors for architecture inspection / training
     int       layerCount()             const { return (int)m_layers.size(); }
     int       layerInSize(int i)       const { return (i >= 0 && i < (int)m_layers.size()) ? m_layers[i].in  : 0; }
     int       layerOutSize(int i)      const { return (i >= 0 && i < (int)m_layers.size()) ? m_layers[i].out : 0; }
     LayerType layerType(int i)         const { return (i >= 0 && i < (int)m_layers.size()) ? m_layers[i].type : LayerType::DENSE; }
-    const std::vector<float>& layerWeights(int i) const {
-        static const std::vector<float> empty;
+    const simd::AlignedFloats& layerWeights(int i) const {
+        static const simd::AlignedFloats empty;
         return (i >= 0 && i < (int)m_layers.size()) ? m_layers[i].weights : empty;
     }
-    const std::vector<float>& layerBiases(int i) const {
-        static const std::vector<float> empty;
+    const simd::AlignedFloats& layerBiases(int i) const {
+        static const simd::AlignedFloats empty;
         return (i >= 0 && i < (int)m_layers.size()) ? m_layers[i].biases : empty;
     }
 
+    // In-place access to a layer's parameters (same layout as
+    // layerWeights()/layerBiases()); no copy is made.
+    ParamView layerWeightsMut(int i);
+    ParamView layerBiasesMut(int i);
+
+    // Mutable row `index` (out floats) of an embedding layer, for sparse
+    // weight updates; nullptr if the layer is not an embedding or the index
+    // is out of range.
+    float* embeddingRow(int layer, int index);
+
     // reset the mutable state (hidden & cell) of all LSTM layers to zero.
     // Call this before processing a new sequence of inputs.
     void resetState();
@@ -61,15 +262,16 @@ public:
     std::vector<float> forwardSequence(const std::vector<std::vector<float>>& seq);
 
 private:
-    // Layer: Dense or LSTM.
-    //   Dense  – weights (out×in), biases (out).
+    // Layer: Dense, Linear, Embedding or LSTM.
+    //   Dense     – weights (out×in), biases (out).  Linear: same layout.
+    //   Embedding – weights (in×out, one row per input), biases (out).
     //   LSTM   – 4 gates, each (in+hidden)→hidden; combined weight tensor
     //            shape [4, hidden, in+hidden]; biases [4, hidden].
     //            Gate order: forget(0), input(1), cell(2), output(3).
     struct Layer {
         LayerType           type    = LayerType::DENSE;
-        std::vector<float>  weights;
-        std::vector<float>  biases;
+        simd::AlignedFloats weights;
+        simd::AlignedFloats biases;
         int in  = 0;
         int out = 0;
         // LSTM temporal state – mutable so const forward() can update it
@@ -78,6 +280,19 @@ private:
     };
     std::vector<Layer> m_layers;
 
-    // apply one LSTM layer step; updates layer.lstmH/lstmC and current
-    void applyLSTM(const Layer& layer, std::vector<float>& current) const;
+    // apply one LSTM layer step on `x` (in floats, zero-padded if
+    // shorter); updates layer.lstmH/lstmC and writes h to `y`
+    // (recording into `trace` when non-null)
+    void applyLSTM(const Layer& layer, const std::vector<float>& x,
+                   std::vector<float>& y, Workspace& ws,
+                   LstmTrace* trace = nullptr) const;
+    // y = ReLU(b + sum_k value[k] * row(index[k])) for an embedding layer;
+    // `nnz` entries
+    void applyEmbedding(const Layer& layer, const int* index, const float* value,
+                        size_t nnz, std::vector<float>& y) const;
+    // run layers [first, end), reading ws.acts[first]; `traces` (one per
+    // layer) records the LSTM steps when non-null
+    void runLayers(size_t first, Workspace& ws, LstmTrace* traces = nullptr) const;
+    const std::vector<float>& forwardSparse(const SparseVector& input, Workspace& ws,
+                                            LstmTrace* traces) const;
 };
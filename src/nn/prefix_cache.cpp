@@ -0,0 +1,132 @@
+#include "nn/prefix_cache.h"
+#include "metrics.h"
+
+#include <algorithm>
+
+namespace {
+struct PrefixCacheMetrics {
+    Counter& computed = metrics().counter("wqb_score_steps_total", "Policy forward steps run to score kernels");
+    Counter& reused   = metrics().counter("wqb_score_steps_reused_total", "Scoring steps skipped by resuming from a cached prefix state");
+};
+
+PrefixCacheMetrics& prefixCacheMetrics() {
+    static PrefixCacheMetrics m;
+    return m;
+}
+} // namespace
+
+PrefixStateCache::PrefixStateCache(int interval, size_t capacity)
+    : m_interval(std::max(1, interval)), m_capacity(std::max<size_t>(1, capacity)) {
+    prefixCacheMetrics();
+}
+
+uint64_t PrefixStateCache::key(const std::vector<uint8_t>& seq) {
+    uint64_t h = 1469598103934665603ULL;   // FNV-1a 64-bit
+    for (uint8_t b : seq) {
+        h ^= b;
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+void PrefixStateCache::clear() {
+    m_entries.clear();
+    m_model.reset();
+}
+
+size_t PrefixStateCache::stateSize(const QuantizedPolicy::State& st) const {
+    size_t n = 1;   // the output at the checkpoint
+    for (size_t l = 0; l < st.h.size(); ++l) n += st.h[l].size() + st.c[l].size();
+    return n;
+}
+
+void PrefixStateCache::save(const QuantizedPolicy::State& st, float out, float* dst) const {
+    for (size_t l = 0; l < st.h.size(); ++l) {
+        dst = std::copy(st.h[l].begin(), st.h[l].end(), dst);
+        dst = std::copy(st.c[l].begin(), st.c[l].end(), dst);
+    }
+    *dst = out;
+}
+
+float PrefixStateCache::restore(const float* src, QuantizedPolicy::State& st) const {
+    for (size_t l = 0; l < st.h.size(); ++l) {
+        std::copy_n(src, st.h[l].size(), st.h[l].begin());
+        src += st.h[l].size();
+        std::copy_n(src, st.c[l].size(), st.c[l].begin());
+        src += st.c[l].size();
+    }
+    return *src;
+}
+
+float PrefixStateCache::score(const std::shared_ptr<const QuantizedPolicy>& model,
+                              const std::vector<uint8_t>& seq,
+                              QuantizedPolicy::State& st, SparseVector& scratch) {
+    auto& m = prefixCacheMetrics();
+    if (model != m_model) {
+        clear();
+        m_model = model;
+    }
+    model->resetState(st);
+    const uint64_t k  = key(seq);
+    const size_t   ss = stateSize(st);
+
+    // an exact repeat, or the cached sequence sharing the longest prefix
+    const Entry* best = nullptr;
+    size_t bestPrefix = 0;
+    for (auto& e : m_entries) {
+        if (e.key == k && e.seq == seq) {
+            e.lastUse = ++m_clock;
+            m_reused += seq.size();
+            m.reused.inc(seq.size());
+            return e.output;
+        }
+        size_t n = std::min(e.seq.size(), seq.size());
+        size_t common = (size_t)(std::mismatch(seq.begin(), seq.begin() + n, e.seq.begin()).first -
+                                 seq.begin());
+        if (common > bestPrefix) {
+            best       = &e;
+            bestPrefix = common;
+        }
+    }
+
+    Entry fresh;
+    fresh.key = k;
+    fresh.seq = seq;
+    fresh.states.reserve(seq.size() / m_interval * ss);
+    size_t start = 0;
+    float  out   = 0.0f;
+    if (best) {
+        // last checkpoint at or before the first differing opcode
+        size_t cps = std::min(bestPrefix / m_interval, best->states.size() / ss);
+        if (cps > 0) {
+            out   = restore(best->states.data() + (cps - 1) * ss, st);
+            start = cps * m_interval;
+            fresh.states.assign(best->states.begin(), best->states.begin() + cps * ss);
+        }
+    }
+
+    for (size_t t = start; t < seq.size(); ++t) {
+        scratch.setOneHot(seq[t]);
+        const auto& y = model->forward(scratch, st);
+        out = y.empty() ? 0.0f : y[0];
+        if ((t + 1) % m_interval == 0) {
+            fresh.states.resize(fresh.states.size() + ss);
+            save(st, out, fresh.states.data() + fresh.states.size() - ss);
+        }
+    }
+    m_reused   += start;
+    m_computed += seq.size() - start;
+    m.reused.inc(start);
+    m.computed.inc(seq.size() - start);
+
+    fresh.output  = out;
+    fresh.lastUse = ++m_clock;
+    if (m_entries.size() >= m_capacity) {
+        auto lru = std::min_element(m_entries.begin(), m_entries.end(),
+                                    [](const Entry& a, const Entry& b) { return a.lastUse < b.lastUse; });
+        *lru = std::move(fresh);
+    } else {
+        m_entries.push_back(std::move(fresh));
+    }
+    return out;
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "quantized.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// ── PrefixStateCache ──────────────────────────────────────────────────────────
+//
+// Incremental scoring for opcode sequences that share prefixes.  Consecutive
+// generations evolve from the same parent, so the kernel scored next usually
+// matches the previous one up to the mutation point.  For each recently
+// scored sequence (keyed by its FNV-1a hash) the cache keeps the LSTM
+// hidden/cell state every `interval` opcodes.  score() finds the cached
+// sequence with the longest common prefix, restores the last checkpoint at
+// or before the first differing opcode, and runs only the remaining
+// suffix; an exact repeat costs no forward steps at all.
+//
+// States are only valid for the model that produced them: scoring with a
+// different QuantizedPolicy (a new snapshot) clears the cache.  Results are
+// bit-identical to QuantizedPolicy::score().  Not thread-safe; one cache
+// per scoring thread.
+//
+// Metrics: wqb_score_steps_total (forward steps run) and
+// wqb_score_steps_reused_total (steps skipped by resuming from a
+// checkpoint).
+// ─────────────────────────────────────────────────────────────────────────────
+
+class PrefixStateCache {
+public:
+    static constexpr int    kDefaultInterval = 16;
+    static constexpr size_t kDefaultCapacity = 8;
+
+    explicit PrefixStateCache(int interval = kDefaultInterval,
+                              size_t capacity = kDefaultCapacity);
+
+    // Score `seq` with `model` like QuantizedPolicy::score(seq, st, scratch)
+    // and remember its checkpoints.
+    float score(const std::shared_ptr<const QuantizedPolicy>& model,
+                const std::vector<uint8_t>& seq,
+                QuantizedPolicy::State& st, SparseVector& scratch);
+
+    void clear();
+    size_t size() const { return m_entries.size(); }
+    int    interval() const { return m_interval; }
+
+    // forward steps run / skipped since construction
+    uint64_t stepsComputed() const { return m_computed; }
+    uint64_t stepsReused()   const { return m_reused; }
+
+    static uint64_t key(const std::vector<uint8_t>& seq);
+
+private:
+    struct Entry {
+        uint64_t             key = 0;
+        std::vector<uint8_t> seq;
+        // checkpoint k (after (k+1)*interval opcodes): LSTM h and c of
+        // every layer followed by the first output at that step
+        std::vector<float>   states;
+        float                output  = 0.0f;   // score of the whole sequence
+        uint64_t             lastUse = 0;
+    };
+
+    size_t stateSize(const QuantizedPolicy::State& st) const;
+    void   save(const QuantizedPolicy::State& st, float out, float* dst) const;
+    float  restore(const float* src, QuantizedPolicy::State& st) const;
+
+    int    m_interval;
+    size_t m_capacity;
+    std::shared_ptr<const QuantizedPolicy> m_model;   // owner of the cached states
+    std::vector<Entry> m_entries;
+    uint64_t m_clock    = 0;
+    uint64_t m_computed = 0;
+    uint64_t m_reused   = 0;
+};
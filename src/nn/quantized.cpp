@@ -0,0 +1,172 @@
+#include "nn/quantized.h"
+
+#include <algorithm>
+#include <cmath>
+
+// Symmetric int8 quantization of `n` floats into `q`; returns the scale
+// (value = q * scale).  An all-zero input gets scale 0.
+static float quantizeRow(const float* x, int n, int8_t* q) {
+    float maxAbs = 0.0f;
+    for (int k = 0; k < n; ++k) maxAbs = std::max(maxAbs, std::fabs(x[k]));
+    if (maxAbs == 0.0f) {
+        std::fill(q, q + n, (int8_t)0);
+        return 0.0f;
+    }
+    const float inv = 127.0f / maxAbs;
+    for (int k = 0; k < n; ++k)
+        q[k] = (int8_t)std::lrint(std::min(127.0f, std::max(-127.0f, x[k] * inv)));
+    return maxAbs / 127.0f;
+}
+
+void QuantizedPolicy::quantize(const Policy& p) {
+    m_layers.resize(p.layerCount());
+    for (int l = 0; l < p.layerCount(); ++l) {
+        Layer& q = m_layers[l];
+        q.type = p.layerType(l);
+        q.in   = p.layerInSize(l);
+        q.out  = p.layerOutSize(l);
+        if (q.type == Policy::LayerType::LSTM) {
+            q.rows = 4 * q.out;
+            q.cols = q.in + q.out;
+        } else if (q.type == Policy::LayerType::EMBEDDING) {
+            q.rows = q.in;    // one row per input
+            q.cols = q.out;
+        } else {
+            q.rows = q.out;
+            q.cols = q.in;
+        }
+        q.stride = simd::padI8(q.cols);
+        const auto& w = p.layerWeights(l);
+        q.weights.assign((size_t)q.rows * q.stride, 0);
+        q.scales.resize(q.rows);
+        for (int r = 0; r < q.rows; ++r)
+            q.scales[r] = quantizeRow(w.data() + (size_t)r * q.cols, q.cols,
+                                      q.weights.data() + (size_t)r * q.stride);
+        const auto& b = p.layerBiases(l);
+        q.biases.assign(b.begin(), b.end());
+    }
+}
+
+size_t QuantizedPolicy::bytes() const {
+    size_t n = 0;
+    for (const auto& q : m_layers)
+        n += q.weights.size() + (q.scales.size() + q.biases.size()) * sizeof(float);
+    return n;
+}
+
+void QuantizedPolicy::prepare(State& st) const {
+    st.acts.resize(m_layers.size() + 1);
+    st.h.resize(m_layers.size());
+    st.c.resize(m_layers.size());
+    size_t maxXh = 0, maxGates = 0, maxIn = 0;
+    for (size_t l = 0; l < m_layers.size(); ++l) {
+        const Layer& q = m_layers[l];
+        st.acts[l + 1].reserve(q.out);
+        if (q.type == Policy::LayerType::LSTM) {
+            st.h[l].assign(q.out, 0.0f);
+            st.c[l].assign(q.out, 0.0f);
+            maxXh    = std::max(maxXh, (size_t)q.cols);
+            maxGates = std::max(maxGates, (size_t)q.rows);
+        }
+        maxIn = std::max(maxIn, (size_t)q.stride);
+    }
+    st.xh.reserve(maxXh);
+    st.gates.reserve(maxGates);
+    st.xq.reserve(maxIn);
+}
+
+void QuantizedPolicy::resetState(State& st) const {
+    if (st.acts.size() != m_layers.size() + 1) prepare(st);
+    for (size_t l = 0; l < m_layers.size(); ++l) {
+        std::fill(st.h[l].begin(), st.h[l].end(), 0.0f);
+        std::fill(st.c[l].begin(), st.c[l].end(), 0.0f);
+    }
+}
+
+void QuantizedPolicy::matvec(const Layer& q, const float* x, int n, State& st, float* y) const {
+    // quantize the input (zero-padded to the row stride)
+    st.xq.assign(q.stride, 0);
+    float xScale = quantizeRow(x, std::min(n, q.cols), st.xq.data());
+    simd::gemvI8(q.weights.data(), q.rows, q.stride, st.xq.data(), q.scales.data(),
+                 xScale, q.biases.data(), y);
+}
+
+void QuantizedPolicy::applyLSTM(size_t l, const float* x, int n, State& st) const {
+    const Layer& q = m_layers[l];
+    const int hidden = q.out;
+    st.xh.assign(q.cols, 0.0f);
+    std::copy_n(x, std::min(n, q.in), st.xh.begin());
+    std::copy(st.h[l].begin(), st.h[l].end(), st.xh.begin() + q.in);
+
+    st.gates.resize(q.rows);
+    matvec(q, st.xh.data(), q.cols, st, st.gates.data());
+    float* f = st.gates.data();
+    float* i = f + hidden;
+    float* g = i + hidden;
+    float* o = g + hidden;
+    simd::sigmoid(f, 2 * hidden);
+    simd::tanh(g, hidden);
+    simd::sigmoid(o, hidden);
+    simd::lstmCell(f, i, g, o, st.c[l].data(), st.h[l].data(), hidden);
+    st.acts[l + 1].assign(st.h[l].begin(), st.h[l].end());
+}
+
+const std::vector<float>& QuantizedPolicy::forward(const SparseVector& input, State& st) const {
+    if (st.acts.size() != m_layers.size() + 1) prepare(st);
+    if (m_layers.empty()) return st.acts.back();
+
+    for (size_t l = 0; l < m_layers.size(); ++l) {
+        const Layer& q = m_layers[l];
+        std::vector<float>& y = st.acts[l + 1];
+        if (l == 0) {
+            // sparse input: gather (embedding) or scatter into a dense vector
+            if (q.type == Policy::LayerType::EMBEDDING) {
+                y.assign(q.biases.begin(), q.biases.end());
+                for (size_t k = 0; k < input.size(); ++k) {
+                    int i = input.index[k];
+                    if (i < 0 || i >= q.in) continue;
+                    const int8_t* row = q.weights.data() + (size_t)i * q.stride;
+                    float a = input.value[k] * q.scales[i];
+                    for (int o = 0; o < q.out; ++o) y[o] += a * (float)row[o];
+                }
+                simd::relu(y.data(), q.out);
+                continue;
+            }
+            st.acts[0].assign(q.in, 0.0f);
+            for (size_t k = 0; k < input.size(); ++k)
+                if (input.index[k] >= 0 && input.index[k] < q.in)
+                    st.acts[0][input.index[k]] += input.value[k];
+        }
+        const std::vector<float>& x = st.acts[l];
+        if (q.type == Policy::LayerType::LSTM) {
+            applyLSTM(l, x.data(), (int)x.size(), st);
+        } else if (q.type == Policy::LayerType::EMBEDDING) {
+            // dense input into a later embedding layer
+            y.assign(q.biases.begin(), q.biases.end());
+            for (int i = 0; i < std::min((int)x.size(), q.in); ++i) {
+                if (x[i] == 0.0f) continue;
+                const int8_t* row = q.weights.data() + (size_t)i * q.stride;
+                float a = x[i] * q.scales[i];
+                for (int o = 0; o < q.out; ++o) y[o] += a * (float)row[o];
+            }
+            simd::relu(y.data(), q.out);
+        } else {
+            y.resize(q.out);
+            matvec(q, x.data(), (int)x.size(), st, y.data());
+            if (q.type == Policy::LayerType::DENSE) simd::relu(y.data(), q.out);
+        }
+    }
+    return st.acts.back();
+}
+
+float QuantizedPolicy::score(const std::vector<uint8_t>& seq, State& st,
+                             SparseVector& scratch) const {
+    resetState(st);
+    float out = 0.0f;
+    for (uint8_t op : seq) {
+        scratch.setOneHot(op);
+        const auto& y = forward(scratch, st);
+        out = y.empty() ? 0.0f : y[0];
+    }
+    return out;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "policy.h"
+
+#include <cstdint>
+#include <vector>
+
+// ── QuantizedPolicy ───────────────────────────────────────────────────────────
+//
+// Read-only int8 copy of a Policy for scoring.  Every weight row is
+// quantized symmetrically with its own scale (scale = max|w| / 127); biases
+// stay fp32.  Dense, Linear and LSTM layers quantize their input vector the
+// same way on the fly and run simd::gemvI8 (int8 x int8 products, exact
+// int32 accumulation, one float rescale per row); embedding layers gather
+// dequantized rows.  Activations, the LSTM cell update and all state are
+// fp32, so errors do not compound through the recurrence beyond the
+// per-step weight rounding.
+//
+// The weights are immutable after quantize(): LSTM state and scratch live in
+// a caller-owned State, so one QuantizedPolicy can be shared between
+// threads (each with its own State).  Outputs track the fp32 policy closely
+// but not bit for bit; see test_quantized.cpp for the measured delta.
+// ─────────────────────────────────────────────────────────────────────────────
+
+class QuantizedPolicy {
+public:
+    // Per-caller LSTM state and scratch.  Size it with prepare(); forward()
+    // does not allocate afterwards.
+    struct State {
+        std::vector<std::vector<float>> acts;   // acts[l+1] = output of layer l
+        std::vector<std::vector<float>> h, c;   // LSTM state per layer (empty otherwise)
+        std::vector<float>  xh;                 // LSTM [input; h_prev], padded
+        std::vector<float>  gates;
+        std::vector<int8_t> xq;                 // quantized layer input
+    };
+
+    QuantizedPolicy() = default;
+    explicit QuantizedPolicy(const Policy& p) { quantize(p); }
+
+    // Rebuild from the current fp32 weights of `p` (any layer mix).
+    void quantize(const Policy& p);
+
+    void prepare(State& st) const;
+    // zero the LSTM state in `st`
+    void resetState(State& st) const;
+
+    // One step, like Policy::forward(input, ws).  Returns st.acts.back().
+    const std::vector<float>& forward(const SparseVector& input, State& st) const;
+
+    // Reset `st`, feed `seq` as one-hot opcodes and return the first output
+    // of the last step (0 for an empty sequence).  Uses `scratch` for the
+    // input so repeated calls do not allocate.
+    float score(const std::vector<uint8_t>& seq, State& st, SparseVector& scratch) const;
+
+    int    layerCount() const { return (int)m_layers.size(); }
+    // bytes of int8 weights plus fp32 scales and biases
+    size_t bytes() const;
+
+private:
+    struct Layer {
+        Policy::LayerType   type = Policy::LayerType::DENSE;
+        int in = 0, out = 0;
+        int rows = 0, cols = 0, stride = 0;   // int8 matrix; stride = padded cols
+        std::vector<int8_t> weights;          // rows x stride
+        std::vector<float>  scales;           // one per row
+        std::vector<float>  biases;
+    };
+    std::vector<Layer> m_layers;
+
+    // y = W·x + b through the int8 kernel; x has `layer.cols` floats
+    void matvec(const Layer& layer, const float* x, int n, State& st, float* y) const;
+    void applyLSTM(size_t l, const float* x, int n, State& st) const;
+};
@@ -0,0 +1,93 @@
+#include "nn/replay.h"
+
+#include <algorithm>
+#include <cmath>
+
+ReplayMemory::ReplayMemory(size_t capacity) {
+    setCapacity(capacity);
+}
+
+double ReplayMemory::priorityOf(float loss) {
+    double l = std::isfinite(loss) && loss > 0.0f ? (double)loss : 0.0;
+    return std::pow(l + kEpsilon, kAlpha);
+}
+
+void ReplayMemory::setCapacity(size_t capacity) {
+    // oldest first, so re-pushing them keeps the ring order
+    std::vector<Item>   items;
+    std::vector<double> prio;
+    size_t keep = std::min(m_size, capacity);
+    for (size_t k = m_size - keep; k < m_size; ++k) {
+        size_t slot = (m_head + m_items.size() - m_size + k) % m_items.size();
+        items.push_back(std::move(m_items[slot]));
+        prio.push_back(priority(slot));
+    }
+
+    m_items.assign(capacity, Item{});
+    m_leaves = 1;
+    while (m_leaves < capacity) m_leaves <<= 1;
+    m_tree.assign(2 * m_leaves, 0.0);
+    m_head = 0;
+    m_size = 0;
+    for (size_t k = 0; k < items.size(); ++k) {
+        m_items[k] = std::move(items[k]);
+        setLeaf(k, prio[k]);
+    }
+    m_size = items.size();
+    m_head = capacity ? m_size % capacity : 0;
+}
+
+void ReplayMemory::clear() {
+    std::fill(m_items.begin(), m_items.end(), Item{});
+    std::fill(m_tree.begin(), m_tree.end(), 0.0);
+    m_head = 0;
+    m_size = 0;
+}
+
+void ReplayMemory::setLeaf(size_t slot, double p) {
+    size_t node = m_leaves + slot;
+    m_tree[node] = p;
+    // recompute rather than add a delta, so rounding never accumulates
+    for (node >>= 1; node >= 1; node >>= 1)
+        m_tree[node] = m_tree[2 * node] + m_tree[2 * node + 1];
+}
+
+size_t ReplayMemory::push(Item item, float loss) {
+    if (m_items.empty()) return npos;
+    size_t slot = m_head;
+    m_items[slot] = std::move(item);
+    setLeaf(slot, priorityOf(loss));
+    m_head = (m_head + 1) % m_items.size();
+    if (m_size < m_items.size()) ++m_size;
+    return slot;
+}
+
+void ReplayMemory::update(size_t slot, float loss) {
+    if (slot < m_size) setLeaf(slot, priorityOf(loss));
+}
+
+size_t ReplayMemory::sample(std::mt19937& rng) const {
+    double u = std::uniform_real_distribution<double>(0.0, total())(rng);
+    size_t node = 1;
+    while (node < m_leaves) {
+        size_t left = 2 * node;
+        // an empty right subtree can only be reached through rounding
+        if (u < m_tree[left] || m_tree[left + 1] <= 0.0) {
+            node = left;
+        } else {
+            u -= m_tree[left];
+            node = left + 1;
+        }
+    }
+    return std::min(node - m_leaves, m_size - 1);
+}
+
+double ReplayMemory::probability(size_t slot) const {
+    double t = total();
+    return t > 0.0 ? priority(slot) / t : 0.0;
+}
+
+double ReplayMemory::weight(size_t slot) const {
+    double p = probability(slot);
+    return p > 0.0 ? std::pow((double)m_size * p, -kBeta) : 1.0;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+struct KernelFeatures;   // nn/feature.h
+
+// ── ReplayMemory ──────────────────────────────────────────────────────────────
+//
+// Fixed-capacity ring of pre-featurised training examples with prioritised
+// sampling.  An item is only the shared KernelFeatures of its kernel plus
+// the generation it reached, so the ring never copies base64 text and the
+// oldest item is overwritten in place when it is full.
+//
+// Each slot carries a priority (loss + kEpsilon)^kAlpha held in a sum tree
+// (leaf per slot, every inner node the sum of its children).  sample()
+// draws a slot with probability priority / total by descending the tree,
+// and push() / update() rewrite one leaf and its ancestors, so all three
+// are O(log capacity).  weight() is the importance-sampling correction
+// (N * P(i))^-kBeta for the bias prioritised sampling introduces.
+//
+// Not thread-safe; the Trainer owns one and touches it between batches.
+// ─────────────────────────────────────────────────────────────────────────────
+
+class ReplayMemory {
+public:
+    static constexpr size_t kDefaultCapacity = 256;
+    static constexpr double kAlpha   = 0.6;    // 0 = uniform, 1 = fully by loss
+    static constexpr double kBeta    = 0.4;    // importance-sampling exponent
+    static constexpr double kEpsilon = 1e-3;   // keeps zero-loss items drawable
+
+    struct Item {
+        std::shared_ptr<const KernelFeatures> features;
+        int generation = 0;
+    };
+
+    explicit ReplayMemory(size_t capacity = kDefaultCapacity);
+
+    // Resize, keeping the newest min(size, capacity) items and their
+    // priorities.  O(capacity); meant for configuration, not the hot path.
+    void setCapacity(size_t capacity);
+    void clear();
+
+    // Store `item` with the priority of `loss`, overwriting the oldest item
+    // when full.  Returns its slot (no-op returning npos at capacity 0).
+    size_t push(Item item, float loss);
+    // re-prioritise a slot after it was trained on
+    void update(size_t slot, float loss);
+
+    // slot drawn in proportion to priority; the memory must not be empty
+    size_t sample(std::mt19937& rng) const;
+
+    const Item& at(size_t slot) const { return m_items[slot]; }
+    double priority(size_t slot) const { return m_tree[m_leaves + slot]; }
+    double total() const { return m_tree.empty() ? 0.0 : m_tree[1]; }
+    // P(slot) = priority / total
+    double probability(size_t slot) const;
+    // (size * P(slot))^-kBeta, unnormalised
+    double weight(size_t slot) const;
+
+    size_t size()     const { return m_size; }
+    size_t capacity() const { return m_items.size(); }
+    bool   empty()    const { return m_size == 0; }
+
+    static constexpr size_t npos = (size_t)-1;
+
+private:
+    static double priorityOf(float loss);
+    void setLeaf(size_t slot, double p);
+
+    std::vector<Item>   m_items;    // ring storage, one per slot
+    std::vector<double> m_tree;     // [1] = root, leaves at [m_leaves + slot]
+    size_t m_leaves = 0;            // power of two >= capacity
+    size_t m_head   = 0;            // next slot to write
+    size_t m_size   = 0;
+};
@@ -0,0 +1,583 @@
+#include "nn/simd.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define WQB_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+namespace simd {
+
+namespace {
+
+// ── Scalar reference ──────────────────────────────────────────────────────────
+
+void gemvScalar(const float* W, int rows, int cols, const float* x,
+                const float* bias, float* y) {
+    for (int r = 0; r < rows; ++r) {
+        const float* w = W + (size_t)r * cols;
+        float sum = bias ? bias[r] : 0.0f;
+        for (int c = 0; c < cols; ++c) sum += w[c] * x[c];
+        y[r] = sum;
+    }
+}
+
+void gemmScalar(const float* W, int rows, int cols, const float* X, int n,
+                const float* bias, float* Y) {
+    for (int b = 0; b < n; ++b)
+        gemvScalar(W, rows, cols, X + (size_t)b * cols, bias, Y + (size_t)b * rows);
+}
+
+void axpyScalar(float a, const float* x, float* y, int n) {
+    for (int k = 0; k < n; ++k) y[k] += a * x[k];
+}
+
+void gemvI8Scalar(const int8_t* W, int rows, int cols, const int8_t* x,
+                  const float* rowScale, float xScale, const float* bias, float* y) {
+    for (int r = 0; r < rows; ++r) {
+        const int8_t* w = W + (size_t)r * cols;
+        int32_t acc = 0;
+        for (int c = 0; c < cols; ++c) acc += (int32_t)w[c] * (int32_t)x[c];
+        y[r] = (float)acc * rowScale[r] * xScale + (bias ? bias[r] : 0.0f);
+    }
+}
+
+void reluScalar(float* v, int n) {
+    for (int k = 0; k < n; ++k) if (v[k] < 0.0f) v[k] = 0.0f;
+}
+
+void sigmoidScalar(float* v, int n) {
+    for (int k = 0; k < n; ++k) v[k] = 1.0f / (1.0f + std::exp(-v[k]));
+}
+
+void tanhScalar(float* v, int n) {
+    for (int k = 0; k < n; ++k) v[k] = std::tanh(v[k]);
+}
+
+void lstmCellScalar(const float* f, const float* i, const float* g, const float* o,
+                    float* c, float* h, int n) {
+    for (int k = 0; k < n; ++k) {
+        c[k] = f[k] * c[k] + i[k] * g[k];
+        h[k] = o[k] * std::tanh(c[k]);
+    }
+}
+
+#ifdef WQB_SIMD_X86
+
+// Cephes expf constants (shared by the SSE2 and AVX2 paths)
+constexpr float kExpHi   =  88.3762626647949f;
+constexpr float kExpLo   = -88.3762626647949f;
+constexpr float kLog2e   =  1.44269504088896341f;
+constexpr float kExpC1   =  0.693359375f;
+constexpr float kExpC2   = -2.12194440e-4f;
+constexpr float kExpP0   =  1.9875691500e-4f;
+constexpr float kExpP1   =  1.3981999507e-3f;
+constexpr float kExpP2   =  8.3334519073e-3f;
+constexpr float kExpP3   =  4.1665795894e-2f;
+constexpr float kExpP4   =  1.6666665459e-1f;
+constexpr float kExpP5   =  5.0000001201e-1f;
+
+// ── SSE2 ──────────────────────────────────────────────────────────────────────
+
+__attribute__((target("sse2")))
+inline float hsum128(__m128 v) {
+    __m128 sh = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1));
+    __m128 s  = _mm_add_ps(v, sh);
+    sh = _mm_movehl_ps(sh, s);
+    s  = _mm_add_ss(s, sh);
+    return _mm_cvtss_f32(s);
+}
+
+__attribute__((target("sse2")))
+inline __m128 exp128(__m128 x) {
+    x = _mm_min_ps(_mm_max_ps(x, _mm_set1_ps(kExpLo)), _mm_set1_ps(kExpHi));
+    __m128 fx = _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(kLog2e)), _mm_set1_ps(0.5f));
+    // floor without SSE4.1: truncate, then step down where that rounded up
+    __m128 t    = _mm_cvtepi32_ps(_mm_cvttps_epi32(fx));
+    __m128 mask = _mm_and_ps(_mm_cmpgt_ps(t, fx), _mm_set1_ps(1.0f));
+    fx = _mm_sub_ps(t, mask);
+    x = _mm_sub_ps(x, _mm_mul_ps(fx, _mm_set1_ps(kExpC1)));
+    x = _mm_sub_ps(x, _mm_mul_ps(fx, _mm_set1_ps(kExpC2)));
+    __m128 z = _mm_mul_ps(x, x);
+    __m128 y = _mm_set1_ps(kExpP0);
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(kExpP1));
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(kExpP2));
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(kExpP3));
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(kExpP4));
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(kExpP5));
+    y = _mm_add_ps(_mm_add_ps(_mm_mul_ps(y, z), x), _mm_set1_ps(1.0f));
+    __m128i e = _mm_add_epi32(_mm_cvttps_epi32(fx), _mm_set1_epi32(127));
+    return _mm_mul_ps(y, _mm_castsi128_ps(_mm_slli_epi32(e, 23)));
+}
+
+__attribute__((target("sse2")))
+inline __m128 sigmoid128(__m128 x) {
+    __m128 one = _mm_set1_ps(1.0f);
+    return _mm_div_ps(one, _mm_add_ps(one, exp128(_mm_sub_ps(_mm_setzero_ps(), x))));
+}
+
+// tanh(x) = 2 * sigmoid(2x) - 1
+__attribute__((target("sse2")))
+inline __m128 tanh128(__m128 x) {
+    __m128 two = _mm_set1_ps(2.0f);
+    return _mm_sub_ps(_mm_mul_ps(two, sigmoid128(_mm_mul_ps(two, x))), _mm_set1_ps(1.0f));
+}
+
+__attribute__((target("sse2")))
+void gemvSse2(const float* W, int rows, int cols, const float* x,
+              const float* bias, float* y) {
+    const int cv = cols & ~3;
+    int r = 0;
+    // four rows at a time: each x load feeds four independent accumulators
+    for (; r + 4 <= rows; r += 4) {
+        const float* w0 = W + (size_t)r * cols;
+        const float* w1 = w0 + cols;
+        const float* w2 = w1 + cols;
+        const float* w3 = w2 + cols;
+        __m128 a0 = _mm_setzero_ps(), a1 = _mm_setzero_ps();
+        __m128 a2 = _mm_setzero_ps(), a3 = _mm_setzero_ps();
+        for (int c = 0; c < cv; c += 4) {
+            __m128 xv = _mm_loadu_ps(x + c);
+            a0 = _mm_add_ps(a0, _mm_mul_ps(_mm_loadu_ps(w0 + c), xv));
+            a1 = _mm_add_ps(a1, _mm_mul_ps(_mm_loadu_ps(w1 + c), xv));
+            a2 = _mm_add_ps(a2, _mm_mul_ps(_mm_loadu_ps(w2 + c), xv));
+            a3 = _mm_add_ps(a3, _mm_mul_ps(_mm_loadu_ps(w3 + c), xv));
+        }
+        float s0 = hsum128(a0), s1 = hsum128(a1), s2 = hsum128(a2), s3 = hsum128(a3);
+        for (int c = cv; c < cols; ++c) {
+            s0 += w0[c] * x[c]; s1 += w1[c] * x[c];
+            s2 += w2[c] * x[c]; s3 += w3[c] * x[c];
+        }
+        y[r]     = s0 + (bias ? bias[r]     : 0.0f);
+        y[r + 1] = s1 + (bias ? bias[r + 1] : 0.0f);
+        y[r + 2] = s2 + (bias ? bias[r + 2] : 0.0f);
+        y[r + 3] = s3 + (bias ? bias[r + 3] : 0.0f);
+    }
+    for (; r < rows; ++r) {
+        const float* w = W + (size_t)r * cols;
+        __m128 a = _mm_setzero_ps();
+        for (int c = 0; c < cv; c += 4)
+            a = _mm_add_ps(a, _mm_mul_ps(_mm_loadu_ps(w + c), _mm_loadu_ps(x + c)));
+        float s = hsum128(a);
+        for (int c = cv; c < cols; ++c) s += w[c] * x[c];
+        y[r] = s + (bias ? bias[r] : 0.0f);
+    }
+}
+
+// sign-extend 16 int8 lanes and multiply-add them pairwise into 4 int32
+__attribute__((target("sse2")))
+inline __m128i dotI8x16(__m128i a, __m128i b) {
+    const __m128i zero = _mm_setzero_si128();
+    __m128i aSign = _mm_cmpgt_epi8(zero, a), bSign = _mm_cmpgt_epi8(zero, b);
+    __m128i lo = _mm_madd_epi16(_mm_unpacklo_epi8(a, aSign), _mm_unpacklo_epi8(b, bSign));
+    __m128i hi = _mm_madd_epi16(_mm_unpackhi_epi8(a, aSign), _mm_unpackhi_epi8(b, bSign));
+    return _mm_add_epi32(lo, hi);
+}
+
+__attribute__((target("sse2")))
+inline int32_t hsum128i(__m128i v) {
+    v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+    v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(v);
+}
+
+__attribute__((target("sse2")))
+void gemvI8Sse2(const int8_t* W, int rows, int cols, const int8_t* x,
+                const float* rowScale, float xScale, const float* bias, float* y) {
+    for (int r = 0; r < rows; ++r) {
+        const int8_t* w = W + (size_t)r * cols;
+        __m128i acc = _mm_setzero_si128();
+        for (int c = 0; c < cols; c += 16)
+            acc = _mm_add_epi32(acc, dotI8x16(_mm_loadu_si128((const __m128i*)(w + c)),
+                                              _mm_loadu_si128((const __m128i*)(x + c))));
+        y[r] = (float)hsum128i(acc) * rowScale[r] * xScale + (bias ? bias[r] : 0.0f);
+    }
+}
+
+// SSE2 has too few registers for a useful row x input tile; one GEMV per
+// input keeps the results identical to gemvSse2
+__attribute__((target("sse2")))
+void gemmSse2(const float* W, int rows, int cols, const float* X, int n,
+              const float* bias, float* Y) {
+    for (int b = 0; b < n; ++b)
+        gemvSse2(W, rows, cols, X + (size_t)b * cols, bias, Y + (size_t)b * rows);
+}
+
+__attribute__((target("sse2")))
+void axpySse2(float a, const float* x, float* y, int n) {
+    __m128 av = _mm_set1_ps(a);
+    int k = 0;
+    for (; k + 4 <= n; k += 4)
+        _mm_storeu_ps(y + k, _mm_add_ps(_mm_loadu_ps(y + k), _mm_mul_ps(av, _mm_loadu_ps(x + k))));
+    axpyScalar(a, x + k, y + k, n - k);
+}
+
+__attribute__((target("sse2")))
+void reluSse2(float* v, int n) {
+    int k = 0;
+    for (; k + 4 <= n; k += 4)
+        _mm_storeu_ps(v + k, _mm_max_ps(_mm_loadu_ps(v + k), _mm_setzero_ps()));
+    reluScalar(v + k, n - k);
+}
+
+__attribute__((target("sse2")))
+void sigmoidSse2(float* v, int n) {
+    int k = 0;
+    for (; k + 4 <= n; k += 4)
+        _mm_storeu_ps(v + k, sigmoid128(_mm_loadu_ps(v + k)));
+    sigmoidScalar(v + k, n - k);
+}
+
+__attribute__((target("sse2")))
+void tanhSse2(float* v, int n) {
+    int k = 0;
+    for (; k + 4 <= n; k += 4)
+        _mm_storeu_ps(v + k, tanh128(_mm_loadu_ps(v + k)));
+    tanhScalar(v + k, n - k);
+}
+
+__attribute__((target("sse2")))
+void lstmCellSse2(const float* f, const float* i, const float* g, const float* o,
+                  float* c, float* h, int n) {
+    int k = 0;
+    for (; k + 4 <= n; k += 4) {
+        __m128 cv = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(f + k), _mm_loadu_ps(c + k)),
+                               _mm_mul_ps(_mm_loadu_ps(i + k), _mm_loadu_ps(g + k)));
+        _mm_storeu_ps(c + k, cv);
+        _mm_storeu_ps(h + k, _mm_mul_ps(_mm_loadu_ps(o + k), tanh128(cv)));
+    }
+    lstmCellScalar(f + k, i + k, g + k, o + k, c + k, h + k, n - k);
+}
+
+// ── AVX2 / FMA ────────────────────────────────────────────────────────────────
+
+__attribute__((target("avx2,fma")))
+inline float hsum256(__m256 v) {
+    __m128 lo = _mm256_castps256_ps128(v);
+    __m128 hi = _mm256_extractf128_ps(v, 1);
+    __m128 s  = _mm_add_ps(lo, hi);
+    s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+    s = _mm_add_ss(s, _mm_shuffle_ps(s, s, 0x55));
+    return _mm_cvtss_f32(s);
+}
+
+__attribute__((target("avx2,fma")))
+inline __m256 exp256(__m256 x) {
+    x = _mm256_min_ps(_mm256_max_ps(x, _mm256_set1_ps(kExpLo)), _mm256_set1_ps(kExpHi));
+    __m256 fx = _mm256_floor_ps(_mm256_fmadd_ps(x, _mm256_set1_ps(kLog2e), _mm256_set1_ps(0.5f)));
+    x = _mm256_fnmadd_ps(fx, _mm256_set1_ps(kExpC1), x);
+    x = _mm256_fnmadd_ps(fx, _mm256_set1_ps(kExpC2), x);
+    __m256 z = _mm256_mul_ps(x, x);
+    __m256 y = _mm256_set1_ps(kExpP0);
+    y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(kExpP1));
+    y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(kExpP2));
+    y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(kExpP3));
+    y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(kExpP4));
+    y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(kExpP5));
+    y = _mm256_add_ps(_mm256_fmadd_ps(y, z, x), _mm256_set1_ps(1.0f));
+    __m256i e = _mm256_add_epi32(_mm256_cvttps_epi32(fx), _mm256_set1_epi32(127));
+    return _mm256_mul_ps(y, _mm256_castsi256_ps(_mm256_slli_epi32(e, 23)));
+}
+
+__attribute__((target("avx2,fma")))
+inline __m256 sigmoid256(__m256 x) {
+    __m256 one = _mm256_set1_ps(1.0f);
+    return _mm256_div_ps(one, _mm256_add_ps(one, exp256(_mm256_sub_ps(_mm256_setzero_ps(), x))));
+}
+
+__attribute__((target("avx2,fma")))
+inline __m256 tanh256(__m256 x) {
+    __m256 two = _mm256_set1_ps(2.0f);
+    return _mm256_fmsub_ps(two, sigmoid256(_mm256_mul_ps(two, x)), _mm256_set1_ps(1.0f));
+}
+
+__attribute__((target("avx2,fma")))
+void gemvAvx2(const float* W, int rows, int cols, const float* x,
+              const float* bias, float* y) {
+    const int cv = cols & ~7;
+    int r = 0;
+    for (; r + 4 <= rows; r += 4) {
+        const float* w0 = W + (size_t)r * cols;
+        const float* w1 = w0 + cols;
+        const float* w2 = w1 + cols;
+        const float* w3 = w2 + cols;
+        __m256 a0 = _mm256_setzero_ps(), a1 = _mm256_setzero_ps();
+        __m256 a2 = _mm256_setzero_ps(), a3 = _mm256_setzero_ps();
+        for (int c = 0; c < cv; c += 8) {
+            __m256 xv = _mm256_loadu_ps(x + c);
+            a0 = _mm256_fmadd_ps(_mm256_loadu_ps(w0 + c), xv, a0);
+            a1 = _mm256_fmadd_ps(_mm256_loadu_ps(w1 + c), xv, a1);
+            a2 = _mm256_fmadd_ps(_mm256_loadu_ps(w2 + c), xv, a2);
+            a3 = _mm256_fmadd_ps(_mm256_loadu_ps(w3 + c), xv, a3);
+        }
+        float s0 = hsum256(a0), s1 = hsum256(a1), s2 = hsum256(a2), s3 = hsum256(a3);
+        for (int c = cv; c < cols; ++c) {
+            s0 += w0[c] * x[c]; s1 += w1[c] * x[c];
+            s2 += w2[c] * x[c]; s3 += w3[c] * x[c];
+        }
+        y[r]     = s0 + (bias ? bias[r]     : 0.0f);
+        y[r + 1] = s1 + (bias ? bias[r + 1] : 0.0f);
+        y[r + 2] = s2 + (bias ? bias[r + 2] : 0.0f);
+        y[r + 3] = s3 + (bias ? bias[r + 3] : 0.0f);
+    }
+    for (; r < rows; ++r) {
+        const float* w = W + (size_t)r * cols;
+        __m256 a = _mm256_setzero_ps();
+        for (int c = 0; c < cv; c += 8)
+            a = _mm256_fmadd_ps(_mm256_loadu_ps(w + c), _mm256_loadu_ps(x + c), a);
+        float s = hsum256(a);
+        for (int c = cv; c < cols; ++c) s += w[c] * x[c];
+        y[r] = s + (bias ? bias[r] : 0.0f);
+    }
+}
+
+// 4 rows x 2 inputs per tile: each weight vector loaded is used twice and
+// each input vector four times.  Every (row, input) pair is reduced like
+// gemvAvx2 (8-lane FMA accumulator, hsum, scalar tail).
+__attribute__((target("avx2,fma")))
+void gemmAvx2(const float* W, int rows, int cols, const float* X, int n,
+              const float* bias, float* Y) {
+    const int cv = cols & ~7;
+    int r = 0;
+    for (; r + 4 <= rows; r += 4) {
+        const float* w0 = W + (size_t)r * cols;
+        const float* w1 = w0 + cols;
+        const float* w2 = w1 + cols;
+        const float* w3 = w2 + cols;
+        int b = 0;
+        for (; b + 2 <= n; b += 2) {
+            const float* x0 = X + (size_t)b * cols;
+            const float* x1 = x0 + cols;
+            __m256 a00 = _mm256_setzero_ps(), a10 = a00, a20 = a00, a30 = a00;
+            __m256 a01 = a00, a11 = a00, a21 = a00, a31 = a00;
+            for (int c = 0; c < cv; c += 8) {
+                __m256 xv0 = _mm256_loadu_ps(x0 + c), xv1 = _mm256_loadu_ps(x1 + c);
+                __m256 wv = _mm256_loadu_ps(w0 + c);
+                a00 = _mm256_fmadd_ps(wv, xv0, a00);
+                a01 = _mm256_fmadd_ps(wv, xv1, a01);
+                wv  = _mm256_loadu_ps(w1 + c);
+                a10 = _mm256_fmadd_ps(wv, xv0, a10);
+                a11 = _mm256_fmadd_ps(wv, xv1, a11);
+                wv  = _mm256_loadu_ps(w2 + c);
+                a20 = _mm256_fmadd_ps(wv, xv0, a20);
+                a21 = _mm256_fmadd_ps(wv, xv1, a21);
+                wv  = _mm256_loadu_ps(w3 + c);
+                a30 = _mm256_fmadd_ps(wv, xv0, a30);
+                a31 = _mm256_fmadd_ps(wv, xv1, a31);
+            }
+            float s[2][4] = { { hsum256(a00), hsum256(a10), hsum256(a20), hsum256(a30) },
+                              { hsum256(a01), hsum256(a11), hsum256(a21), hsum256(a31) } };
+            for (int c = cv; c < cols; ++c) {
+                s[0][0] += w0[c] * x0[c]; s[0][1] += w1[c] * x0[c];
+                s[0][2] += w2[c] * x0[c]; s[0][3] += w3[c] * x0[c];
+                s[1][0] += w0[c] * x1[c]; s[1][1] += w1[c] * x1[c];
+                s[1][2] += w2[c] * x1[c]; s[1][3] += w3[c] * x1[c];
+            }
+            for (int k = 0; k < 2; ++k)
+                for (int q = 0; q < 4; ++q)
+                    Y[(size_t)(b + k) * rows + r + q] = s[k][q] + (bias ? bias[r + q] : 0.0f);
+        }
+        if (b < n)   // odd input left over
+            gemvAvx2(w0, 4, cols, X + (size_t)b * cols, bias ? bias + r : nullptr,
+                     Y + (size_t)b * rows + r);
+    }
+    if (r < rows) {
+        for (int b = 0; b < n; ++b)
+            gemvAvx2(W + (size_t)r * cols, rows - r, cols, X + (size_t)b * cols,
+                     bias ? bias + r : nullptr, Y + (size_t)b * rows + r);
+    }
+}
+
+// 32 int8 products folded into 8 int32 lanes.  maddubs wants one unsigned
+// operand, so the sign of x moves onto w; |w|, |x| <= 127 keeps every
+// pairwise int16 sum below 32767, so nothing saturates.
+__attribute__((target("avx2,fma")))
+inline __m256i dotI8x32(__m256i w, __m256i xAbs, __m256i x) {
+    __m256i p = _mm256_maddubs_epi16(xAbs, _mm256_sign_epi8(w, x));
+    return _mm256_madd_epi16(p, _mm256_set1_epi16(1));
+}
+
+__attribute__((target("avx2,fma")))
+void gemvI8Avx2(const int8_t* W, int rows, int cols, const int8_t* x,
+                const float* rowScale, float xScale, const float* bias, float* y) {
+    int r = 0;
+    // four rows at a time share each x block; the four sums are reduced
+    // together with hadd
+    for (; r + 4 <= rows; r += 4) {
+        const int8_t* w0 = W + (size_t)r * cols;
+        __m256i a0 = _mm256_setzero_si256(), a1 = a0, a2 = a0, a3 = a0;
+        for (int c = 0; c < cols; c += 32) {
+            __m256i xv = _mm256_loadu_si256((const __m256i*)(x + c));
+            __m256i xa = _mm256_abs_epi8(xv);
+            a0 = _mm256_add_epi32(a0, dotI8x32(_mm256_loadu_si256((const __m256i*)(w0 + c)), xa, xv));
+            a1 = _mm256_add_epi32(a1, dotI8x32(_mm256_loadu_si256((const __m256i*)(w0 + cols + c)), xa, xv));
+            a2 = _mm256_add_epi32(a2, dotI8x32(_mm256_loadu_si256((const __m256i*)(w0 + 2 * (size_t)cols + c)), xa, xv));
+            a3 = _mm256_add_epi32(a3, dotI8x32(_mm256_loadu_si256((const __m256i*)(w0 + 3 * (size_t)cols + c)), xa, xv));
+        }
+        __m256i h = _mm256_hadd_epi32(_mm256_hadd_epi32(a0, a1), _mm256_hadd_epi32(a2, a3));
+        __m128i s = _mm_add_epi32(_mm256_castsi256_si128(h), _mm256_extracti128_si256(h, 1));
+        __m128 v = _mm_mul_ps(_mm_mul_ps(_mm_cvtepi32_ps(s), _mm_loadu_ps(rowScale + r)),
+                              _mm_set1_ps(xScale));
+        if (bias) v = _mm_add_ps(v, _mm_loadu_ps(bias + r));
+        _mm_storeu_ps(y + r, v);
+    }
+    gemvI8Sse2(W + (size_t)r * cols, rows - r, cols, x, rowScale + r, xScale,
+               bias ? bias + r : nullptr, y + r);
+}
+
+__attribute__((target("avx2,fma")))
+void axpyAvx2(float a, const float* x, float* y, int n) {
+    __m256 av = _mm256_set1_ps(a);
+    int k = 0;
+    for (; k + 8 <= n; k += 8)
+        _mm256_storeu_ps(y + k, _mm256_fmadd_ps(av, _mm256_loadu_ps(x + k), _mm256_loadu_ps(y + k)));
+    axpyScalar(a, x + k, y + k, n - k);
+}
+
+__attribute__((target("avx2,fma")))
+void reluAvx2(float* v, int n) {
+    int k = 0;
+    for (; k + 8 <= n; k += 8)
+        _mm256_storeu_ps(v + k, _mm256_max_ps(_mm256_loadu_ps(v + k), _mm256_setzero_ps()));
+    reluScalar(v + k, n - k);
+}
+
+__attribute__((target("avx2,fma")))
+void sigmoidAvx2(float* v, int n) {
+    int k = 0;
+    for (; k + 8 <= n; k += 8)
+        _mm256_storeu_ps(v + k, sigmoid256(_mm256_loadu_ps(v + k)));
+    sigmoidScalar(v + k, n - k);
+}
+
+__attribute__((target("avx2,fma")))
+void tanhAvx2(float* v, int n) {
+    int k = 0;
+    for (; k + 8 <= n; k += 8)
+        _mm256_storeu_ps(v + k, tanh256(_mm256_loadu_ps(v + k)));
+    tanhScalar(v + k, n - k);
+}
+
+__attribute__((target("avx2,fma")))
+void lstmCellAvx2(const float* f, const float* i, const float* g, const float* o,
+                  float* c, float* h, int n) {
+    int k = 0;
+    for (; k + 8 <= n; k += 8) {
+        __m256 cv = _mm256_fmadd_ps(_mm256_loadu_ps(f + k), _mm256_loadu_ps(c + k),
+                                    _mm256_mul_ps(_mm256_loadu_ps(i + k), _mm256_loadu_ps(g + k)));
+        _mm256_storeu_ps(c + k, cv);
+        _mm256_storeu_ps(h + k, _mm256_mul_ps(_mm256_loadu_ps(o + k), tanh256(cv)));
+    }
+    lstmCellScalar(f + k, i + k, g + k, o + k, c + k, h + k, n - k);
+}
+
+#endif // WQB_SIMD_X86
+
+// ── Dispatch ──────────────────────────────────────────────────────────────────
+
+struct Kernels {
+    Isa isa;
+    void (*gemv)(const float*, int, int, const float*, const float*, float*);
+    void (*gemm)(const float*, int, int, const float*, int, const float*, float*);
+    void (*axpy)(float, const float*, float*, int);
+    void (*gemvI8)(const int8_t*, int, int, const int8_t*, const float*, float,
+                   const float*, float*);
+    void (*relu)(float*, int);
+    void (*sigmoid)(float*, int);
+    void (*tanh)(float*, int);
+    void (*lstmCell)(const float*, const float*, const float*, const float*,
+                     float*, float*, int);
+};
+
+const Kernels kScalar = { Isa::SCALAR, gemvScalar, gemmScalar, axpyScalar, gemvI8Scalar, reluScalar,
+                          sigmoidScalar, tanhScalar, lstmCellScalar };
+#ifdef WQB_SIMD_X86
+const Kernels kSse2   = { Isa::SSE2, gemvSse2, gemmSse2, axpySse2, gemvI8Sse2, reluSse2, sigmoidSse2,
+                          tanhSse2, lstmCellSse2 };
+const Kernels kAvx2   = { Isa::AVX2, gemvAvx2, gemmAvx2, axpyAvx2, gemvI8Avx2, reluAvx2, sigmoidAvx2,
+                          tanhAvx2, lstmCellAvx2 };
+#endif
+
+const Kernels& kernelsFor(Isa isa) {
+#ifdef WQB_SIMD_X86
+    if (isa == Isa::AVX2) return kAvx2;
+    if (isa == Isa::SSE2) return kSse2;
+#endif
+    (void)isa;
+    return kScalar;
+}
+
+Isa detectIsa() {
+#ifdef WQB_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return Isa::AVX2;
+    if (__builtin_cpu_supports("sse2")) return Isa::SSE2;
+#endif
+    return Isa::SCALAR;
+}
+
+// selected lazily so kernels work even from other static initialisers
+std::atomic<const Kernels*> g_kernels{nullptr};
+
+} // namespace
+
+Isa bestIsa() {
+    static const Isa best = detectIsa();
+    return best;
+}
+
+static const Kernels& active() {
+    const Kernels* k = g_kernels.load(std::memory_order_relaxed);
+    if (!k) {
+        k = &kernelsFor(bestIsa());
+        g_kernels.store(k, std::memory_order_relaxed);
+    }
+    return *k;
+}
+
+Isa activeIsa() { return active().isa; }
+
+const char* isaName(Isa isa) {
+    switch (isa) {
+        case Isa::SCALAR: return "scalar";
+        case Isa::SSE2:   return "sse2";
+        case Isa::AVX2:   return "avx2";
+    }
+    return "scalar";
+}
+
+Isa setIsa(Isa isa) {
+    const Kernels& k = kernelsFor(std::min(isa, bestIsa()));
+    g_kernels.store(&k, std::memory_order_relaxed);
+    return k.isa;
+}
+
+void gemv(const float* W, int rows, int cols, const float* x,
+          const float* bias, float* y) {
+    active().gemv(W, rows, cols, x, bias, y);
+}
+
+void gemm(const float* W, int rows, int cols, const float* X, int n,
+          const float* bias, float* Y) {
+    active().gemm(W, rows, cols, X, n, bias, Y);
+}
+
+void axpy(float a, const float* x, float* y, int n) { active().axpy(a, x, y, n); }
+
+void gemvI8(const int8_t* W, int rows, int cols, const int8_t* x,
+            const float* rowScale, float xScale, const float* bias, float* y) {
+    active().gemvI8(W, rows, cols, x, rowScale, xScale, bias, y);
+}
+void relu(float* v, int n)    { active().relu(v, n); }
+void sigmoid(float* v, int n) { active().sigmoid(v, n); }
+void tanh(float* v, int n)    { active().tanh(v, n); }
+
+void lstmCell(const float* f, const float* i, const float* g, const float* o,
+              float* c, float* h, int n) {
+    active().lstmCell(f, i, g, o, c, h, n);
+}
+
+} // namespace simd
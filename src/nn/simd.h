@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <vector>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+// ── SIMD kernels ──────────────────────────────────────────────────────────────
+//
+// Vectorised building blocks for the Policy forward pass: dense GEMV (and
+// its batched GEMM form), AXPY (embedding row gathers), ReLU and the LSTM
+// gate activations.  Each kernel has a scalar reference
+// implementation plus SSE2 and AVX2/FMA variants on x86; the widest variant
+// the CPU supports is picked once at startup (runtime dispatch, so the
+// binary itself still targets the baseline ISA).
+//
+// gemvI8 is the int8 counterpart used by QuantizedPolicy: int8 weights and
+// inputs, exact int32 accumulation (pmaddwd), then one float rescale per
+// row.
+//
+// The vector sigmoid/tanh use a Cephes-style polynomial exp with a relative
+// error around 1e-7, so results match the scalar path to within float
+// rounding rather than bit for bit.
+// ─────────────────────────────────────────────────────────────────────────────
+
+namespace simd {
+
+enum class Isa { SCALAR, SSE2, AVX2 };
+
+// kernel set currently in use
+Isa         activeIsa();
+const char* isaName(Isa isa);
+// widest kernel set this CPU can run
+Isa         bestIsa();
+// Switch kernel sets (benchmarks / tests).  Requests above bestIsa() are
+// clamped; returns the set actually selected.  Not thread-safe: call it
+// while no forward pass is running.
+Isa         setIsa(Isa isa);
+
+// y[r] = bias[r] + sum_c W[r*cols + c] * x[c]   (bias may be null)
+void gemv(const float* W, int rows, int cols, const float* x,
+          const float* bias, float* y);
+// Batched GEMV: Y[b*rows + r] = bias[r] + sum_c W[r*cols + c] * X[b*cols + c]
+// for each of the `n` inputs stored row by row in X.  Same summation order
+// as one gemv() per input, so results agree to float rounding.
+void gemm(const float* W, int rows, int cols, const float* X, int n,
+          const float* bias, float* Y);
+// y += a * x
+void axpy(float a, const float* x, float* y, int n);
+
+// int8 rows and vectors are zero-padded to a multiple of this many elements
+constexpr int kI8Block = 32;
+inline int padI8(int n) { return (n + kI8Block - 1) / kI8Block * kI8Block; }
+// y[r] = bias[r] + rowScale[r] * xScale * sum_c W[r*cols + c] * x[c]
+// with the sum accumulated exactly in int32.  `cols` must be a multiple of
+// kI8Block (pad W rows and x with zeros); bias may be null.
+void gemvI8(const int8_t* W, int rows, int cols, const int8_t* x,
+            const float* rowScale, float xScale, const float* bias, float* y);
+// v = max(v, 0)
+void relu(float* v, int n);
+// v = 1 / (1 + exp(-v))
+void sigmoid(float* v, int n);
+// v = tanh(v)
+void tanh(float* v, int n);
+// LSTM state update for `n` units given activated gates:
+//   c = f * c + i * g;   h = o * tanh(c)
+void lstmCell(const float* f, const float* i, const float* g, const float* o,
+              float* c, float* h, int n);
+
+// ── Aligned storage ───────────────────────────────────────────────────────────
+
+// Allocator returning `Align`-byte aligned blocks, so weight rows start on a
+// cache line and vector loads never split one.
+template <typename T, size_t Align = 64>
+struct AlignedAllocator {
+    using value_type = T;
+    template <typename U> struct rebind { using other = AlignedAllocator<U, Align>; };
+
+    AlignedAllocator() = default;
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Align>&) {}
+
+    T* allocate(size_t n) {
+        size_t bytes = (n * sizeof(T) + Align - 1) / Align * Align;
+        if (!bytes) bytes = Align;
+#ifdef _WIN32
+        void* p = _aligned_malloc(bytes, Align);
+#else
+        void* p = std::aligned_alloc(Align, bytes);
+#endif
+        if (!p) throw std::bad_alloc();
+        return static_cast<T*>(p);
+    }
+    void deallocate(T* p, size_t) {
+#ifdef _WIN32
+        _aligned_free(p);
+#else
+        std::free(p);
+#endif
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Align>&) const { return true; }
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U, Align>&) const { return false; }
+};
+
+using AlignedFloats = std::vector<float, AlignedAllocator<float>>;
+
+} // namespace simd
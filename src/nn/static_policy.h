@@ -0,0 +1,240 @@
+#pragma once
+
+#include "nn/policy.h"
+#include "nn/simd.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+// ── StaticPolicy ──────────────────────────────────────────────────────────────
+//
+// A Policy whose architecture is fixed at compile time:
+//
+//   StaticPolicy<static_layers::Embedding<1024, 32>, static_layers::Dense<32, 64>,
+//                static_layers::Lstm<64, 64>, ...>
+//
+// Every dimension is a template argument, so parameters are std::array
+// members, activations are std::array locals on the stack and each layer's
+// kind is resolved by overloading rather than a LayerType branch per step.
+// forward() performs no heap allocation and no size checks.  The matrix
+// products still go through the dispatched simd::gemv (the build targets
+// baseline x86-64 and picks AVX2/SSE2 at run time), now with constant
+// sizes; everything between them is fixed-length straight-line code.
+//
+// Parameters use the same layout as Policy, so load() / toPolicy() are
+// plain copies and checkpoints stay interchangeable: load a Trainer
+// checkpoint, then StaticPolicy::load(trainer.policy()).  Outputs are
+// bit-identical to Policy::forward() on the same weights and inputs.
+//
+// The first layer must be an Embedding (inputs are sparse, as in Trainer).
+// The LSTM state lives in the object, like Policy; resetState() clears it.
+// The parameters are held inline (~300 KiB for Trainer's network), so
+// heap-allocate the object rather than putting it on the stack.
+// ─────────────────────────────────────────────────────────────────────────────
+
+namespace static_layers {
+
+// ReLU(W·x + b), weights stored one row per input ([In, Out])
+template <int In, int Out>
+struct Embedding {
+    static constexpr Policy::LayerType kType = Policy::LayerType::EMBEDDING;
+    static constexpr int kIn = In, kOut = Out;
+    static constexpr size_t kWeights = (size_t)In * Out, kBiases = Out;
+    using Output = std::array<float, Out>;
+
+    alignas(64) std::array<float, kWeights> w{};
+    alignas(64) std::array<float, kBiases>  b{};
+
+    static void add(Policy& p) { p.addEmbedding(In, Out); }
+    void resetState() {}
+
+    void forward(const SparseVector& x, Output& y) const {
+        y = b;
+        for (size_t k = 0; k < x.size(); ++k) {
+            int i = x.index[k];
+            if (i < 0 || i >= In) continue;
+            simd::axpy(x.value[k], w.data() + (size_t)i * Out, y.data(), Out);
+        }
+        simd::relu(y.data(), Out);
+    }
+};
+
+// ReLU(W·x + b), weights [Out, In]; Linear is the same without the ReLU
+template <int In, int Out, bool Relu = true>
+struct Dense {
+    static constexpr Policy::LayerType kType =
+        Relu ? Policy::LayerType::DENSE : Policy::LayerType::LINEAR;
+    static constexpr int kIn = In, kOut = Out;
+    static constexpr size_t kWeights = (size_t)In * Out, kBiases = Out;
+    using Output = std::array<float, Out>;
+
+    alignas(64) std::array<float, kWeights> w{};
+    alignas(64) std::array<float, kBiases>  b{};
+
+    static void add(Policy& p) {
+        if constexpr (Relu) p.addDense(In, Out);
+        else                p.addLinear(In, Out);
+    }
+    void resetState() {}
+
+    void forward(const std::array<float, In>& x, Output& y) const {
+        simd::gemv(w.data(), Out, In, x.data(), b.data(), y.data());
+        if constexpr (Relu) simd::relu(y.data(), Out);
+    }
+};
+
+template <int In, int Out>
+using Linear = Dense<In, Out, false>;
+
+// LSTM with all four gates in one [4*Hidden, In+Hidden] matrix (f, i, g, o)
+template <int In, int Hidden>
+struct Lstm {
+    static constexpr Policy::LayerType kType = Policy::LayerType::LSTM;
+    static constexpr int kIn = In, kOut = Hidden;
+    static constexpr size_t kWeights = (size_t)4 * Hidden * (In + Hidden), kBiases = 4 * Hidden;
+    using Output = std::array<float, Hidden>;
+
+    alignas(64) std::array<float, kWeights> w{};
+    alignas(64) std::array<float, kBiases>  b{};
+    alignas(64) Output h{}, c{};
+
+    static void add(Policy& p) { p.addLSTM(In, Hidden); }
+    void resetState() {
+        h.fill(0.0f);
+        c.fill(0.0f);
+    }
+
+    void forward(const std::array<float, In>& x, Output& y) {
+        alignas(64) std::array<float, In + Hidden> xh;
+        alignas(64) std::array<float, 4 * Hidden> gates;
+        std::copy(x.begin(), x.end(), xh.begin());
+        std::copy(h.begin(), h.end(), xh.begin() + In);
+        simd::gemv(w.data(), 4 * Hidden, In + Hidden, xh.data(), b.data(), gates.data());
+        float* f = gates.data();
+        float* i = f + Hidden;
+        float* g = i + Hidden;
+        float* o = g + Hidden;
+        simd::sigmoid(f, 2 * Hidden);
+        simd::tanh(g, Hidden);
+        simd::sigmoid(o, Hidden);
+        simd::lstmCell(f, i, g, o, c.data(), h.data(), Hidden);
+        y = h;
+    }
+};
+
+} // namespace static_layers
+
+template <typename... Layers>
+class StaticPolicy {
+public:
+    static constexpr int kLayers = (int)sizeof...(Layers);
+    template <size_t L>
+    using Layer = std::tuple_element_t<L, std::tuple<Layers...>>;
+    static constexpr int kInputs  = Layer<0>::kIn;
+    static constexpr int kOutputs = Layer<sizeof...(Layers) - 1>::kOut;
+    using Output = std::array<float, kOutputs>;
+
+    static_assert(kLayers > 0, "StaticPolicy needs at least one layer");
+    static_assert(Layer<0>::kType == Policy::LayerType::EMBEDDING,
+                  "the first layer takes sparse input and must be an Embedding");
+
+    StaticPolicy() { checkShapes(std::make_index_sequence<sizeof...(Layers) - 1>{}); }
+
+    // true if `p` has exactly this architecture
+    static bool matches(const Policy& p) {
+        if (p.layerCount() != kLayers) return false;
+        return matchesAll(p, std::index_sequence_for<Layers...>{});
+    }
+
+    // Copy the parameters of `p`; false (nothing changed) if the
+    // architecture differs.  The LSTM state is reset.
+    bool load(const Policy& p) {
+        if (!matches(p)) return false;
+        loadAll(p, std::index_sequence_for<Layers...>{});
+        resetState();
+        return true;
+    }
+
+    // a dynamic Policy with the same architecture and parameters
+    Policy toPolicy() const {
+        Policy p;
+        storeAll(p, std::index_sequence_for<Layers...>{});
+        return p;
+    }
+
+    void resetState() {
+        std::apply([](auto&... layer) { (layer.resetState(), ...); }, m_layers);
+    }
+
+    // one step; the LSTM state carries over to the next call
+    Output forward(const SparseVector& input) {
+        std::tuple<typename Layers::Output...> acts;   // stack-resident
+        std::get<0>(m_layers).forward(input, std::get<0>(acts));
+        runFrom<1>(acts);
+        return std::get<sizeof...(Layers) - 1>(acts);
+    }
+
+    // Reset, feed `seq` one-hot and return the first output after the last
+    // opcode (0 for an empty sequence), like QuantizedPolicy::score().
+    float score(const std::vector<uint8_t>& seq) {
+        resetState();
+        SparseVector x;
+        float out = 0.0f;
+        for (uint8_t op : seq) {
+            x.setOneHot(op);
+            out = forward(x)[0];
+        }
+        return out;
+    }
+
+    template <size_t L>
+    Layer<L>& layer() { return std::get<L>(m_layers); }
+    template <size_t L>
+    const Layer<L>& layer() const { return std::get<L>(m_layers); }
+
+private:
+    template <size_t... L>
+    static constexpr void checkShapes(std::index_sequence<L...>) {
+        static_assert(((Layer<L>::kOut == Layer<L + 1>::kIn) && ...),
+                      "each layer's input must match the previous layer's output");
+    }
+
+    template <size_t L, typename Acts>
+    void runFrom(Acts& acts) {
+        if constexpr (L < sizeof...(Layers)) {
+            std::get<L>(m_layers).forward(std::get<L - 1>(acts), std::get<L>(acts));
+            runFrom<L + 1>(acts);
+        }
+    }
+
+    template <size_t... L>
+    static bool matchesAll(const Policy& p, std::index_sequence<L...>) {
+        return ((p.layerType((int)L) == Layer<L>::kType &&
+                 p.layerInSize((int)L) == Layer<L>::kIn &&
+                 p.layerOutSize((int)L) == Layer<L>::kOut &&
+                 p.layerWeights((int)L).size() == Layer<L>::kWeights &&
+                 p.layerBiases((int)L).size() == Layer<L>::kBiases) && ...);
+    }
+
+    template <size_t... L>
+    void loadAll(const Policy& p, std::index_sequence<L...>) {
+        ((std::copy(p.layerWeights((int)L).begin(), p.layerWeights((int)L).end(),
+                    std::get<L>(m_layers).w.begin()),
+          std::copy(p.layerBiases((int)L).begin(), p.layerBiases((int)L).end(),
+                    std::get<L>(m_layers).b.begin())), ...);
+    }
+
+    template <size_t... L>
+    void storeAll(Policy& p, std::index_sequence<L...>) const {
+        (Layer<L>::add(p), ...);
+        ((p.setLayerWeights((int)L, std::get<L>(m_layers).w),
+          p.setLayerBiases((int)L, std::get<L>(m_layers).b)), ...);
+    }
+
+    std::tuple<Layers...> m_layers;
+};
@@ -1,123 +1,326 @@
 #include "nn/train.h"
+#include "nn/checkpoint.h"
 #include "nn/feature.h"
 #include "nn/loss.h"
+#include "trace.h"
 #include <fstream>
+#include <limits>
+#include <algorithm>
 #include <cmath>
-#include <random>
-
-// simple random integer in [0,n)
-static int hmRandInt(int n) {
-    static thread_local std::mt19937 rng(std::random_device{}());
-    return std::uniform_int_distribution<int>(0, n - 1)(rng);
-}
+#include <cstring>
 
 // ─── Architecture (scaled down) ─────────────────────────────────────────────
-// Layer 0 Dense : kFeatSize(1024) → 32     (compact input projection)
+// Layer 0 Embed : kFeatSize(1024) → 32     (compact input projection; inputs
+//                                           are sparse, so this is a row
+//                                           gather rather than a matvec)
 // Layer 1 Dense : 32 → 64                    (feed into LSTM)
 // Layer 2 LSTM  : 64 → 64                    (temporal context)
 // Layer 3 Dense : 64 → 32                    (dimensionality reduction)
-// Layer 4 Dense : 32 → 1                     (scalar reward prediction)
+// Layer 4 Linear: 32 → 1                     (scalar reward prediction)
 
-Trainer::Trainer() {
-    m_policy.addDense(kFeatSize, 32);    // layer 0
+Trainer::Trainer() : m_rng(std::random_device{}()) {
+    m_policy.addEmbedding(kFeatSize, 32); // layer 0
     m_policy.addDense(32, 64);           // layer 1
     m_policy.addLSTM(64, 64);            // layer 2
     m_policy.addDense(64, 32);           // layer 3
-    m_policy.addDense(32, 1);            // layer 4 (output)
+    m_policy.addLinear(32, 1);           // layer 4 (output)
+    m_policy.initWeights(1);
+    m_policy.prepare(m_grads);
+    m_lanes.push_back(std::make_unique<Lane>());
+    m_policy.prepare(m_lanes[0]->tape);
+}
+
+Trainer::~Trainer() {
+    setThreads(1);
+}
+
+void Trainer::setThreads(int n) {
+    if (n < 1) n = 1;
+    if (n == threads()) return;
+    if (!m_workers.empty()) {
+        {
+            std::lock_guard<std::mutex> lock(m_poolMutex);
+            m_poolStopping = true;
+        }
+        m_poolWake.notify_all();
+        for (auto& w : m_workers) w.join();
+        m_workers.clear();
+        m_poolStopping = false;
+    }
+    m_lanes.resize(1);
+    for (int i = 1; i < n; ++i) {
+        m_lanes.push_back(std::make_unique<Lane>());
+        m_lanes.back()->replica = m_policy;
+        m_policy.prepare(m_lanes.back()->tape);
+    }
+    for (int i = 1; i < n; ++i)
+        m_workers.emplace_back(&Trainer::workerMain, this, i);
 }
 
+// ─── Observation ─────────────────────────────────────────────────────────────
+
 void Trainer::observe(const TelemetryEntry& entry) {
+    TRACE_SCOPE("Trainer::observe", "train");
     m_observations++;
     if (entry.kernelBase64.empty()) return;
 
-    // figure out which branch we will use for this entry
-    auto seq = Feature::extractSequence(entry);
+    // figure out which branch we will use for this entry (decoded at most
+    // once per kernel; see FeatureCache)
+    auto features = Feature::kernel(entry);
+    const std::vector<uint8_t>& seq = features->opcodes;
     m_lastUsedSequence = !seq.empty();
 
-    // do the actual weight update for the current example
-    trainOnEntry(entry);
+    // the new entry first (its loss is this observation's), then replay
+    // samples drawn by priority to fill the mini-batch
+    m_samples.clear();
+    Sample first;
+    first.entry  = &entry;
+    first.seq    = &seq;
+    first.target = normalisedReward(entry.generation);
+    m_samples.push_back(first);
+    int extra = m_replay.empty() ? 0 : kBatchSize - 1;
+    float maxWeight = 0.0f;
+    for (int k = 0; k < extra; ++k) {
+        size_t slot = m_replay.sample(m_rng);
+        const auto& r = m_replay.at(slot);
+        Sample s;
+        s.seq        = &r.features->opcodes;
+        s.target     = normalisedReward(r.generation);
+        s.weight     = (float)m_replay.weight(slot);
+        s.replaySlot = slot;
+        maxWeight = std::max(maxWeight, s.weight);
+        m_samples.push_back(s);
+    }
+    // normalised so replay samples only ever scale their gradient down
+    for (size_t k = 1; k < m_samples.size(); ++k) m_samples[k].weight /= maxWeight;
+    runBatch();
+
+    for (size_t k = 1; k < m_samples.size(); ++k) {
+        const Sample& s = m_samples[k];
+        m_replay.update(s.replaySlot, s.steps ? s.loss / (float)s.steps : 0.0f);
+    }
+    const Sample& own = m_samples[0];
+    m_lastLoss = own.steps ? own.loss / (float)own.steps : 0.0f;
+    m_avgLoss  = m_avgLoss * 0.9f + m_lastLoss * 0.1f;
+
+    // push into replay memory if sequence-based (otherwise histogram only)
+    if (m_lastUsedSequence)
+        m_replay.push({ std::move(features), entry.generation }, m_lastLoss);
+}
 
-    // if we have stored past examples, sample one at random and train on it
-    if (!m_replayBuffer.empty()) {
-        int idx = hmRandInt((int)m_replayBuffer.size());
-        trainOnEntry(m_replayBuffer[idx]);
+float Trainer::trainBatch(const std::vector<std::vector<uint8_t>>& seqs,
+                          const std::vector<float>& targets) {
+    TRACE_SCOPE("Trainer::trainBatch", "train");
+    m_samples.clear();
+    for (size_t k = 0; k < seqs.size() && k < targets.size(); ++k) {
+        Sample s;
+        s.seq    = &seqs[k];
+        s.target = targets[k];
+        m_samples.push_back(s);
     }
+    float loss = runBatch();
+    int steps = 0;
+    for (const auto& s : m_samples) steps += s.steps;
+    return steps ? loss / (float)steps : 0.0f;
+}
+
+float Trainer::trainCorpus(const std::vector<TelemetryEntry>& entries, int batchSize) {
+    TRACE_SCOPE("Trainer::trainCorpus", "train");
+    if (batchSize < 1) batchSize = 1;
+    double loss = 0.0;
+    long steps = 0;
+    for (size_t begin = 0; begin < entries.size(); begin += (size_t)batchSize) {
+        size_t end = std::min(entries.size(), begin + (size_t)batchSize);
+        m_samples.clear();
+        for (size_t i = begin; i < end; ++i) {
+            m_observations++;
+            if (entries[i].kernelBase64.empty()) continue;
+            Sample s;
+            s.entry  = &entries[i];
+            s.target = normalisedReward(entries[i].generation);   // in corpus order
+            m_samples.push_back(s);
+        }
+        if (m_samples.empty()) continue;
+        loss += runBatch();
 
-    // push into replay buffer if sequence-based (otherwise histogram only)
-    if (m_lastUsedSequence) {
-        m_replayBuffer.push_back(entry);
-        if (m_replayBuffer.size() > m_replayCap)
-            m_replayBuffer.erase(m_replayBuffer.begin());
+        // statistics and replay in entry order, as observe() would
+        for (const auto& s : m_samples) {
+            steps += s.steps;
+            m_lastUsedSequence = s.usedSequence;
+            m_lastLoss = s.steps ? s.loss / (float)s.steps : 0.0f;
+            m_avgLoss  = m_avgLoss * 0.9f + m_lastLoss * 0.1f;
+            if (s.usedSequence)
+                m_replay.push({ Feature::kernel(*s.entry), s.entry->generation }, m_lastLoss);
+        }
     }
+    return steps ? (float)(loss / (double)steps) : 0.0f;
 }
 
-// helper that encapsulates the existing logic for a single observation; this
-// lets us easily re-use it when sampling from the replay buffer.
-void Trainer::trainOnEntry(const TelemetryEntry& entry) {
+float Trainer::normalisedReward(int generation) {
     // Reward signal: generation count (higher = kernel survived longer = better)
-    float reward = static_cast<float>(entry.generation);
+    float reward = static_cast<float>(generation);
     if (reward > m_maxReward) m_maxReward = reward;
-    float normReward = m_maxReward > 0.0f ? reward / m_maxReward : 0.0f;
-
-    const float lr = 0.005f;
-    if (m_lastUsedSequence) {
-        auto seq = Feature::extractSequence(entry);
-        m_policy.resetState();
-        for (auto op : seq) {
-            std::vector<float> features(kFeatSize, 0.0f);
-            if (op < kFeatSize) features[op] = 1.0f;
-
-            std::vector<std::vector<float>> acts;
-            m_policy.forwardActivations(features, acts);
-            float prediction = acts.back().empty() ? 0.0f : acts.back()[0];
-            float diff = prediction - normReward;
-            m_lastLoss = diff * diff;
-            m_avgLoss = m_avgLoss * 0.9f + m_lastLoss * 0.1f;
-
-            // only update non-LSTM layers for simplicity
-            for (int l = 0; l < m_policy.layerCount(); ++l) {
-                if (m_policy.layerType(l) == Policy::LayerType::LSTM) continue;
-                const int inl  = m_policy.layerInSize(l);
-                const int outl = m_policy.layerOutSize(l);
-                const auto& input_act = acts[l];
-                auto w = m_policy.layerWeights(l);
-                for (int o = 0; o < outl; ++o)
-                    for (int i = 0; i < inl; ++i)
-                        w[o * inl + i] -= lr * diff * input_act[i];
-                m_policy.setLayerWeights(l, w);
-            }
+    return m_maxReward > 0.0f ? reward / m_maxReward : 0.0f;
+}
+
+// ─── Gradients ───────────────────────────────────────────────────────────────
+
+void Trainer::accumulate(Policy& p, Lane& lane, Sample& s, Policy::Gradients& g) {
+    const std::vector<uint8_t>* seq = s.seq;
+    if (!seq && s.entry) {
+        lane.features = Feature::kernel(*s.entry);
+        seq = &lane.features->opcodes;
+    }
+    Policy::Tape& tape = lane.tape;
+    s.loss = 0.0f;
+    s.usedSequence = seq && !seq->empty();
+
+    if (!s.usedSequence) {
+        if (!s.entry) { s.steps = 0; return; }
+        // opcode histogram: a few dozen non-zero slots out of kFeatSize,
+        // fed as a single step
+        Feature::extractSparse(*s.entry, lane.input);
+        p.resetState();
+        tape.clear();
+        const auto& out = p.forward(lane.input, tape);
+        float diff = (out.empty() ? 0.0f : out[0]) - s.target;
+        tape.last().dOut.assign(1, 2.0f * diff * s.weight);
+        p.backward(tape, g);
+        tape.clear();
+        s.loss  = diff * diff;
+        s.steps = 1;
+        return;
+    }
+
+    // Every opcode predicts the kernel's reward.  The sequence is cut into
+    // kBpttWindow-step windows; the LSTM state carries across a boundary
+    // but the gradient stops there.
+    p.resetState();
+    tape.clear();
+    for (size_t t = 0; t < seq->size(); ++t) {
+        lane.input.setOneHot((*seq)[t]);
+        const auto& out = p.forward(lane.input, tape);
+        float diff = (out.empty() ? 0.0f : out[0]) - s.target;
+        s.loss += diff * diff;
+        tape.last().dOut.assign(1, 2.0f * diff * s.weight);
+        if ((int)tape.length == kBpttWindow || t + 1 == seq->size()) {
+            p.backward(tape, g);
+            tape.clear();
         }
+    }
+    s.steps = (int)seq->size();
+}
+
+void Trainer::runShard(int k, Lane& lane) {
+    // contiguous slice; the layout depends only on the batch size
+    const size_t n = m_samples.size();
+    const size_t begin = n * (size_t)k / (size_t)m_shardCount;
+    const size_t end   = n * (size_t)(k + 1) / (size_t)m_shardCount;
+    Policy::Gradients& g = k == 0 ? m_grads : m_shardGrads[k];
+    if (k != 0) g.zero();
+    Policy& policy = (&lane == m_lanes[0].get()) ? m_policy : lane.replica;
+    for (size_t i = begin; i < end; ++i)
+        accumulate(policy, lane, m_samples[i], g);
+}
+
+void Trainer::workerMain(int laneIndex) {
+    Lane& lane = *m_lanes[laneIndex];
+    uint64_t seen = 0;
+    std::unique_lock<std::mutex> lock(m_poolMutex);
+    for (;;) {
+        m_poolWake.wait(lock, [&] { return m_poolStopping || m_poolGeneration != seen; });
+        if (m_poolStopping) return;
+        seen = m_poolGeneration;
+        while (m_nextShard < m_shardCount) {
+            int k = m_nextShard++;
+            lock.unlock();
+            runShard(k, lane);
+            lock.lock();
+            if (--m_pendingShards == 0) m_poolDone.notify_all();
+        }
+    }
+}
+
+float Trainer::runBatch() {
+    TRACE_SCOPE("Trainer::runBatch", "train");
+    const size_t n = m_samples.size();
+    if (n == 0) return 0.0f;
+    // small batches stay on this thread: no replica copies, no reduction
+    m_shardCount = n < (size_t)kMinParallelBatch ? 1 : (int)std::min(n, (size_t)kMaxShards);
+    if ((int)m_shardGrads.size() < m_shardCount) {
+        size_t from = m_shardGrads.size();
+        m_shardGrads.resize(m_shardCount);
+        for (size_t k = std::max<size_t>(from, 1); k < m_shardGrads.size(); ++k)
+            m_policy.prepare(m_shardGrads[k]);
+    }
+
+    if (m_workers.empty() || m_shardCount == 1) {
+        for (int k = 0; k < m_shardCount; ++k) runShard(k, *m_lanes[0]);
     } else {
-        auto features = Feature::extract(entry);
-
-        std::vector<std::vector<float>> acts;
-        m_policy.forwardActivations(features, acts);
-        float prediction = acts.back().empty() ? 0.0f : acts.back()[0];
-        float diff = prediction - normReward;
-        m_lastLoss = diff * diff;
-        m_avgLoss = m_avgLoss * 0.9f + m_lastLoss * 0.1f;
-
-        for (int l = 0; l < m_policy.layerCount(); ++l) {
-            if (m_policy.layerType(l) == Policy::LayerType::LSTM) continue;
-            const int inl  = m_policy.layerInSize(l);
-            const int outl = m_policy.layerOutSize(l);
-            const auto& input_act = acts[l];
-            auto w = m_policy.layerWeights(l);
-            for (int o = 0; o < outl; ++o)
-                for (int i = 0; i < inl; ++i)
-                    w[o * inl + i] -= lr * diff * input_act[i];
-            m_policy.setLayerWeights(l, w);
+        // workers read a private copy of the weights taken now
+        for (size_t i = 1; i < m_lanes.size(); ++i) m_lanes[i]->replica = m_policy;
+        std::unique_lock<std::mutex> lock(m_poolMutex);
+        m_nextShard     = 0;
+        m_pendingShards = m_shardCount;
+        ++m_poolGeneration;
+        m_poolWake.notify_all();
+        // the calling thread works lane 0 alongside the pool
+        while (m_nextShard < m_shardCount) {
+            int k = m_nextShard++;
+            lock.unlock();
+            runShard(k, *m_lanes[0]);
+            lock.lock();
+            --m_pendingShards;
         }
+        m_poolDone.wait(lock, [&] { return m_pendingShards == 0; });
     }
+
+    // reduce in shard order (shard 0 accumulated straight into m_grads)
+    for (int k = 1; k < m_shardCount; ++k) m_grads.add(m_shardGrads[k]);
+
+    float loss = 0.0f;
+    int steps = 0;
+    for (const auto& smp : m_samples) {
+        loss  += smp.loss;
+        steps += smp.steps;
+    }
+    applyBatch(steps);
+    return loss;
+}
+
+void Trainer::applyBatch(int steps) {
+    if (steps > 0)
+        m_opt.step(m_policy, m_grads, 1.0f / (float)steps);
+    m_grads.zero();
+    m_policy.resetState();   // leave no training sequence in the LSTM state
 }
 
 // ─── Persistence ─────────────────────────────────────────────────────────────
-// Save format per layer:  type in out\n  [weights...]\n  [biases...]\n
-// type: 0=DENSE, 1=LSTM.  LSTM weight count = 4*(in+out)*out; bias = 4*out.
+// Checkpoints are binary (see nn/checkpoint.h): the header carries the
+// statistics, the descriptor table the architecture, and the parameter
+// blobs use the in-memory layout, so loading is a validated memcpy per
+// layer.
 
 bool Trainer::save(const std::string& path) const {
+    TRACE_SCOPE("Trainer::save", "train");
+    CheckpointStats stats;
+    stats.observations = m_observations;
+    stats.avgLoss      = m_avgLoss;
+    stats.maxReward    = m_maxReward;
+    return writeCheckpoint(path, m_policy, stats);
+}
+
+// Legacy text format, per layer:  type in out\n  [weights...]\n  [biases...]\n
+// type: 0=DENSE, 1=LSTM, 2=EMBEDDING, 3=LINEAR.  LSTM weight count =
+// 4*(in+out)*out; bias = 4*out.  EMBEDDING weights are written row-per-input
+// (in×out).  A DENSE layer in the file loads into an EMBEDDING layer of the
+// same shape by transposing, and into a LINEAR layer as is, so checkpoints
+// from before those layer types still load.
+
+bool Trainer::saveText(const std::string& path) const {
     std::ofstream out(path);
     if (!out) return false;
+    out.precision(std::numeric_limits<float>::max_digits10);   // exact round trip
     out << m_observations << "\n";
     out << m_avgLoss << " " << m_maxReward << "\n";
     for (int l = 0; l < m_policy.layerCount(); ++l) {
@@ -139,23 +342,56 @@ void Trainer::reset() {
     m_avgLoss = 0.0f;
     m_lastLoss = 0.0f;
     m_maxReward = 1.0f;
-    m_replayBuffer.clear();
+    m_replay.clear();
     m_lastUsedSequence = false;
 }
 
 
 bool Trainer::load(const std::string& path) {
+    TRACE_SCOPE("Trainer::load", "train");
+    if (!isBinaryCheckpoint(path)) return loadText(path);
+    // validate everything before touching the policy, so a corrupt or
+    // mismatched file leaves the trainer as it was
+    MappedCheckpoint cp;
+    if (!cp.open(path) || !cp.matches(m_policy)) return false;
+    for (int l = 0; l < m_policy.layerCount(); ++l) {
+        ParamView w = m_policy.layerWeightsMut(l);
+        ParamView b = m_policy.layerBiasesMut(l);
+        std::memcpy(w.data, cp.weights(l), w.size * sizeof(float));
+        std::memcpy(b.data, cp.biases(l),  b.size * sizeof(float));
+    }
+    CheckpointStats stats = cp.stats();
+    m_observations     = stats.observations;
+    m_avgLoss          = stats.avgLoss;
+    m_maxReward        = stats.maxReward;
     m_lastUsedSequence = false;
+    m_policy.resetState();
+    m_opt.reset();   // moments belonged to the old weights
+    return true;
+}
+
+bool Trainer::loadText(const std::string& path) {
+    // parse the whole file into staging buffers first, like load() does
+    // for binary files, so a truncated or mismatched one leaves the
+    // trainer as it was
     std::ifstream in(path);
     if (!in) return false;
-    if (!(in >> m_observations)) return false;
-    in >> m_avgLoss >> m_maxReward;
+    CheckpointStats stats;
+    if (!(in >> stats.observations)) return false;
+    in >> stats.avgLoss >> stats.maxReward;
+    std::vector<std::vector<float>> weights(m_policy.layerCount()), biases(m_policy.layerCount());
     for (int l = 0; l < m_policy.layerCount(); ++l) {
         int type = 0, ins = 0, outs = 0;
         if (!(in >> type >> ins >> outs)) return false;
         if (ins  != m_policy.layerInSize(l))  return false;
         if (outs != m_policy.layerOutSize(l)) return false;
-        if (type != (int)m_policy.layerType(l)) return false;
+        const bool fromDense = type == (int)Policy::LayerType::DENSE;
+        const bool denseToEmbedding =
+            fromDense && m_policy.layerType(l) == Policy::LayerType::EMBEDDING;
+        const bool denseToLinear =
+            fromDense && m_policy.layerType(l) == Policy::LayerType::LINEAR;
+        if (type != (int)m_policy.layerType(l) && !denseToEmbedding && !denseToLinear)
+            return false;
         // LSTM weight tensor is 4*(in+out)*out; dense is in*out
         int wcount = (type == (int)Policy::LayerType::LSTM)
                      ? 4 * (ins + outs) * outs
@@ -163,12 +399,31 @@ bool Trainer::load(const std::string& path) {
         int bcount = (type == (int)Policy::LayerType::LSTM)
                      ? 4 * outs
                      : outs;
-        std::vector<float> w(wcount), b(bcount);
+        std::vector<float>& w = weights[l];
+        std::vector<float>& b = biases[l];
+        w.resize(wcount);
+        b.resize(bcount);
         for (float& v : w) if (!(in >> v)) return false;
         for (float& v : b) if (!(in >> v)) return false;
-        m_policy.setLayerWeights(l, w);
-        m_policy.setLayerBiases(l, b);
+        if (denseToEmbedding) {
+            std::vector<float> t(w.size());
+            for (int o = 0; o < outs; ++o)
+                for (int i = 0; i < ins; ++i)
+                    t[(size_t)i * outs + o] = w[(size_t)o * ins + i];
+            w.swap(t);
+        }
+    }
+
+    for (int l = 0; l < m_policy.layerCount(); ++l) {
+        m_policy.setLayerWeights(l, weights[l]);
+        m_policy.setLayerBiases(l, biases[l]);
     }
+    m_observations     = stats.observations;
+    m_avgLoss          = stats.avgLoss;
+    m_maxReward        = stats.maxReward;
+    m_lastUsedSequence = false;
+    m_policy.resetState();
+    m_opt.reset();   // moments belonged to the old weights
     return true;
 }
 
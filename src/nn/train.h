@@ -1,18 +1,100 @@
 #pragma once
 
 #include "policy.h"
+#include "optim.h"
 #include "advisor.h"
+#include "replay.h"
+#include "static_policy.h"
+#include "feature.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
 
 // Trainer applies online updates to a policy network given telemetry data.
+//
+// Each observed kernel is an opcode sequence trained, step by step, toward
+// its normalised reward (generation / best generation seen).  Gradients come
+// from full backpropagation, through time across the LSTM, truncated to
+// windows of kBpttWindow opcodes.  observe() forms a mini-batch of the new
+// entry plus up to kBatchSize-1 replay samples, accumulates their gradients
+// and applies a single optimizer step.  Replay samples are drawn in
+// proportion to their last loss (ReplayMemory, nn/replay.h), their
+// gradients scaled by the importance-sampling weight, and re-prioritised
+// with the loss they just produced.
+//
+// Data parallelism: a batch of at least kMinParallelBatch samples is cut
+// into min(size, kMaxShards) contiguous shards.  Worker threads claim shards
+// and compute their gradients against a per-thread replica of the weights
+// taken at the start of the batch; the shard gradients are then summed in
+// shard order and applied once.  Smaller batches, such as observe()'s, are
+// a single shard on the calling thread: copying every replica would cost
+// more than their few samples of work.  The shard layout depends only on
+// the batch size, so results are identical for any thread count, and with
+// seed() fixed they are reproducible run to run.
 class Trainer {
 public:
+    static constexpr int kBatchSize  = 4;    // entries per optimizer step
+    static constexpr int kBpttWindow = 32;   // opcodes per truncated-BPTT window
+    static constexpr int kMaxShards  = 16;   // gradient buffers per batch
+    static constexpr int kMinParallelBatch = 16;   // smaller batches: one shard, one thread
+    static constexpr int kCorpusBatch = 64;  // entries per step in trainCorpus()
+
+    // The network Trainer builds, fixed at compile time.  Load it from
+    // policy() for allocation-free inference; see nn/static_policy.h.
+    using StaticNet = StaticPolicy<static_layers::Embedding<kFeatSize, 32>,
+                                   static_layers::Dense<32, 64>,
+                                   static_layers::Lstm<64, 64>,
+                                   static_layers::Dense<64, 32>,
+                                   static_layers::Linear<32, 1>>;
+
     Trainer();
+    ~Trainer();
+
+    Trainer(const Trainer&) = delete;
+    Trainer& operator=(const Trainer&) = delete;
+
+    // Use `n` threads (the caller plus n-1 workers) for batch gradients;
+    // n <= 1 trains on the calling thread only.  Do not call concurrently
+    // with training.
+    void setThreads(int n);
+    int  threads() const { return (int)m_workers.size() + 1; }
+
+    // Reseed replay sampling so a run can be reproduced.  Weights are
+    // always initialised from a fixed seed.
+    void seed(uint32_t s) { m_rng.seed(s); }
 
     // observe one telemetry entry and adjust weights accordingly
     void observe(const TelemetryEntry& entry);
 
-    // save/load model state (weights) to disk
+    // One optimizer step over a mini-batch of opcode sequences, each trained
+    // toward targets[k] (a reward already normalised to [0, 1]).  Returns the
+    // mean squared error over all steps, measured during the forward pass.
+    // Does not touch the replay buffer or statistics; allocation-free once
+    // it has seen its longest window.
+    float trainBatch(const std::vector<std::vector<uint8_t>>& seqs,
+                     const std::vector<float>& targets);
+
+    // One pass over `entries` in order, `batchSize` entries per optimizer
+    // step (no replay sampling).  Statistics and the replay buffer are
+    // updated as if each entry had been observe()d, but a pass takes about
+    // entries / batchSize optimizer steps rather than one per entry; pass
+    // batchSize = 1 for per-entry steps.  This is the bulk path for
+    // headless startup; decoding and gradients run on all threads.
+    // Returns the mean per-step loss of the pass.
+    float trainCorpus(const std::vector<TelemetryEntry>& entries,
+                      int batchSize = kCorpusBatch);
+
+    // Save model state (weights and statistics) as a binary checkpoint
+    // (nn/checkpoint.h).  load() maps a binary checkpoint and copies the
+    // blobs straight into the policy; it also still reads the old text
+    // format, which saveText() writes.  Text support is deprecated and will
+    // be dropped in the next release.
     bool save(const std::string& path) const;
+    bool saveText(const std::string& path) const;
     bool load(const std::string& path);
 
     // expose access to underlying policy for inspection/tests
@@ -22,6 +104,7 @@ public:
     int   observations() const { return m_observations; }
     float avgLoss()      const { return m_avgLoss; }
     float lastLoss()     const { return m_lastLoss; }
+    float maxReward()    const { return m_maxReward; }   // reward normaliser
 
     // reset statistics and replay buffer; does not alter network weights.
     // used when kicking off a new training phase so old loss averages and
@@ -30,29 +113,81 @@ public:
 
     // testing hooks
     bool test_lastUsedSequence() const { return m_lastUsedSequence; }
-    int  test_replaySize() const { return (int)m_replayBuffer.size(); }
-    void test_setReplayCap(size_t c) {
-        m_replayCap = c;
-        // trim existing entries if the cap was lowered
-        while (m_replayBuffer.size() > m_replayCap) {
-            m_replayBuffer.erase(m_replayBuffer.begin());
-        }
-    }
+    int  test_replaySize() const { return (int)m_replay.size(); }
+    // lowering the cap keeps the newest entries
+    void test_setReplayCap(size_t c) { m_replay.setCapacity(c); }
+    const ReplayMemory& test_replay() const { return m_replay; }
 
 private:
-    // perform a weight-update for a single telemetry entry; factored out so
-    // we can call it for replay-buffer samples as well.
-    void trainOnEntry(const TelemetryEntry& entry);
+    bool loadText(const std::string& path);
+
+    // One example of a batch.  `seq` may be null, in which case the worker
+    // looks up the features of `entry`; an empty sequence falls back to the
+    // histogram.  Replay samples record their slot and scale their gradient
+    // by `weight`.
+    struct Sample {
+        const TelemetryEntry*       entry = nullptr;
+        const std::vector<uint8_t>* seq   = nullptr;
+        float  target = 0.0f;
+        float  weight = 1.0f;
+        size_t replaySlot = ReplayMemory::npos;
+        // results, written by whichever thread ran the sample
+        float loss  = 0.0f;
+        int   steps = 0;
+        bool  usedSequence = false;
+    };
+
+    // Per-thread training state.  Slot 0 belongs to the calling thread and
+    // trains m_policy itself; the others train a replica synced per batch.
+    struct Lane {
+        Policy               replica;
+        Policy::Tape         tape;
+        SparseVector         input;
+        std::shared_ptr<const KernelFeatures> features;   // of the sample being run
+    };
+
+    // reward of a kernel that reached `generation`, scaled by the best
+    // generation seen so far
+    float normalisedReward(int generation);
+    // Forward + backward over one sample on `policy`, adding its gradient
+    // to `g`; fills sample.loss / steps / usedSequence.
+    static void accumulate(Policy& policy, Lane& lane, Sample& s,
+                           Policy::Gradients& g);
+    // Gradients of m_samples, sharded over the threads and reduced into
+    // m_grads, then one optimizer step.  Returns the summed squared error.
+    float runBatch();
+    // gradient of shard `k` of m_samples into its buffer
+    void runShard(int k, Lane& lane);
+    void workerMain(int lane);
+    // one optimizer step with the mean gradient, then clear the batch
+    void applyBatch(int steps);
 
     // true if last observe() call processed a non-empty opcode sequence
     bool m_lastUsedSequence = false;
     Policy m_policy;
+    Optimizer         m_opt;
+    Policy::Gradients m_grads;       // summed over the current batch
+    std::mt19937      m_rng;         // replay sampling
     int   m_observations = 0;
     float m_avgLoss      = 0.0f;
     float m_lastLoss     = 0.0f;
     float m_maxReward    = 1.0f; // tracks max reward seen for normalisation
 
-    // replay buffer stores recent telemetry entries for mini-batch training
-    std::vector<TelemetryEntry> m_replayBuffer;
-    size_t m_replayCap = 256; // default capacity; can be tuned
+    // ── Batch state ───────────────────────────────────────────────────────────
+    std::vector<Sample>               m_samples;
+    std::vector<std::unique_ptr<Lane>> m_lanes;       // [0] = calling thread
+    std::vector<Policy::Gradients>    m_shardGrads;   // [0] aliases m_grads
+    int m_shardCount = 0;
+
+    // ── Worker pool ───────────────────────────────────────────────────────────
+    std::vector<std::thread> m_workers;               // lanes 1..n-1
+    std::mutex               m_poolMutex;
+    std::condition_variable  m_poolWake, m_poolDone;
+    uint64_t                 m_poolGeneration = 0;    // bumped per batch
+    int                      m_nextShard = 0;         // under m_poolMutex
+    int                      m_pendingShards = 0;
+    bool                     m_poolStopping = false;
+
+    // recent sequence entries for mini-batch training
+    ReplayMemory m_replay;
 };
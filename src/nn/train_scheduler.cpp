@@ -0,0 +1,95 @@
+#include "nn/train_scheduler.h"
+#include "metrics.h"
+
+#include <algorithm>
+
+namespace {
+struct SchedulerMetrics {
+    Gauge&   evolveSec  = metrics().gauge("wqb_evolution_seconds", "App thread wall time spent evolving");
+    Gauge&   trainSec   = metrics().gauge("wqb_training_seconds", "App thread wall time spent in training cycles");
+    Counter& cycles     = metrics().counter("wqb_train_cycles_total", "Training cycles started");
+    Counter& earlyStops = metrics().counter("wqb_train_early_stops_total", "Training cycles stopped early on a loss plateau");
+    Counter& skipped    = metrics().counter("wqb_train_steps_skipped_total", "Budgeted training steps skipped by early stopping");
+};
+
+SchedulerMetrics& schedulerMetrics() {
+    static SchedulerMetrics m;
+    return m;
+}
+} // namespace
+
+TrainingScheduler::TrainingScheduler() : TrainingScheduler(Config{}) {}
+
+TrainingScheduler::TrainingScheduler(const Config& config) : m_config(config) {
+    schedulerMetrics();
+}
+
+bool TrainingScheduler::due(int generation, size_t totalEntries) const {
+    const int    since = generation - m_cycleGeneration;
+    const size_t fresh = newEntries(totalEntries);
+    if (fresh == 0 || since < m_config.minInterval) return false;
+    if (m_foreignEntries >= m_config.minNewEntries &&
+        (float)m_foreignEntries >= m_config.staleFraction * (float)totalEntries)
+        return true;
+    return since >= (m_converged ? m_config.convergedInterval : m_config.interval);
+}
+
+TrainingScheduler::Plan TrainingScheduler::plan(size_t totalEntries) const {
+    size_t cover = totalEntries;
+    if (m_converged) {
+        size_t fresh = newEntries(totalEntries);
+        cover = std::min(totalEntries,
+                         fresh + (size_t)(m_config.rehearsal * (float)(totalEntries - fresh)));
+    }
+    Plan p;
+    p.window = (int)cover;
+    p.steps  = std::max(m_config.minSteps, m_config.epochs * (int)cover);
+    return p;
+}
+
+TrainingScheduler::Plan TrainingScheduler::begin(int generation, size_t totalEntries) {
+    m_plan            = plan(totalEntries);
+    m_cycleGeneration = generation;
+    m_cycleEntries    = totalEntries;
+    m_foreignEntries  = 0;
+    m_converged       = false;
+    m_steps       = 0;
+    m_windowLoss  = -1.0f;
+    m_flatWindows = 0;
+    schedulerMetrics().cycles.inc();
+    return m_plan;
+}
+
+bool TrainingScheduler::step(float avgLoss) {
+    ++m_steps;
+    if (m_steps % m_config.plateauWindow != 0) return false;
+    // the EMA restarts from zero each cycle (Trainer::reset), so the first
+    // window only warms it up
+    if (m_windowLoss < 0.0f) {
+        m_windowLoss = avgLoss;
+        return false;
+    }
+    float gain = m_windowLoss > 0.0f ? (m_windowLoss - avgLoss) / m_windowLoss : 0.0f;
+    m_windowLoss  = avgLoss;
+    m_flatWindows = gain < m_config.plateauTolerance ? m_flatWindows + 1 : 0;
+    if (m_flatWindows < m_config.patience || m_steps < m_config.minSteps) return false;
+    m_converged = true;
+    return true;
+}
+
+void TrainingScheduler::finish(int stepsRun) {
+    auto& m = schedulerMetrics();
+    if (m_converged) m.earlyStops.inc();
+    if (stepsRun < m_plan.steps) m.skipped.inc((uint64_t)(m_plan.steps - stepsRun));
+}
+
+void TrainingScheduler::account(bool training, double seconds) {
+    auto& m = schedulerMetrics();
+    if (training) {
+        m_trainSeconds += seconds;
+        m.trainSec.set(m_trainSeconds);
+    } else {
+        m_evolveSeconds += seconds;
+        m.evolveSec.set(m_evolveSeconds);
+    }
+}
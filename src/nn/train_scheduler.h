@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstddef>
+
+// ── TrainingScheduler ─────────────────────────────────────────────────────────
+//
+// Decides when the App pauses evolution for a training cycle, how many
+// Trainer steps the cycle gets, and when it may stop early.
+//
+//   when    due() once at least minInterval generations have passed and
+//           there is new telemetry: early if entries exported by other
+//           runs (reported through addForeign()) are a large share of the
+//           corpus (the model is stale), otherwise every `interval`
+//           generations, or every `convergedInterval` if the last cycle
+//           ended on a loss plateau.  The running process adds one entry
+//           per generation; those only count toward the regular cadence.
+//   budget  plan() gives `epochs` passes over the entries the cycle should
+//           see: the whole corpus after a cycle that was still improving,
+//           otherwise the new entries plus a `rehearsal` share of the old.
+//           App trains the newest plan().window entries.
+//   stop    step() watches the Trainer's avg-loss EMA; after a warm-up
+//           window it compares the EMA every plateauWindow steps and stops
+//           the cycle once `patience` windows in a row improved by less
+//           than plateauTolerance (relative).
+//
+// It also keeps the App thread's evolution/training wall-time split.
+//
+// Metrics: wqb_evolution_seconds, wqb_training_seconds (cumulative App
+// thread wall time), wqb_train_cycles_total, wqb_train_early_stops_total
+// and wqb_train_steps_skipped_total.
+// ─────────────────────────────────────────────────────────────────────────────
+
+class TrainingScheduler {
+public:
+    struct Config {
+        int    minInterval       = 10;    // generations between cycles, at least
+        int    interval          = 50;    // cadence while the loss still improves
+        int    convergedInterval = 100;   // cadence after a plateau
+        size_t minNewEntries     = 16;    // for an early (stale) cycle
+        float  staleFraction     = 0.2f;  // new / total entries that is stale
+        int    epochs            = 5;     // passes over the cycle's entries
+        int    minSteps          = 30;
+        float  rehearsal         = 0.25f; // share of old entries replayed
+        int    plateauWindow     = 32;    // steps between EMA comparisons
+        float  plateauTolerance  = 0.01f;
+        int    patience          = 2;
+    };
+
+    struct Plan {
+        int steps  = 0;   // Trainer steps budgeted for the cycle
+        int window = 0;   // newest entries to cycle through
+    };
+
+    TrainingScheduler();
+    explicit TrainingScheduler(const Config& config);
+
+    void setConfig(const Config& config) { m_config = config; }
+    const Config& config() const { return m_config; }
+
+    // True if a training cycle should start at `generation` with
+    // `totalEntries` in the corpus.
+    bool due(int generation, size_t totalEntries) const;
+    // Budget for a cycle over `totalEntries`.
+    Plan plan(size_t totalEntries) const;
+    // Start a cycle (also at startup, for the initial corpus): plan it,
+    // reset the plateau detector and remember the corpus size.
+    Plan begin(int generation, size_t totalEntries);
+    // After each training step of the cycle: true to stop now.
+    bool step(float avgLoss);
+    // The cycle ended after `stepsRun` steps (early or on budget).
+    void finish(int stepsRun);
+
+    // entries added since the current/last cycle began
+    size_t newEntries(size_t totalEntries) const {
+        return totalEntries > m_cycleEntries ? totalEntries - m_cycleEntries : 0;
+    }
+    // `n` of the new entries came from other runs (Advisor::rescan())
+    void   addForeign(size_t n) { m_foreignEntries += n; }
+    size_t foreignEntries() const { return m_foreignEntries; }
+    bool converged() const { return m_converged; }   // last cycle hit a plateau
+    int  lastCycleGeneration() const { return m_cycleGeneration; }
+
+    // App-thread wall time, attributed per update() tick
+    void   account(bool training, double seconds);
+    double evolutionSeconds() const { return m_evolveSeconds; }
+    double trainingSeconds()  const { return m_trainSeconds; }
+    double trainingShare() const {
+        double t = m_evolveSeconds + m_trainSeconds;
+        return t > 0.0 ? m_trainSeconds / t : 0.0;
+    }
+
+private:
+    Config m_config;
+    int    m_cycleGeneration = 0;
+    size_t m_cycleEntries    = 0;
+    size_t m_foreignEntries  = 0;   // from other runs since the cycle began
+    bool   m_converged       = false;
+    // plateau detector for the running cycle
+    Plan   m_plan;
+    int    m_steps      = 0;
+    float  m_windowLoss = -1.0f;   // EMA at the last window boundary (< 0: warming up)
+    int    m_flatWindows = 0;
+    double m_evolveSeconds = 0.0;
+    double m_trainSeconds  = 0.0;
+};
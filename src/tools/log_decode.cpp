@@ -0,0 +1,40 @@
+// log_decode – turn a crash-persistent log ring into the text log format.
+//
+// Usage:
+//   log_decode <file.logring> [output.log]
+//
+// Reads a ring written by `bootloader --log-ring` (bin/logs/*.logring),
+// including one left behind by a killed or crashed process, and prints the
+// surviving entries oldest first in the same "[<ms>] [type] message" format
+// as the buffered text log.  Writes to stdout unless an output path is given.
+
+#include "log_ring.h"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+int main(int argc, char** argv) {
+    if (argc < 2 || argc > 3) {
+        std::fprintf(stderr, "usage: %s <file.logring> [output.log]\n", argv[0]);
+        return 2;
+    }
+
+    std::string text;
+    if (!decodeLogRing(argv[1], text)) {
+        std::fprintf(stderr, "log_decode: '%s' is not a readable log ring\n", argv[1]);
+        return 1;
+    }
+
+    if (argc == 3) {
+        std::ofstream out(argv[2], std::ios::binary | std::ios::trunc);
+        out << text;
+        if (!out) {
+            std::fprintf(stderr, "log_decode: cannot write '%s'\n", argv[2]);
+            return 1;
+        }
+    } else {
+        std::fwrite(text.data(), 1, text.size(), stdout);
+    }
+    return 0;
+}
@@ -0,0 +1,118 @@
+// telemetry_tail – reference consumer for the bootloader's live event stream.
+//
+// Usage:
+//   telemetry_tail [name | unix:<path>] [--count N]
+//
+// Attaches to the shared-memory ring created by `bootloader
+// --telemetry-stream=<name>` (or binds the Unix-socket fallback) and prints
+// one line per event together with the publish-to-receive latency.  Start
+// the consumer first when using the socket transport: datagrams sent while
+// nobody is bound are dropped.
+
+#include "telemetry_stream.h"
+#include "util.h"  // stateStr
+
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <time.h>
+
+static volatile std::sig_atomic_t g_stop = 0;
+
+static void onSignal(int) { g_stop = 1; }
+
+static uint64_t monotonicUs() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)ts.tv_nsec / 1000ULL;
+}
+
+static const char* actionName(int a) {
+    switch (a) {
+        case 0: return "modify";
+        case 1: return "insert";
+        case 2: return "add";
+        case 3: return "delete";
+    }
+    return "-";
+}
+
+int main(int argc, char** argv) {
+    std::string spec = "wqb";
+    long limit = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--count") == 0 && i + 1 < argc)
+            limit = std::strtol(argv[++i], nullptr, 10);
+        else
+            spec = argv[i];
+    }
+
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+
+    TelemetrySubscriber sub;
+    if (spec.rfind("unix:", 0) == 0) {
+        if (!sub.open(spec)) {
+            std::fprintf(stderr, "telemetry_tail: cannot bind %s\n", spec.c_str());
+            return 1;
+        }
+    } else {
+        // the publisher may not be up yet: wait a little for its shm ring
+        // before falling back to the socket it would use instead
+        for (int tries = 0; !g_stop && !sub.openShm(spec); ++tries) {
+            if (tries == 10) {
+                std::string path = defaultStreamSocketPath(spec);
+                if (!sub.openSocket(path)) {
+                    std::fprintf(stderr, "telemetry_tail: cannot bind %s\n", path.c_str());
+                    return 1;
+                }
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        }
+    }
+    if (g_stop) return 0;
+    std::fprintf(stderr, "telemetry_tail: attached via %s\n",
+                 sub.transport() == StreamTransport::SHM ? "shared memory" : "unix socket");
+
+    long seen = 0;
+    uint64_t lastSeq = 0;
+    GenerationEvent ev;
+    while (!g_stop && (limit <= 0 || seen < limit)) {
+        if (!sub.poll(ev)) {
+            // short sleep keeps latency in the tens of microseconds without
+            // pinning a core
+            std::this_thread::sleep_for(std::chrono::microseconds(20));
+            continue;
+        }
+        ++seen;
+        uint64_t lat = monotonicUs() - ev.timestampUs;
+        if (lastSeq && ev.seq != lastSeq + 1)
+            std::printf("# gap: %llu event(s) missed\n",
+                        (unsigned long long)(ev.seq - lastSeq - 1));
+        lastSeq = ev.seq;
+
+        if (ev.kind == (uint32_t)StreamEventKind::STATE) {
+            std::printf("%8llu gen=%-6d STATE %s -> %s  (%llu us)\n",
+                        (unsigned long long)ev.seq, ev.generation,
+                        stateStr((SystemState)ev.fromState).c_str(),
+                        stateStr((SystemState)ev.toState).c_str(),
+                        (unsigned long long)lat);
+        } else {
+            std::printf("%8llu gen=%-6d GEN size=%u dur=%.3fms action=%s loss=%.6f trap=%s  (%llu us)\n",
+                        (unsigned long long)ev.seq, ev.generation, ev.kernelSize,
+                        ev.durationMs, actionName(ev.action), ev.loss,
+                        ev.trapCode[0] ? ev.trapCode : "-",
+                        (unsigned long long)lat);
+        }
+        std::fflush(stdout);
+    }
+    if (sub.dropped())
+        std::fprintf(stderr, "telemetry_tail: publisher dropped %llu event(s)\n",
+                     (unsigned long long)sub.dropped());
+    return 0;
+}
@@ -1,6 +1,7 @@
 #include "wasm/evolution.h"
 #include "base64.h"
 #include "kernel.h"  // for Validate mutated binaries
+#include "trace.h"
 
 #include <cstdlib>
 #include <ctime>
@@ -107,8 +108,12 @@ EvolutionResult evolveBinary(
     const std::string&                       currentBase64,
     const std::vector<std::vector<uint8_t>>& knownInstructions,
     int                                      attemptSeed,
-    MutationStrategy                         strategy)
+    MutationStrategy                         strategy,
+    const MutationFilter&                    filter,
+    int                                      maxRerolls)
 {
+    TRACE_SCOPE("evolveBinary", "evolve");
+    TraceScope phase("evolve.parse", "evolve");
     std::vector<uint8_t> bytes = base64_decode(currentBase64);
 
     // helper used repeatedly below: remove any CALL opcodes (0x10) along
@@ -216,16 +221,30 @@ EvolutionResult evolveBinary(
     // generated.
 
     // 4. Evolution logic
+    phase.next("evolve.mutate");
     int action = attemptSeed % 4;
     std::vector<uint8_t> mutationSequence;
     std::vector<uint8_t> newInstructionsBytes;
     std::string          description;
+    int                  rerolls = 0;
+
+    // next genome, sanitised (our mutations must not introduce new calls)
+    // and screened by the caller's filter
+    auto drawGenome = [&]() {
+        auto seq = getGenome(knownInstructions, strategy == MutationStrategy::SMART);
+        stripCalls(seq);
+        while (filter && !seq.empty() && rerolls < maxRerolls && !filter(seq)) {
+            ++rerolls;
+            seq = getGenome(knownInstructions, strategy == MutationStrategy::SMART);
+            stripCalls(seq);
+        }
+        return seq;
+    };
 
     switch (action) {
         case (int)EvolutionAction::MODIFY:
         case (int)EvolutionAction::INSERT: {
-            auto seq = getGenome(knownInstructions, strategy == MutationStrategy::SMART);
-            stripCalls(seq); // ensure our mutation does not introduce new calls
+            auto seq = drawGenome();
             mutationSequence = seq;
             int  idx    = (int)(randF() * (float)(parsedInstructions.size() + 1));
             auto before = flatten(std::vector<Instruction>(
@@ -321,8 +340,7 @@ EvolutionResult evolveBinary(
             break;
         }
         case (int)EvolutionAction::ADD: {
-            auto seq = getGenome(knownInstructions, strategy == MutationStrategy::SMART);
-            stripCalls(seq);
+            auto seq = drawGenome();
             mutationSequence = seq;
             newInstructionsBytes = flatten(parsedInstructions);
             newInstructionsBytes.insert(newInstructionsBytes.end(), seq.begin(), seq.end());
@@ -348,6 +366,7 @@ EvolutionResult evolveBinary(
     }
 
     // 5. Reconstruct binary
+    phase.next("evolve.rebuild");
     std::vector<uint8_t> preInstructions(bytes.begin() + funcContentStart,
                                           bytes.begin() + instructionStart);
     std::vector<uint8_t> postInstructions(bytes.begin() + endOpIndex, bytes.end());
@@ -400,6 +419,7 @@ EvolutionResult evolveBinary(
     // caller's try/catch wrappers to reject the mutation cleanly and
     // continue searching for a different sequence.
     std::string b64 = base64_encode(newBytes);
+    phase.next("evolve.validate");
     {
         try {
             WasmKernel wk;
@@ -417,6 +437,7 @@ EvolutionResult evolveBinary(
     // can observe any internal predictor outputs.  This demonstrates the
     // in-kernel sequence model executing at mutation time; callers can use
     // the resulting floats to bias selection if desired.
+    phase.next("evolve.feedback");
     std::vector<float> feedback;
     try {
         WasmKernel wk;
@@ -439,7 +460,8 @@ EvolutionResult evolveBinary(
         mutationSequence,
         (EvolutionAction)action,
         description,
-        std::move(feedback)
+        std::move(feedback),
+        rerolls
     };
     return result;
 }
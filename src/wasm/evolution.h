@@ -2,6 +2,7 @@
 
 #include "wasm/parser.h"
 #include "cli.h"  // for MutationStrategy (search path includes src/core)
+#include <functional>
 #include <string>
 #include <vector>
 #include <stdexcept>
@@ -29,14 +30,26 @@ struct EvolutionResult {
     // floats (encoded as raw bits) to this vector; sequence-model kernels
     // currently send exactly two values per `run`.
     std::vector<float> weightFeedback;
+
+    int rerolls = 0;   // genomes the MutationFilter rejected before this one
 };
 
+// Optional pre-filter for the instruction sequence a MODIFY/INSERT/ADD
+// mutation would apply: return false to draw another genome.  It runs
+// before the candidate binary is rebuilt and validated, so a rejection
+// costs only the call itself.
+using MutationFilter = std::function<bool(const std::vector<uint8_t>&)>;
+
 // Produce an evolved WASM binary from the current base64-encoded kernel.
 // knownInstructions: previously seen instruction byte sequences for guided mutation.
 // attemptSeed: determines which action to try (cycles through 0-3).
+// filter: if set, up to maxRerolls genomes it rejects are redrawn; the last
+// draw is used either way.
 EvolutionResult evolveBinary(
     const std::string&                             currentBase64,
     const std::vector<std::vector<uint8_t>>&       knownInstructions,
     int                                            attemptSeed,
-    MutationStrategy                               strategy = MutationStrategy::RANDOM
+    MutationStrategy                               strategy = MutationStrategy::RANDOM,
+    const MutationFilter&                          filter = {},
+    int                                            maxRerolls = 0
 );
@@ -1,5 +1,6 @@
 #include "wasm/kernel.h"
 #include "base64.h"
+#include "trace.h"
 
 #include <wasm3.h>
 #include <m3_env.h>
@@ -111,6 +112,7 @@ void WasmKernel::bootDynamic(const std::string& glob,
                                WeightCallback     weightCb,
                                KillCallback       killCb)
 {
+    TraceScope phase("wasm3.setup", "wasm3");
     terminate();
 
     m_wasmBytes = base64_decode(glob);
@@ -138,6 +140,7 @@ void WasmKernel::bootDynamic(const std::string& glob,
         throw std::runtime_error("wasm3: failed to create runtime");
     }
 
+    phase.next("wasm3.parse");
     M3Result err = m3_ParseModule(m_env, &m_module,
                                    m_wasmBytes.data(),
                                    (uint32_t)m_wasmBytes.size());
@@ -146,6 +149,7 @@ void WasmKernel::bootDynamic(const std::string& glob,
         throw std::runtime_error(std::string("wasm3 parse: ") + err);
     }
 
+    phase.next("wasm3.load");
     err = m3_LoadModule(m_runtime, m_module);
     if (err) {
         terminate();
@@ -153,6 +157,7 @@ void WasmKernel::bootDynamic(const std::string& glob,
     }
 
     // Link host functions
+    phase.next("wasm3.link");
     err = m3_LinkRawFunction(m_module, "env", "log", "v(ii)", hostLogImpl);
     if (err && err != m3Err_functionLookupFailed)
         throw std::runtime_error(std::string("wasm3 link log: ") + err);
@@ -198,7 +203,9 @@ void WasmKernel::runDynamic(const std::string& sourceGlob) {
 
     memcpy(wMem, sourceGlob.data(), srcLen);
 
-    // Call run(0, srcLen)
+    // Call run(0, srcLen); host imports (env.log -> verification and
+    // evolution) run inside this span
+    TRACE_SCOPE("wasm3.call", "wasm3");
     M3Result err = m3_CallV(m_runFunc, (uint32_t)0, srcLen);
     if (err)
         throw std::runtime_error(std::string("wasm3 call 'run': ") + err);
@@ -2,8 +2,12 @@
 #include <catch2/catch_approx.hpp>
 using Catch::Approx;
 #include "nn/advisor.h"
+#include "constants.h"  // KERNEL_GLOB
 #include <filesystem>
 #include <fstream>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
 
 namespace fs = std::filesystem;
 
@@ -115,3 +119,124 @@ TEST_CASE("Advisor can accept manually added entries and score them", "[advisor]
     REQUIRE(su <= 1.0f);
     REQUIRE(su >= 0.0f);
 }
+
+TEST_CASE("Advisor append decodes sequences and rescan only reads new files", "[advisor][ingest]") {
+    fs::path root = fs::temp_directory_path() / "advtest_ingest";
+    fs::remove_all(root);
+    fs::create_directories(root / "self");
+    fs::create_directories(root / "other");
+    writeExport(root / "self" / "gen_1.txt", 1, "AAA");
+    writeExport(root / "other" / "gen_1.txt", 4, "BBB");
+
+    // the skipped run directory is never parsed from disk
+    Advisor adv(root.string(), "self");
+    REQUIRE(adv.size() == 1);
+    REQUIRE(adv.entries()[0].generation == 4);
+
+    // appended entries get their opcode sequence filled in when missing
+    TelemetryEntry te;
+    te.generation   = 2;
+    te.kernelBase64 = KERNEL_GLOB;
+    adv.append(te);
+    REQUIRE(adv.size() == 2);
+    REQUIRE(adv.entries().back().generation == 2);
+    REQUIRE(adv.score(adv.entries().back().opcodeSequence) == Approx(1.0f));
+
+    // nothing new on disk: rescan adds nothing
+    REQUIRE(adv.rescan() == 0);
+    REQUIRE(adv.size() == 2);
+
+    // a new export from another run is picked up exactly once
+    writeExport(root / "other" / "gen_2.txt", 6, "CCC");
+    writeExport(root / "self" / "gen_2.txt", 2, "DDD");
+    REQUIRE(adv.rescan() == 1);
+    REQUIRE(adv.size() == 3);
+    REQUIRE(adv.rescan() == 0);
+
+    fs::remove_all(root);
+}
+
+TEST_CASE("Advisor rescan waits for a run whose exporter holds the lock", "[advisor][ingest]") {
+    fs::path root = fs::temp_directory_path() / "advtest_lock";
+    fs::remove_all(root);
+    fs::create_directories(root / "other");
+    writeExport(root / "other" / "gen_1.txt", 3, "AAA");
+    Advisor adv(root.string());
+    REQUIRE(adv.size() == 1);
+
+    // an exporter mid-write, as App::autoExport() holds it
+    int lockfd = ::open((root / "other" / "export.lock").c_str(), O_CREAT | O_RDWR, 0666);
+    REQUIRE(lockfd >= 0);
+    REQUIRE(flock(lockfd, LOCK_EX) == 0);
+    writeExport(root / "other" / "gen_2.txt", 5, "BBB");
+    REQUIRE(adv.rescan() == 0);
+
+    // once released the file is read, exactly once
+    flock(lockfd, LOCK_UN);
+    ::close(lockfd);
+    REQUIRE(adv.rescan() == 1);
+    REQUIRE(adv.entries().back().generation == 5);
+    REQUIRE(adv.rescan() == 0);
+
+    fs::remove_all(root);
+}
+
+TEST_CASE("Advisor keeps a sequence index and running aggregates", "[advisor][index]") {
+    Advisor adv("nonexistent_dir");
+    REQUIRE(adv.averageGeneration() == 0.0f);
+    REQUIRE(adv.bestGeneration({1, 2, 3}) == -1);
+
+    TelemetryEntry a;
+    a.generation     = 4;
+    a.opcodeSequence = {1, 2, 3};
+    TelemetryEntry b = a;
+    b.generation = 9;              // same sequence, later generation
+    TelemetryEntry c;
+    c.generation = 2;              // no sequence: counted, not indexed
+    adv.test_addEntry(a);
+    adv.test_addEntry(b);
+    adv.test_addEntry(c);
+
+    REQUIRE(adv.bestGeneration({1, 2, 3}) == 9);
+    REQUIRE(adv.bestGeneration({1, 2}) == -1);
+    REQUIRE(adv.bestGeneration({}) == -1);
+    REQUIRE(adv.averageGeneration() == Approx(5.0f));
+
+    // the fallback score is the cached average mapped into (0,1]
+    REQUIRE(adv.score({1, 2, 3}) == Approx(1.0f));
+    REQUIRE(adv.score({}) == Approx(5.0f / 15.0f));
+    REQUIRE(adv.score({7}) == Approx(5.0f / 15.0f));
+
+    // appended entries update both
+    TelemetryEntry d;
+    d.generation   = 13;
+    d.kernelBase64 = KERNEL_GLOB;
+    adv.append(d);
+    REQUIRE(adv.bestGeneration(adv.entries().back().opcodeSequence) == 13);
+    REQUIRE(adv.averageGeneration() == Approx(7.0f));
+}
+
+TEST_CASE("Advisor likelihood score separates trapped from successful opcodes", "[advisor][ngram]") {
+    Advisor adv("nonexistent_dir");
+    // no evidence yet
+    REQUIRE(adv.likelihoodScore({ 0x20, 0x21 }) == Approx(0.5f));
+
+    for (int i = 0; i < 5; ++i) {
+        TelemetryEntry ok;
+        ok.generation     = i;
+        ok.opcodeSequence = { 0x20, 0x21, 0x6a, 0x0b };
+        adv.test_addEntry(ok);
+    }
+    // one model alone is still no evidence
+    REQUIRE(adv.likelihoodScore({ 0x20, 0x21 }) == Approx(0.5f));
+
+    TelemetryEntry trap;
+    trap.generation     = 6;
+    trap.trapCode       = "unreachable";
+    trap.opcodeSequence = { 0x00, 0x00, 0x1a, 0x0b };
+    adv.test_addEntry(trap);
+
+    REQUIRE(adv.likelihoodScore({ 0x20, 0x21, 0x6a }) > 0.6f);
+    REQUIRE(adv.likelihoodScore({ 0x00, 0x00, 0x1a }) < 0.4f);
+    REQUIRE(adv.likelihoodScore({}) == Approx(0.5f));
+}
@@ -3,9 +3,11 @@
 using Catch::Approx;
 #include <cmath>
 #include <filesystem>
+#include <fstream>
 #include "util.h"  // for executableDir()
 #include "app.h"
 #include "constants.h"  // for KERNEL_SEQ
+#include "nn/feature.h"
 
 TEST_CASE("Blacklist helper methods behave correctly", "[app]") {
     CliOptions opts;
@@ -30,6 +32,32 @@ TEST_CASE("handleBootFailure records trap reason and blacklists mutation", "[app
     REQUIRE(a.isBlacklisted(seq));
 }
 
+TEST_CASE("a trapped generation is recorded with the kernel that trapped", "[app][advisor]") {
+    CliOptions opts;
+    opts.telemetryDir   = "trap_kernel_test";
+    opts.telemetryLevel = TelemetryLevel::NONE;
+    App a(opts);
+    // the repair candidate is already installed when the reboot happens;
+    // retry until the repair actually changed the kernel (a mutation can
+    // fail and fall back to the stable kernel)
+    std::string trapped;
+    for (int tries = 0; tries < 20; ++tries) {
+        trapped = a.currentKernel();
+        a.test_simulateFailure("trap XYZ", {0x10, 0x20});
+        if (a.currentKernel() != trapped) break;
+    }
+    REQUIRE(a.currentKernel() != trapped);
+    const std::vector<uint8_t> opcodes = FeatureCache::global().get(trapped)->opcodes;
+    REQUIRE(!opcodes.empty());
+    a.doReboot(false);
+
+    const TelemetryEntry& e = a.advisor().entries().back();
+    REQUIRE(e.kernelBase64 == trapped);
+    REQUIRE(e.trapCode == "trap XYZ");
+    // Advisor::add routes entries with a trap code into the trap model
+    REQUIRE(e.opcodeSequence == opcodes);
+}
+
 TEST_CASE("exportHistory includes trap reason after failure", "[export]") {
     CliOptions opts;
     opts.heuristic = HeuristicMode::BLACKLIST;
@@ -90,12 +118,28 @@ TEST_CASE("App saves trainer state to CLI option", "[app][trainer]") {
     te.kernelBase64 = a.currentKernel();
     te.trapCode = a.lastTrapReason();
     a.trainAndMaybeSave(te);
+    a.flushCheckpoints();   // written on the checkpointer thread
     REQUIRE(std::filesystem::exists("trainer_save.tmp"));
+    REQUIRE_FALSE(std::filesystem::exists("trainer_save.tmp.tmp"));
     Trainer t;
     REQUIRE(t.load("trainer_save.tmp"));
     std::remove("trainer_save.tmp");
 }
 
+TEST_CASE("App trainer snapshot views the live trainer when not async", "[app][trainer]") {
+    CliOptions opts;
+    App a(opts);
+    REQUIRE_FALSE(a.backgroundTraining());
+    TelemetryEntry te;
+    te.generation = 2;
+    te.kernelBase64 = a.currentKernel();
+    a.trainAndMaybeSave(te);
+    auto snap = a.trainerSnapshot();
+    REQUIRE(snap->policy.get() == &a.trainer().policy());
+    REQUIRE(snap->observations == a.trainer().observations());
+    REQUIRE(snap->lastLoss == a.trainer().lastLoss());
+}
+
 TEST_CASE("spawnInstance records kernels and logs", "[app][spawn]") {
     CliOptions opts;
     App a(opts);
@@ -138,9 +182,9 @@ TEST_CASE("App.log helper adds entries", "[app][log]") {
     // The constructor may auto-load a model checkpoint and add a log
     // entry; record the baseline size rather than assuming zero.
     size_t baseline = a.logs().size();
-    a.log("test message", "debug");
+    a.log("test message", LogType::DEBUG);
     REQUIRE(a.logs().size() == baseline + 1);
-    REQUIRE(a.logs().back().message == "test message");
+    REQUIRE(a.logs().back().message() == "test message");
 }
 
 TEST_CASE("App respects CLI kernel selection", "[app][cli]") {
@@ -254,6 +298,61 @@ TEST_CASE("evolution auto-stops at configured generation and switches to trainin
     REQUIRE(a.trainingPhase() != TrainingPhase::COMPLETE);
 }
 
+TEST_CASE("App starts training cycles on the scheduler's cadence and stops them on a plateau", "[app][scheduler]") {
+    namespace fs = std::filesystem;
+    CliOptions opts;
+    opts.telemetryDir   = "cadence_test";
+    opts.telemetryLevel = TelemetryLevel::NONE;
+    fs::remove_all(App(opts).seqBaseDir());
+    App a(opts);
+    a.enableEvolution();
+    const auto& cfg = a.scheduler().config();
+
+    auto evolveUntilTraining = [&](int limit) {
+        for (int i = 0; i < limit && a.evolutionEnabled(); ++i) a.doReboot(true);
+        return a.generation();
+    };
+    auto finishCycle = [&] {
+        a.test_forceTrainingPhase(TrainingPhase::COMPLETE);
+        a.test_forceModelSaved(true);
+        a.update();
+        REQUIRE(a.evolutionEnabled());
+    };
+
+    // the run's own entry per generation never counts as stale data: the
+    // first cycle comes on the regular cadence
+    REQUIRE(evolveUntilTraining(4 * kAutoTrainGen) == kAutoTrainGen);
+    REQUIRE(a.scheduler().lastCycleGeneration() == kAutoTrainGen);
+    finishCycle();
+
+    // a burst of exports from another run makes the model stale: the next
+    // cycle starts after the minimum interval
+    fs::create_directories(a.seqBaseDir() / "other_run");
+    for (int g = 1; g <= 40; ++g) {
+        std::ofstream o(a.seqBaseDir() / "other_run" / ("gen_" + std::to_string(g) + ".txt"));
+        o << "Final Generation: " << g << "\n";
+        o << "CURRENT KERNEL (BASE64):\n" << KERNEL_GLOB << "\n";
+    }
+    REQUIRE(evolveUntilTraining(4 * kAutoTrainGen) == kAutoTrainGen + cfg.minInterval);
+    REQUIRE(a.scheduler().foreignEntries() == 0);   // consumed by the cycle
+
+    // run that cycle through update(); any window that does not halve the
+    // loss counts as flat, so it stops after warm-up plus `patience` windows
+    TrainingScheduler::Config flat = cfg;
+    flat.plateauTolerance = 1.0f;
+    a.test_scheduler().setConfig(flat);
+    for (int i = 0; i < 2000 && a.trainingPhase() != TrainingPhase::COMPLETE; ++i) a.update();
+    REQUIRE(a.trainingPhase() == TrainingPhase::COMPLETE);
+    REQUIRE(a.scheduler().converged());
+    REQUIRE(a.test_trainingStep() - a.test_trainingLoadEnd() == (1 + flat.patience) * flat.plateauWindow);
+
+    // after a plateau the cadence relaxes to convergedInterval
+    const int cycleGen = a.generation();
+    finishCycle();
+    REQUIRE(evolveUntilTraining(4 * kAutoTrainGen) == cycleGen + cfg.convergedInterval);
+    fs::remove_all(a.seqBaseDir());
+}
+
 TEST_CASE("update() re-enables evolution when training has already completed", "[app][evolution]") {
     CliOptions opts;
     App a(opts);
@@ -287,3 +386,60 @@ TEST_CASE("evolution/training cycles can repeat indefinitely", "[app][cycle]") {
     REQUIRE(!a.evolutionEnabled());
 }
 
+
+TEST_CASE("doReboot feeds the advisor directly without a disk rescan", "[app][advisor]") {
+    namespace fs = std::filesystem;
+    CliOptions opts;
+    opts.telemetryDir = "feed_test";
+    opts.telemetryLevel = TelemetryLevel::NONE; // nothing written to disk
+    struct TestApp : App { using App::telemetryRoot; explicit TestApp(const CliOptions& o) : App(o) {} };
+    TestApp a(opts);
+    size_t before = a.advisor().size();
+    a.doReboot(true);
+    a.doReboot(true);
+    REQUIRE(a.advisor().size() == before + 2);
+    const auto& last = a.advisor().entries().back();
+    REQUIRE(last.generation == a.generation());
+    REQUIRE(last.kernelBase64 == a.currentKernel());
+    REQUIRE(!last.opcodeSequence.empty());
+    fs::remove_all(a.telemetryRoot());
+}
+
+TEST_CASE("autoExport writes only new history and appends it to history.log", "[app][export]") {
+    namespace fs = std::filesystem;
+    CliOptions opts;
+    opts.telemetryDir = "history_test";
+    opts.telemetryLevel = TelemetryLevel::FULL;
+    struct TestApp : App { using App::telemetryRoot; explicit TestApp(const CliOptions& o) : App(o) {} };
+    TestApp a(opts);
+    fs::remove_all(a.telemetryRoot());
+    auto slurp = [](const fs::path& p) {
+        std::ifstream f(p);
+        return std::string((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+    };
+    auto count = [](const std::string& s, const std::string& needle) {
+        size_t n = 0;
+        for (size_t p = s.find(needle); p != std::string::npos; p = s.find(needle, p + 1)) ++n;
+        return n;
+    };
+
+    a.test_simulateFailure("first trap", {});
+    a.doReboot(true);
+    a.test_simulateFailure("second trap", {});
+    a.doReboot(true);
+
+    fs::path run = a.telemetryRoot() / a.runId();
+    std::string gen2 = slurp(run / ("gen_" + std::to_string(a.generation()) + ".txt"));
+    REQUIRE(gen2.find("second trap") != std::string::npos);
+    REQUIRE(gen2.find("first trap") == std::string::npos);
+
+    std::string log = slurp(run / "history.log");
+    REQUIRE(count(log, "first trap") == 1);
+    REQUIRE(count(log, "second trap") == 1);
+
+    // the GUI export still renders the whole ledger
+    std::string full = a.exportHistory();
+    REQUIRE(full.find("first trap") != std::string::npos);
+    REQUIRE(full.find("second trap") != std::string::npos);
+    fs::remove_all(a.telemetryRoot());
+}
@@ -0,0 +1,266 @@
+#include <catch2/catch_test_macros.hpp>
+#include "nn/checkpoint.h"
+#include "nn/checkpointer.h"
+#include "metrics.h"
+#include "nn/train.h"
+#include "constants.h"  // KERNEL_GLOB
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+namespace {
+
+std::string readFile(const std::string& path) {
+    std::ifstream f(path, std::ios::binary);
+    return std::string((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+}
+
+void writeFile(const std::string& path, const std::string& data) {
+    std::ofstream f(path, std::ios::binary | std::ios::trunc);
+    f.write(data.data(), (std::streamsize)data.size());
+}
+
+void trainSome(Trainer& t) {
+    TelemetryEntry e;
+    e.generation   = 7;
+    e.kernelBase64 = KERNEL_GLOB;
+    for (int i = 0; i < 3; ++i) t.observe(e);
+}
+
+} // namespace
+
+TEST_CASE("crc32 matches the IEEE check value", "[checkpoint]") {
+    const char* s = "123456789";
+    REQUIRE(crc32(s, 9) == 0xCBF43926u);
+    // incremental use gives the same result
+    REQUIRE(crc32(s + 4, 5, crc32(s, 4)) == 0xCBF43926u);
+    REQUIRE(crc32(nullptr, 0) == 0u);
+}
+
+TEST_CASE("Binary checkpoint maps with aligned blobs and exact weights", "[checkpoint]") {
+    Trainer t;
+    trainSome(t);
+    std::string path = "checkpoint_layout.tmp";
+    REQUIRE(t.save(path));
+    REQUIRE(isBinaryCheckpoint(path));
+
+    MappedCheckpoint cp;
+    REQUIRE(cp.open(path));
+    REQUIRE(cp.matches(t.policy()));
+    REQUIRE(cp.header().version == CheckpointHeader::kVersion);
+    REQUIRE(cp.header().fileSize == std::filesystem::file_size(path));
+    REQUIRE(cp.stats().observations == t.observations());
+    REQUIRE(cp.stats().avgLoss == t.avgLoss());
+
+    const Policy& p = t.policy();
+    for (int l = 0; l < cp.layerCount(); ++l) {
+        REQUIRE(cp.layer(l).weightOffset % 64 == 0);
+        REQUIRE(cp.layer(l).biasOffset % 64 == 0);
+        REQUIRE(reinterpret_cast<uintptr_t>(cp.weights(l)) % 64 == 0);
+        REQUIRE(std::memcmp(cp.weights(l), p.layerWeights(l).data(),
+                            p.layerWeights(l).size() * sizeof(float)) == 0);
+        REQUIRE(std::memcmp(cp.biases(l), p.layerBiases(l).data(),
+                            p.layerBiases(l).size() * sizeof(float)) == 0);
+    }
+    cp.close();
+
+    Trainer t2;
+    REQUIRE(t2.load(path));
+    REQUIRE(t2.observations() == t.observations());
+    for (int l = 0; l < p.layerCount(); ++l) {
+        REQUIRE(t2.policy().layerWeights(l) == p.layerWeights(l));
+        REQUIRE(t2.policy().layerBiases(l) == p.layerBiases(l));
+    }
+    std::remove(path.c_str());
+}
+
+TEST_CASE("Corrupt or truncated checkpoints are rejected without side effects", "[checkpoint]") {
+    Trainer t;
+    trainSome(t);
+    std::string path = "checkpoint_corrupt.tmp";
+    REQUIRE(t.save(path));
+    const std::string good = readFile(path);
+
+    Trainer fresh;
+    const auto w0 = fresh.policy().layerWeights(0);
+
+    SECTION("flipped bit in a weight blob") {
+        std::string bad = good;
+        bad[bad.size() / 2] ^= 0x10;
+        writeFile(path, bad);
+    }
+    SECTION("flipped bit in the statistics") {
+        std::string bad = good;
+        bad[offsetof(CheckpointHeader, avgLoss)] ^= 0x01;
+        writeFile(path, bad);
+    }
+    SECTION("truncated") {
+        writeFile(path, good.substr(0, good.size() - 4));
+    }
+    SECTION("newer version") {
+        std::string bad = good;
+        uint32_t v = CheckpointHeader::kVersion + 1;
+        std::memcpy(&bad[offsetof(CheckpointHeader, version)], &v, sizeof(v));
+        writeFile(path, bad);
+    }
+
+    MappedCheckpoint cp;
+    REQUIRE_FALSE(cp.open(path));
+    REQUIRE_FALSE(fresh.load(path));
+    REQUIRE(fresh.observations() == 0);
+    REQUIRE(fresh.policy().layerWeights(0) == w0);
+    std::remove(path.c_str());
+}
+
+TEST_CASE("Binary checkpoint for another architecture does not load", "[checkpoint]") {
+    Policy other;
+    other.addDense(4, 2);
+    other.initWeights(3);
+    std::string path = "checkpoint_arch.tmp";
+    REQUIRE(writeCheckpoint(path, other, CheckpointStats{}));
+
+    MappedCheckpoint cp;
+    REQUIRE(cp.open(path));
+    REQUIRE(cp.matches(other));
+
+    Trainer t;
+    REQUIRE_FALSE(cp.matches(t.policy()));
+    REQUIRE_FALSE(t.load(path));
+    std::remove(path.c_str());
+}
+
+TEST_CASE("Text checkpoints from the previous release still load", "[checkpoint]") {
+    Trainer t;
+    trainSome(t);
+    std::string path = "checkpoint_text.tmp";
+    REQUIRE(t.saveText(path));
+    REQUIRE_FALSE(isBinaryCheckpoint(path));
+
+    Trainer t2;
+    REQUIRE(t2.load(path));
+    REQUIRE(t2.observations() == t.observations());
+    for (int l = 0; l < t.policy().layerCount(); ++l)
+        REQUIRE(t2.policy().layerWeights(l) == t.policy().layerWeights(l));
+
+    // and a binary save of the loaded model matches one of the original
+    std::string a = "checkpoint_text_a.tmp", b = "checkpoint_text_b.tmp";
+    REQUIRE(t.save(a));
+    REQUIRE(t2.save(b));
+    REQUIRE(readFile(a) == readFile(b));
+    std::remove(path.c_str());
+    std::remove(a.c_str());
+    std::remove(b.c_str());
+}
+
+TEST_CASE("A truncated text checkpoint leaves the trainer unchanged", "[checkpoint]") {
+    Trainer t;
+    trainSome(t);
+    std::string path = "checkpoint_text_cut.tmp";
+    REQUIRE(t.saveText(path));
+    // drop the last line (the output layer's biases): every other layer
+    // parses before the file runs out
+    std::string text = readFile(path);
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out << text.substr(0, text.rfind('\n', text.size() - 2) + 1);
+    }
+
+    Trainer t2;
+    std::vector<simd::AlignedFloats> before;
+    for (int l = 0; l < t2.policy().layerCount(); ++l)
+        before.push_back(t2.policy().layerWeights(l));
+    REQUIRE_FALSE(t2.load(path));
+    REQUIRE(t2.observations() == 0);
+    for (int l = 0; l < t2.policy().layerCount(); ++l)
+        REQUIRE(t2.policy().layerWeights(l) == before[l]);
+    std::remove(path.c_str());
+}
+
+TEST_CASE("Checkpointer trigger policy", "[checkpoint][checkpointer]") {
+    CheckpointPolicy p;
+    p.everyGenerations = 10;
+    p.minImprovement   = 0.1f;
+    Checkpointer c(p);
+
+    REQUIRE(c.due(1, 0.5f));   // nothing saved yet
+    c.mark(1, 0.5f);
+    REQUIRE_FALSE(c.due(2, 0.5f));
+    REQUIRE_FALSE(c.due(10, 0.46f));   // < 10% better, < 10 generations
+    REQUIRE(c.due(11, 0.5f));          // periodic
+    REQUIRE(c.due(5, 0.44f));          // improvement
+
+    p.everyGenerations = 0;
+    p.minImprovement   = 0.0f;
+    c.setPolicy(p);
+    REQUIRE_FALSE(c.due(1000, 0.0f));
+}
+
+TEST_CASE("Checkpointer writes atomically in the background", "[checkpoint][checkpointer]") {
+    Trainer t;
+    trainSome(t);
+    auto model = std::make_shared<const Policy>(t.policy());
+    CheckpointStats stats;
+    stats.observations = t.observations();
+    stats.avgLoss      = t.avgLoss();
+
+    Histogram& latency = metrics().histogram("wqb_checkpoint_seconds", "");
+    Counter&   bytes   = metrics().counter("wqb_checkpoint_bytes_total", "");
+    uint64_t latency0 = latency.count(), bytes0 = bytes.value();
+
+    std::string path = "checkpointer_out.tmp";
+    Checkpointer c;
+    for (int i = 0; i < 5; ++i) c.submit(model, stats, path);
+    c.flush();
+
+    // every submission was either written or replaced by a newer one
+    REQUIRE(c.written() >= 1);
+    REQUIRE(c.written() + c.coalesced() == 5);
+    REQUIRE(c.failures() == 0);
+    REQUIRE_FALSE(std::filesystem::exists(path + ".tmp"));
+    REQUIRE(latency.count() - latency0 == c.written());
+    REQUIRE(bytes.value() - bytes0 == c.written() * std::filesystem::file_size(path));
+
+    Trainer loaded;
+    REQUIRE(loaded.load(path));
+    REQUIRE(loaded.observations() == t.observations());
+    REQUIRE(loaded.policy().layerWeights(0) == t.policy().layerWeights(0));
+
+    // a second path is not coalesced with the first
+    std::string other = "checkpointer_other.tmp";
+    c.submit(model, stats, path);
+    c.submit(model, stats, other);
+    c.stop();
+    REQUIRE(std::filesystem::exists(other));
+    std::remove(path.c_str());
+    std::remove(other.c_str());
+}
+
+TEST_CASE("Checkpointer counts failed writes and leaves no temp file", "[checkpoint][checkpointer]") {
+    Policy p;
+    p.addDense(4, 2);
+    std::string path = "no_such_dir_for_checkpoints/model.dat";
+    Checkpointer c;
+    c.submit(std::make_shared<const Policy>(p), CheckpointStats{}, path);
+    c.flush();
+    REQUIRE(c.failures() == 1);
+    REQUIRE(c.written() == 0);
+    REQUIRE_FALSE(std::filesystem::exists(path));
+}
+
+TEST_CASE("renameDurable replaces the target in a relative or nested path", "[checkpoint]") {
+    writeFile("durable_a.tmp", "new");
+    writeFile("durable_b.tmp", "old");
+    REQUIRE(renameDurable("durable_a.tmp", "durable_b.tmp"));
+    REQUIRE_FALSE(std::filesystem::exists("durable_a.tmp"));
+    REQUIRE(readFile("durable_b.tmp") == "new");
+
+    std::filesystem::create_directories("durable_dir.tmp");
+    REQUIRE(renameDurable("durable_b.tmp", "durable_dir.tmp/b"));
+    REQUIRE(readFile("durable_dir.tmp/b") == "new");
+    REQUIRE_FALSE(renameDurable("durable_missing.tmp", "durable_dir.tmp/c"));
+    std::filesystem::remove_all("durable_dir.tmp");
+}
@@ -137,3 +137,65 @@ TEST_CASE("CLI invalid --max-run-ms sets parseError") {
     CliOptions opts = parseCli(2, const_cast<char**>(argv));
     REQUIRE(opts.parseError == true);
 }
+
+TEST_CASE("CLI --metrics-interval-ms parsing") {
+    const char* none[] = {"bootloader"};
+    REQUIRE(parseCli(1, const_cast<char**>(none)).metricsIntervalMs == 5000);
+
+    const char* argv[] = {"bootloader", "--metrics-interval-ms=0"};
+    CliOptions opts = parseCli(2, const_cast<char**>(argv));
+    REQUIRE(opts.metricsIntervalMs == 0);
+    REQUIRE(opts.parseError == false);
+
+    const char* bad[] = {"bootloader", "--metrics-interval-ms", "-5"};
+    REQUIRE(parseCli(3, const_cast<char**>(bad)).parseError == true);
+}
+
+TEST_CASE("CLI --log-ring parsing") {
+    const char* none[] = {"bootloader"};
+    REQUIRE(parseCli(1, const_cast<char**>(none)).logRing == false);
+
+    const char* argv[] = {"bootloader", "--log-ring"};
+    CliOptions opts = parseCli(2, const_cast<char**>(argv));
+    REQUIRE(opts.logRing == true);
+    REQUIRE(opts.parseError == false);
+}
+
+TEST_CASE("CLI --train-threads parsing") {
+    const char* none[] = {"bootloader"};
+    REQUIRE(parseCli(1, const_cast<char**>(none)).trainThreads == 0);
+
+    const char* argv[] = {"bootloader", "--train-threads=6"};
+    CliOptions opts = parseCli(2, const_cast<char**>(argv));
+    REQUIRE(opts.trainThreads == 6);
+    REQUIRE(opts.parseError == false);
+
+    const char* bad[] = {"bootloader", "--train-threads", "x"};
+    REQUIRE(parseCli(3, const_cast<char**>(bad)).parseError == true);
+}
+
+TEST_CASE("CLI --async-train parsing") {
+    const char* none[] = {"bootloader"};
+    REQUIRE(parseCli(1, const_cast<char**>(none)).asyncTrain == false);
+
+    const char* argv[] = {"bootloader", "--async-train"};
+    CliOptions opts = parseCli(2, const_cast<char**>(argv));
+    REQUIRE(opts.asyncTrain == true);
+    REQUIRE(opts.parseError == false);
+}
+
+TEST_CASE("CLI --checkpoint-every parsing") {
+    const char* none[] = {"bootloader"};
+    REQUIRE(parseCli(1, const_cast<char**>(none)).checkpointEvery == 10);
+
+    const char* argv[] = {"bootloader", "--checkpoint-every=50"};
+    CliOptions opts = parseCli(2, const_cast<char**>(argv));
+    REQUIRE(opts.checkpointEvery == 50);
+    REQUIRE(opts.parseError == false);
+
+    const char* zero[] = {"bootloader", "--checkpoint-every", "0"};
+    REQUIRE(parseCli(3, const_cast<char**>(zero)).checkpointEvery == 0);
+
+    const char* bad[] = {"bootloader", "--checkpoint-every=-1"};
+    REQUIRE(parseCli(2, const_cast<char**>(bad)).parseError == true);
+}
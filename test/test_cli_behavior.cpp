@@ -65,7 +65,7 @@ TEST_CASE("profile flag outputs log entries", "[cli]") {
     // log buffer should contain at least one PROFILE line
     bool found = false;
     for (auto& e : a.logs()) {
-        if (e.message.find("PROFILE") != std::string::npos) { found = true; break; }
+        if (e.message().find("PROFILE") != std::string_view::npos) { found = true; break; }
     }
     REQUIRE(found);
 }
@@ -100,6 +100,32 @@ TEST_CASE("mutationSequence does not contain CALL instructions", "[evolution][sa
     }
 }
 
+TEST_CASE("MutationFilter screens genomes before the candidate is built", "[evolution][filter]") {
+    // seed 2 -> ADD, which draws a genome
+    int calls = 0;
+    MutationFilter rejectAll = [&](const std::vector<uint8_t>& seq) {
+        REQUIRE_FALSE(seq.empty());
+        ++calls;
+        return false;
+    };
+    try {
+        auto res = evolveBinary(KERNEL_GLOB, {}, 2, MutationStrategy::RANDOM, rejectAll, 3);
+        REQUIRE(res.rerolls == 3);
+    } catch (const std::exception&) {
+        // validation failure is acceptable; the filter has run by then
+    }
+    REQUIRE(calls == 3);   // capped, the last draw is used unscreened
+
+    calls = 0;
+    MutationFilter acceptAll = [&](const std::vector<uint8_t>&) { ++calls; return true; };
+    try {
+        auto res = evolveBinary(KERNEL_GLOB, {}, 2, MutationStrategy::RANDOM, acceptAll, 3);
+        REQUIRE(res.rerolls == 0);
+    } catch (const std::exception&) {
+    }
+    REQUIRE(calls == 1);
+}
+
 TEST_CASE("regression: known bad kernel should trap", "[evolution][regression]") {
     std::string bad =
         "AGFzbQEAAAABCgJgAn9/AGABfwACHQIDZW52A2xvZwAAA2Vudgtncm93X21lbW9yeQABAwIBAAUDAQABBxACBm1lbW9yeQIAA3J1bgACCvQDAfEDAEE"
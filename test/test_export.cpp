@@ -6,7 +6,6 @@ TEST_CASE("buildReport includes telemetry metrics when provided") {
     d.generation = 42;
     d.currentKernel = "AA==";
     d.instructions = {};
-    d.logs = {};
     d.history = {};
     d.mutationsAttempted = 2;
     d.mutationsApplied = 1;
@@ -20,7 +19,8 @@ TEST_CASE("buildReport includes telemetry metrics when provided") {
     d.kernelSizeMax = 20;
     d.heuristicBlacklistCount = 5;
     d.advisorEntryCount = 3;
-    d.instances = {"AAA","BBB"};
+    std::vector<std::string> instances = {"AAA","BBB"};
+    d.instances = instances;
 
     std::string report = buildReport(d);
     REQUIRE(report.find("Mutations Attempted: 2") != std::string::npos);
@@ -36,3 +36,32 @@ TEST_CASE("buildReport includes telemetry metrics when provided") {
     // new field should be present even if sequence empty
     REQUIRE(report.find("OPCODE SEQUENCE:") != std::string::npos);
 }
+
+TEST_CASE("ReportWriter only renders the sections the telemetry level needs", "[export]") {
+    ExportData d;
+    d.generation = 7;
+    d.currentKernel = "AGFzbQEAAAA=";
+    std::vector<HistoryEntry> history = {
+        { 7, "2026-01-02T03:04:05.678Z", 8, "EVOLVE", "ok", true } };
+    d.history = history;
+
+    ReportWriter w;
+    REQUIRE(w.build(d, TelemetryLevel::NONE).empty());
+
+    std::string basic = w.build(d, TelemetryLevel::BASIC);
+    REQUIRE(basic.find("Final Generation: 7") != std::string::npos);
+    REQUIRE(basic.find("HEX DUMP:") == std::string::npos);
+    REQUIRE(basic.find("HISTORY LOG:") == std::string::npos);
+
+    // the writer is reused; a FULL report must match the one-shot builder
+    // apart from the timestamp line
+    std::string full = w.build(d, TelemetryLevel::FULL);
+    REQUIRE(full.find("0x0000  00 61 73 6D 01 00 00 00") != std::string::npos);
+    REQUIRE(full.find("[GEN 0007]") != std::string::npos);
+    REQUIRE(full.find("END OF REPORT") != std::string::npos);
+    auto stripTs = [](std::string s) {
+        auto p = s.find("Generated: ");
+        return s.erase(p, s.find('\n', p) - p);
+    };
+    REQUIRE(stripTs(full) == stripTs(buildReport(d)));
+}
@@ -1,7 +1,9 @@
 #include <catch2/catch_test_macros.hpp>
 #include "nn/feature.h"
+#include "nn/train.h"
 #include "constants.h"
 #include "base64.h"
+#include <thread>
 
 TEST_CASE("Feature extractor produces opcode histogram", "[feature]") {
     TelemetryEntry e;
@@ -37,3 +39,83 @@ TEST_CASE("Feature extractor produces opcode histogram", "[feature]") {
     auto seq2 = Feature::extractSequence(e);
     REQUIRE(seq2.empty());
 }
+
+TEST_CASE("Kernel features match the instruction parser", "[feature][cache]") {
+    TelemetryEntry e;
+    e.kernelBase64 = KERNEL_GLOB;
+    auto f = Feature::kernel(e);
+    REQUIRE(f);
+
+    auto insts = extractCodeSection(base64_decode(KERNEL_GLOB));
+    REQUIRE(f->opcodes.size() == insts.size());
+    std::vector<float> counts(256, 0.0f);
+    for (size_t i = 0; i < insts.size(); ++i) {
+        REQUIRE(f->opcodes[i] == insts[i].opcode);
+        counts[insts[i].opcode] += 1.0f;
+    }
+    for (size_t k = 0; k < f->histogram.size(); ++k) {
+        REQUIRE(counts[f->histogram.index[k]] == f->histogram.value[k]);
+        if (k) REQUIRE(f->histogram.index[k] > f->histogram.index[k - 1]);
+    }
+
+    // the sparse and dense extractors agree, trap flag included
+    e.trapCode = "trap";
+    auto dense = Feature::extract(e);
+    SparseVector sparse;
+    Feature::extractSparse(e, sparse);
+    REQUIRE(sparse.index.back() == 256);
+    std::vector<float> rebuilt(kFeatSize, 0.0f);
+    for (size_t k = 0; k < sparse.size(); ++k) rebuilt[sparse.index[k]] = sparse.value[k];
+    REQUIRE(rebuilt == dense);
+
+    // no kernel: empty features, never null
+    TelemetryEntry none;
+    REQUIRE(Feature::kernel(none));
+    REQUIRE(Feature::kernel(none)->opcodes.empty());
+}
+
+TEST_CASE("Each kernel is decoded once per process", "[feature][cache]") {
+    FeatureCache& cache = FeatureCache::global();
+    cache.clear();
+    const uint64_t before = cache.decodes();
+
+    // the Advisor decodes on ingest and keeps the features on the entry
+    Advisor adv("nonexistent_dir");
+    TelemetryEntry a, b;
+    a.generation = 3;  a.kernelBase64 = KERNEL_GLOB;
+    b.generation = 5;  b.kernelBase64 = KERNEL_SEQ;
+    adv.append(a);
+    adv.append(b);
+    REQUIRE(cache.decodes() - before == 2);
+
+    // the Trainer reuses them: observe, replay samples and corpus training
+    Trainer t;
+    for (int i = 0; i < 4; ++i) {
+        t.observe(adv.entries()[i % 2]);
+        t.observe(a);   // a fresh entry without features hits the cache
+    }
+    t.trainCorpus(adv.entries(), 2);
+    REQUIRE(t.test_replaySize() > 0);
+
+    // and so do the plain extractors
+    Feature::extract(a);
+    Feature::extractSequence(b);
+    SparseVector sv;
+    Feature::extractSparse(b, sv);
+
+    REQUIRE(cache.decodes() - before == 2);
+    REQUIRE(cache.hits() > 0);
+}
+
+TEST_CASE("Concurrent misses on one kernel decode it once", "[feature][cache]") {
+    FeatureCache cache;
+    std::vector<std::shared_ptr<const KernelFeatures>> results(8);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < results.size(); ++i)
+        threads.emplace_back([&, i] { results[i] = cache.get(KERNEL_SEQ); });
+    for (auto& t : threads) t.join();
+
+    REQUIRE(cache.decodes() == 1);
+    REQUIRE(cache.hits() == results.size() - 1);
+    for (const auto& r : results) REQUIRE(r == results[0]);
+}
@@ -0,0 +1,199 @@
+#include <catch2/catch_test_macros.hpp>
+#include "log.h"
+#include "log_ring.h"
+#include <csignal>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+
+static std::string slurp(const std::string& path) {
+    std::ifstream f(path);
+    return std::string((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+}
+
+TEST_CASE("Logger ring keeps the newest entries with monotonic ids", "[log]") {
+    AppLogger logger;
+    REQUIRE(logger.lastId() == 0);
+    REQUIRE(logger.logs().empty());
+
+    const size_t total = AppLogger::MAX_LOG_ENTRIES + 25;
+    for (size_t i = 0; i < total; ++i)
+        logger.log("msg " + std::to_string(i), LogType::WARNING);
+
+    REQUIRE(logger.lastId() == total);
+    REQUIRE(logger.size() == AppLogger::MAX_LOG_ENTRIES);
+
+    std::vector<LogEntry> snap;
+    logger.snapshot(snap);
+    REQUIRE(snap.size() == AppLogger::MAX_LOG_ENTRIES);
+    REQUIRE(snap.front().id == 26);
+    REQUIRE(snap.front().message() == "msg 25");
+    REQUIRE(snap.back().id == total);
+    REQUIRE(snap.back().type == LogType::WARNING);
+    for (size_t i = 1; i < snap.size(); ++i)
+        REQUIRE(snap[i].id == snap[i - 1].id + 1);
+}
+
+TEST_CASE("Logger snapshots copy only what was logged since the last one", "[log]") {
+    AppLogger logger;
+    std::vector<LogEntry> snap;
+    logger.snapshot(snap);
+    REQUIRE(snap.empty());
+
+    for (int i = 0; i < 10; ++i) logger.log("early " + std::to_string(i));
+    logger.snapshot(snap);
+    REQUIRE(snap.size() == 10);
+    const LogEntry* data = snap.data();
+    logger.snapshot(snap);   // unchanged: left as is
+    REQUIRE(snap.size() == 10);
+    REQUIRE(snap.data() == data);
+
+    // wrap the ring: the stale head is dropped and the result matches a
+    // fresh snapshot, also after the ring lapped the old one entirely
+    for (size_t n : { AppLogger::MAX_LOG_ENTRIES - 3, AppLogger::MAX_LOG_ENTRIES * 2 }) {
+        for (size_t i = 0; i < n; ++i) logger.log("late " + std::to_string(i));
+        logger.snapshot(snap);
+        std::vector<LogEntry> fresh = logger.logs();
+        REQUIRE(snap.size() == fresh.size());
+        for (size_t i = 0; i < snap.size(); ++i) {
+            REQUIRE(snap[i].id == fresh[i].id);
+            REQUIRE(snap[i].message() == fresh[i].message());
+        }
+    }
+}
+
+TEST_CASE("Logger deduplicates repeats and truncates long messages", "[log]") {
+    AppLogger logger;
+    logger.log("same", LogType::INFO);
+    logger.log("same", LogType::INFO);
+    REQUIRE(logger.lastId() == 1);
+
+    std::string longMsg(LogEntry::MAX_MESSAGE + 100, 'x');
+    logger.log(longMsg, LogType::ERROR);
+    auto logs = logger.logs();
+    REQUIRE(logs.back().message().size() == LogEntry::MAX_MESSAGE);
+    REQUIRE(logs.back().text[LogEntry::MAX_MESSAGE] == '\0');
+    // the cut is marked, and the head is kept
+    std::string_view kept = logs.back().message();
+    REQUIRE(kept.substr(kept.size() - LogEntry::TRUNCATED_MARK.size()) == LogEntry::TRUNCATED_MARK);
+    REQUIRE(kept.substr(0, 10) == std::string(10, 'x'));
+    // a repeat of the long message is still deduplicated
+    uint64_t id = logger.lastId();
+    logger.log(longMsg, LogType::ERROR);
+    REQUIRE(logger.lastId() == id);
+
+    // a message that fits exactly is left alone
+    std::string exact(LogEntry::MAX_MESSAGE, 'y');
+    logger.log(exact, LogType::INFO);
+    REQUIRE(logger.logs().back().message() == exact);
+
+    // never cut inside a multi-byte character
+    std::string wide;
+    while (wide.size() < LogEntry::MAX_MESSAGE + 10) wide += "\xC3\xA9";   // "é"
+    logger.log(wide, LogType::INFO);
+    std::string_view w = logger.logs().back().message();
+    std::string_view head = w.substr(0, w.size() - LogEntry::TRUNCATED_MARK.size());
+    REQUIRE(head.size() % 2 == 0);
+    REQUIRE(head.substr(head.size() - 2) == "\xC3\xA9");
+}
+
+TEST_CASE("Logger flush writes formatted lines to the file", "[log]") {
+    std::string path = "test_log_flush.log";
+    std::filesystem::remove(path);
+    {
+        AppLogger logger;
+        logger.init(path);
+        logger.log("first line", LogType::SYSTEM);
+        logger.log("second line", LogType::MUTATION);
+        logger.flush();
+        std::string text = slurp(path);
+        REQUIRE(text.find("=== Session started") != std::string::npos);
+        REQUIRE(text.find("] [system] first line\n") != std::string::npos);
+        REQUIRE(text.find("] [mutation] second line\n") != std::string::npos);
+
+        // flushing again must not duplicate anything
+        logger.flush();
+        REQUIRE(slurp(path) == text);
+
+        logger.log("written on destruction", LogType::INFO);
+    }
+    std::string text = slurp(path);
+    REQUIRE(text.find("] [info] written on destruction\n") != std::string::npos);
+    std::filesystem::remove(path);
+    std::filesystem::remove(path + ".lock");
+}
+
+TEST_CASE("Logger accepts entries from several threads", "[log]") {
+    std::string path = "test_log_threads.log";
+    std::filesystem::remove(path);
+    {
+        AppLogger logger;
+        logger.init(path);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&logger, t] {
+                for (int i = 0; i < 200; ++i)
+                    logger.log("t" + std::to_string(t) + " #" + std::to_string(i), LogType::DEBUG);
+            });
+        }
+        for (auto& th : threads) th.join();
+        REQUIRE(logger.lastId() == 800);
+    }
+    // every entry reaches the file exactly once (the ring never wrapped
+    // past an unflushed entry at this volume)
+    std::string text = slurp(path);
+    size_t lines = 0;
+    for (size_t p = text.find("] [debug] "); p != std::string::npos;
+         p = text.find("] [debug] ", p + 1))
+        ++lines;
+    REQUIRE(lines == 800);
+    std::filesystem::remove(path);
+    std::filesystem::remove(path + ".lock");
+}
+
+TEST_CASE("Mapped log ring survives SIGKILL and decodes to the text format", "[log][ring]") {
+    std::string path = "test_log_ring_" + std::to_string(getpid()) + ".logring";
+    std::filesystem::remove(path);
+
+    pid_t pid = fork();
+    REQUIRE(pid >= 0);
+    if (pid == 0) {
+        // child: log, never flush or destruct, then die hard
+        AppLogger logger;
+        if (!logger.initMapped(path, 8)) _exit(3);
+        for (int i = 1; i <= 10; ++i)
+            logger.log("entry " + std::to_string(i), i % 2 ? LogType::INFO : LogType::ERROR);
+        raise(SIGKILL);
+        _exit(4);
+    }
+    int status = 0;
+    REQUIRE(waitpid(pid, &status, 0) == pid);
+    REQUIRE(WIFSIGNALED(status));
+    REQUIRE(WTERMSIG(status) == SIGKILL);
+
+    std::string text;
+    REQUIRE(decodeLogRing(path, text));
+    REQUIRE(text.rfind("=== Session started ", 0) == 0);
+    REQUIRE(text.find("[... 2 earlier entries overwritten ...]\n") != std::string::npos);
+    REQUIRE(text.find("] entry 2\n") == std::string::npos);
+    REQUIRE(text.find("] [info] entry 3\n") != std::string::npos);
+    size_t p9  = text.find("] [info] entry 9\n");
+    size_t p10 = text.find("] [error] entry 10\n");
+    REQUIRE(p9 != std::string::npos);
+    REQUIRE(p10 != std::string::npos);
+    REQUIRE(p9 < p10);
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("decodeLogRing rejects files that are not rings", "[log][ring]") {
+    std::string path = "test_log_not_a_ring.log";
+    { std::ofstream f(path); f << std::string(2048, 'x'); }
+    std::string text;
+    REQUIRE_FALSE(decodeLogRing(path, text));
+    REQUIRE_FALSE(decodeLogRing("does_not_exist.logring", text));
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,97 @@
+#include <catch2/catch_test_macros.hpp>
+#include "metrics.h"
+#include "app.h"
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+TEST_CASE("Counters and gauges are registered once by name", "[metrics]") {
+    MetricsRegistry reg;
+    Counter& c = reg.counter("test_events_total", "events");
+    c.inc();
+    reg.counter("test_events_total", "events").inc(2);
+    REQUIRE(c.value() == 3);
+
+    Gauge& g = reg.gauge("test_level", "level");
+    g.set(1.5);
+    REQUIRE(reg.gauge("test_level", "level").value() == 1.5);
+
+    std::string text = reg.renderPrometheus();
+    REQUIRE(text.find("# TYPE test_events_total counter\ntest_events_total 3\n") != std::string::npos);
+    REQUIRE(text.find("# TYPE test_level gauge\ntest_level 1.5\n") != std::string::npos);
+}
+
+TEST_CASE("Histogram buckets are log-linear with bounded error", "[metrics]") {
+    // every value falls inside its bucket and buckets are contiguous
+    for (uint64_t v : {0ULL, 1ULL, 7ULL, 8ULL, 9ULL, 1000ULL, 123456789ULL, 1ULL << 40}) {
+        int i = Histogram::bucketIndex(v);
+        REQUIRE(v < Histogram::bucketUpperNs(i));
+        if (i > 0) REQUIRE(v >= Histogram::bucketUpperNs(i - 1));
+    }
+    for (int i = Histogram::kSubBuckets * 2; i < Histogram::kBuckets; ++i) {
+        double lo = (double)Histogram::bucketUpperNs(i - 1);
+        double hi = (double)Histogram::bucketUpperNs(i);
+        REQUIRE((hi - lo) / lo <= 1.0 / Histogram::kSubBuckets + 1e-12);
+    }
+
+    Histogram h;
+    for (int i = 1; i <= 1000; ++i) h.observeNs((uint64_t)i * 1000);  // 1 µs .. 1 ms
+    REQUIRE(h.count() == 1000);
+    double p50 = h.quantileSeconds(0.5);
+    double p99 = h.quantileSeconds(0.99);
+    REQUIRE(p50 >= 500e-6);
+    REQUIRE(p50 <= 500e-6 * 1.125 + 1e-9);
+    REQUIRE(p99 >= 990e-6);
+    REQUIRE(p99 <= 990e-6 * 1.125 + 1e-9);
+    REQUIRE(h.countBelow(1ULL << 20) == 1000);  // 2^20 ns > 1 ms
+}
+
+TEST_CASE("Prometheus histogram output is cumulative and written atomically", "[metrics]") {
+    MetricsRegistry reg;
+    Histogram& h = reg.histogram("test_latency_seconds", "latency");
+    h.observeSeconds(0.002);
+    h.observeSeconds(0.5);
+    std::string text = reg.renderPrometheus();
+    REQUIRE(text.find("# TYPE test_latency_seconds histogram") != std::string::npos);
+    REQUIRE(text.find("test_latency_seconds_bucket{le=\"1.024e-06\"} 0\n") != std::string::npos);
+    REQUIRE(text.find("test_latency_seconds_bucket{le=\"0.004194304\"} 1\n") != std::string::npos);
+    REQUIRE(text.find("test_latency_seconds_bucket{le=\"+Inf\"} 2\n") != std::string::npos);
+    REQUIRE(text.find("test_latency_seconds_count 2\n") != std::string::npos);
+
+    std::string path = "metrics_test.prom";
+    REQUIRE(reg.writeTextfile(path));
+    REQUIRE(!std::filesystem::exists(path + ".tmp"));
+    std::ifstream f(path);
+    std::string onDisk((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+    REQUIRE(onDisk == text);
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("App rewrites the textfile on the metrics interval", "[metrics][app]") {
+    namespace fs = std::filesystem;
+    uint64_t t = 0;
+    CliOptions opts;
+    opts.telemetryDir      = "metrics_app_test";
+    opts.telemetryLevel    = TelemetryLevel::NONE;
+    opts.metricsIntervalMs = 1000;
+    struct TestApp : App {
+        using App::App;
+        using App::telemetryRoot;
+    };
+    TestApp a(opts, [&] { return t; });
+    fs::path prom = a.telemetryRoot() / "bootloader.prom";
+    fs::remove(prom);
+
+    t = 500;
+    a.update();
+    REQUIRE(!fs::exists(prom));
+    t = 1000;
+    a.update();
+    REQUIRE(fs::exists(prom));
+
+    std::ifstream f(prom);
+    std::string text((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+    REQUIRE(text.find("wqb_generation ") != std::string::npos);
+    REQUIRE(text.find("# TYPE wqb_boot_seconds histogram") != std::string::npos);
+    fs::remove_all(a.telemetryRoot());
+}
@@ -0,0 +1,37 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+using Catch::Approx;
+#include "nn/ngram.h"
+
+#include <cmath>
+#include <vector>
+
+TEST_CASE("OpcodeNgram uses trigram counts when it has them", "[ngram]") {
+    OpcodeNgram m;
+    REQUIRE(m.logLikelihood(std::vector<uint8_t>{}) == 0.0);
+    m.add({ 1, 2, 3 });
+    m.add({ 1, 2, 4 });
+    REQUIRE(m.sequences() == 2);
+    REQUIRE(m.tokens() == 6);
+
+    // P(1) add-one unigram, P(2|1) = 1, P(3|1,2) = 1/2
+    double expected = std::log(3.0 / 262.0) + std::log(1.0) + std::log(0.5);
+    REQUIRE(m.logLikelihood({ 1, 2, 3 }) == Approx(expected));
+}
+
+TEST_CASE("OpcodeNgram backs off to shorter histories", "[ngram]") {
+    OpcodeNgram m;
+    m.add({ 1, 2, 3 });
+    m.add({ 5, 2, 9 });
+
+    // (1,2,9) unseen but context (1,2) known: backoff to P(9|2) = 1/2
+    double viaBigram = std::log(OpcodeNgram::kBackoff) + std::log(0.5);
+    REQUIRE(m.logLikelihood({ 1, 2, 9 }) - m.logLikelihood({ 1, 2 }) == Approx(viaBigram));
+
+    // (2,7) unseen: backoff to the add-one unigram of 7
+    double viaUnigram = std::log(OpcodeNgram::kBackoff) + std::log(1.0 / 262.0);
+    REQUIRE(m.logLikelihood({ 2, 7 }) - m.logLikelihood({ 2 }) == Approx(viaUnigram));
+
+    // familiar sequences score higher than unfamiliar ones
+    REQUIRE(m.logLikelihood({ 5, 2, 9 }) > m.logLikelihood({ 9, 2, 5 }));
+}
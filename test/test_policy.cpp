@@ -2,6 +2,7 @@
 #include <catch2/catch_approx.hpp>
 using Catch::Approx;
 #include "nn/policy.h"
+#include "nn/optim.h"
 
 TEST_CASE("Policy forward pass and layer addition", "[policy]") {
     Policy p;
@@ -57,3 +58,352 @@ TEST_CASE("forwardSequence is equivalent to manual sequential forwards", "[polic
     REQUIRE(seq.size() == m.size());
     REQUIRE(seq == m);
 }
+
+TEST_CASE("SIMD kernels match the scalar reference on every supported ISA", "[policy][simd]") {
+    // odd sizes exercise the 4-row blocks, vector bodies and scalar tails
+    const int rows = 37, cols = 1029;
+    std::vector<float> W(rows * cols), x(cols), b(rows), v(67);
+    uint32_t s = 12345u;
+    auto rnd = [&s] { s = s * 1664525u + 1013904223u; return (int32_t)s / 2147483648.0f; };
+    for (auto& w : W) w = rnd() * 0.1f;
+    for (auto& e : x) e = rnd();
+    for (auto& e : b) e = rnd();
+    for (size_t k = 0; k < v.size(); ++k) v[k] = -20.0f + 40.0f * (float)k / (float)(v.size() - 1);
+
+    simd::Isa original = simd::activeIsa();
+    simd::setIsa(simd::Isa::SCALAR);
+    std::vector<float> yRef(rows), sigRef = v, tanhRef = v;
+    simd::gemv(W.data(), rows, cols, x.data(), b.data(), yRef.data());
+    simd::sigmoid(sigRef.data(), (int)v.size());
+    simd::tanh(tanhRef.data(), (int)v.size());
+
+    for (simd::Isa isa : { simd::Isa::SSE2, simd::Isa::AVX2 }) {
+        if (simd::setIsa(isa) != isa) continue;   // not supported on this CPU
+        INFO("isa " << simd::isaName(isa));
+        std::vector<float> y(rows), sig = v, th = v;
+        simd::gemv(W.data(), rows, cols, x.data(), b.data(), y.data());
+        simd::sigmoid(sig.data(), (int)v.size());
+        simd::tanh(th.data(), (int)v.size());
+        for (int r = 0; r < rows; ++r)
+            REQUIRE(y[r] == Approx(yRef[r]).margin(1e-4));
+        for (size_t k = 0; k < v.size(); ++k) {
+            REQUIRE(sig[k] == Approx(sigRef[k]).margin(1e-6));
+            REQUIRE(th[k]  == Approx(tanhRef[k]).margin(1e-6));
+        }
+    }
+    simd::setIsa(original);
+}
+
+TEST_CASE("Policy forward is ISA independent and weights are aligned", "[policy][simd]") {
+    Policy p;
+    p.addDense(64, 16);
+    p.addLSTM(16, 24);
+    p.addDense(24, 3);
+    std::vector<float> w0(64 * 16), w2(24 * 3);
+    for (size_t k = 0; k < w0.size(); ++k) w0[k] = 0.01f * (float)((k * 7) % 13) - 0.05f;
+    for (size_t k = 0; k < w2.size(); ++k) w2[k] = 0.02f * (float)((k * 5) % 11) - 0.1f;
+    p.setLayerWeights(0, w0);
+    p.setLayerWeights(2, w2);
+    for (int l = 0; l < p.layerCount(); ++l)
+        REQUIRE(reinterpret_cast<uintptr_t>(p.layerWeights(l).data()) % 64 == 0);
+
+    std::vector<float> in(64);
+    for (size_t k = 0; k < in.size(); ++k) in[k] = (float)(k % 5) * 0.25f;
+
+    simd::Isa original = simd::activeIsa();
+    simd::setIsa(simd::Isa::SCALAR);
+    p.resetState();
+    auto ref = p.forwardSequence({ in, in, in });
+    simd::setIsa(simd::bestIsa());
+    auto got = p.forwardSequence({ in, in, in });
+    simd::setIsa(original);
+
+    REQUIRE(got.size() == ref.size());
+    for (size_t k = 0; k < ref.size(); ++k)
+        REQUIRE(got[k] == Approx(ref[k]).margin(1e-5));
+}
+
+TEST_CASE("Embedding layer matches a dense layer with transposed weights", "[policy][sparse]") {
+    const int in = 10, out = 6;
+    Policy dense, embed;
+    dense.addDense(in, out);
+    embed.addEmbedding(in, out);
+    dense.addDense(out, 2);
+    embed.addDense(out, 2);
+    REQUIRE(embed.layerType(0) == Policy::LayerType::EMBEDDING);
+
+    std::vector<float> wd(in * out), we(in * out), w1(out * 2), b(out);
+    for (int o = 0; o < out; ++o) {
+        b[o] = 0.05f * (float)o - 0.1f;
+        for (int i = 0; i < in; ++i) {
+            float v = 0.03f * (float)((o * 7 + i * 3) % 11) - 0.12f;
+            wd[o * in + i]  = v;   // out×in
+            we[i * out + o] = v;   // in×out
+        }
+    }
+    for (size_t k = 0; k < w1.size(); ++k) w1[k] = 0.1f * (float)k - 0.3f;
+    dense.setLayerWeights(0, wd); dense.setLayerBiases(0, b); dense.setLayerWeights(1, w1);
+    embed.setLayerWeights(0, we); embed.setLayerBiases(0, b); embed.setLayerWeights(1, w1);
+
+    std::vector<float> x(in, 0.0f);
+    x[2] = 1.0f; x[7] = -0.5f;
+    SparseVector sx = SparseVector::fromDense(x);
+    REQUIRE(sx.size() == 2);
+
+    auto ref = dense.forward(x);
+    auto viaDense  = embed.forward(x);     // dense input into an embedding
+    auto viaSparse = embed.forward(sx);    // sparse input into an embedding
+    auto denseSparse = dense.forward(sx);  // sparse input into a dense layer
+    REQUIRE(ref.size() == 2);
+    for (size_t k = 0; k < ref.size(); ++k) {
+        REQUIRE(viaDense[k]    == Approx(ref[k]).margin(1e-6));
+        REQUIRE(viaSparse[k]   == Approx(ref[k]).margin(1e-6));
+        REQUIRE(denseSparse[k] == Approx(ref[k]).margin(1e-6));
+    }
+
+    // sparse activations skip the input but keep every layer output
+    std::vector<std::vector<float>> acts;
+    embed.forwardActivations(sx, acts);
+    REQUIRE(acts.size() == 3);
+    REQUIRE(acts[0].empty());
+    REQUIRE(acts[1].size() == (size_t)out);
+
+    // rows are mutable in place; out-of-range indices are rejected
+    REQUIRE(embed.embeddingRow(0, 2) == embed.layerWeights(0).data() + 2 * out);
+    REQUIRE(embed.embeddingRow(0, in) == nullptr);
+    REQUIRE(embed.embeddingRow(1, 0) == nullptr);
+    sx.push(in + 5, 1.0f);                 // ignored by the forward pass
+    REQUIRE(embed.forward(sx)[0] == Approx(ref[0]).margin(1e-6));
+}
+
+TEST_CASE("Workspace forward matches the allocating API", "[policy][alloc]") {
+    Policy a, b;
+    for (Policy* p : { &a, &b }) {
+        p->addEmbedding(16, 8);
+        p->addLSTM(8, 8);
+        p->addDense(8, 2);
+        for (int l = 0; l < p->layerCount(); ++l) {
+            ParamView w = p->layerWeightsMut(l);
+            for (size_t i = 0; i < w.size; ++i) w[i] = 0.01f * (float)((i * 7) % 13) - 0.05f;
+        }
+    }
+    REQUIRE(a.layerWeightsMut(5).empty());
+
+    Policy::Workspace ws;
+    a.prepare(ws);
+    SparseVector x;
+    for (int step = 0; step < 4; ++step) {
+        x.setOneHot(step * 3);
+        auto ref = b.forward(x);
+        const auto& got = a.forward(x, ws);
+        REQUIRE(got.size() == ref.size());
+        for (size_t i = 0; i < ref.size(); ++i)
+            REQUIRE(got[i] == Approx(ref[i]));
+        REQUIRE(ws.acts.size() == 4);
+        REQUIRE(ws.acts[1].size() == 8);
+    }
+}
+
+TEST_CASE("backward matches numerical gradients through time", "[policy][backprop]") {
+    // every layer type, with the LSTM fed by a dense layer so the gradient
+    // has to cross it both downward and back through time
+    Policy p;
+    p.addEmbedding(12, 6);
+    p.addDense(6, 5);
+    p.addLSTM(5, 4);
+    p.addLinear(4, 2);
+    p.initWeights(7);
+    for (int l = 0; l < p.layerCount(); ++l) {
+        ParamView b = p.layerBiasesMut(l);
+        for (size_t i = 0; i < b.size; ++i) b[i] = 0.05f * (float)(i % 3);
+    }
+
+    const int ops[] = { 3, 7, 1, 7, 10 };
+    const float target[2] = { 0.3f, -0.2f };
+    // loss = sum over steps and outputs of (y - target)^2
+    auto lossOf = [&](Policy& q) {
+        q.resetState();
+        SparseVector x;
+        double loss = 0.0;
+        for (int op : ops) {
+            x.setOneHot(op);
+            auto y = q.forward(x);
+            for (int k = 0; k < 2; ++k) loss += (y[k] - target[k]) * (y[k] - target[k]);
+        }
+        return loss;
+    };
+
+    Policy::Tape tape;
+    Policy::Gradients g;
+    p.prepare(tape);
+    p.prepare(g);
+    p.resetState();
+    SparseVector x;
+    for (int op : ops) {
+        x.setOneHot(op);
+        auto y = p.forward(x, tape);
+        tape.last().dOut = { 2.0f * (y[0] - target[0]), 2.0f * (y[1] - target[1]) };
+    }
+    p.backward(tape, g);
+
+    const float h = 1e-3f;
+    int checked = 0;
+    for (int l = 0; l < p.layerCount(); ++l) {
+        for (int which = 0; which < 2; ++which) {
+            ParamView v = which ? p.layerBiasesMut(l) : p.layerWeightsMut(l);
+            const auto& analytic = which ? g.b[l] : g.w[l];
+            REQUIRE(analytic.size() == v.size);
+            for (size_t i = 0; i < v.size; i += 1 + v.size / 17) {
+                float saved = v[i];
+                v[i] = saved + h;
+                double up = lossOf(p);
+                v[i] = saved - h;
+                double down = lossOf(p);
+                v[i] = saved;
+                float numeric = (float)((up - down) / (2.0 * h));
+                REQUIRE(analytic[i] == Approx(numeric).margin(2e-3).epsilon(0.02));
+                ++checked;
+            }
+        }
+    }
+    REQUIRE(checked > 50);
+}
+
+TEST_CASE("embedding gradients and updates touch only the active rows", "[policy][backprop][sparse]") {
+    Policy p;
+    p.addEmbedding(12, 6);
+    p.addLinear(6, 1);
+    p.initWeights(3);
+    const std::vector<float> before(p.layerWeights(0).begin(), p.layerWeights(0).end());
+
+    Policy::Tape tape;
+    Policy::Gradients g, sum;
+    p.prepare(tape);
+    p.prepare(g);
+    p.prepare(sum);
+    p.resetState();
+    SparseVector x;
+    for (int op : { 2, 9, 2 }) {
+        x.setOneHot(op);
+        p.forward(x, tape);
+        tape.last().dOut = { 1.0f };
+    }
+    p.backward(tape, g);
+    REQUIRE(g.sparse(0));
+    REQUIRE_FALSE(g.sparse(1));
+    REQUIRE(g.rows[0] == std::vector<int>{ 2, 9 });   // each row listed once
+
+    sum.add(g);
+    REQUIRE(sum.rows[0] == g.rows[0]);
+
+    Optimizer opt;
+    opt.step(p, sum);
+    const auto& after = p.layerWeights(0);
+    for (int r = 0; r < 12; ++r) {
+        bool moved = false;
+        for (int j = 0; j < 6; ++j) moved |= after[r * 6 + j] != before[r * 6 + j];
+        REQUIRE(moved == (r == 2 || r == 9));
+    }
+
+    // zero() clears the touched rows and the list
+    sum.zero();
+    REQUIRE(sum.rows[0].empty());
+    for (float v : sum.w[0]) REQUIRE(v == 0.0f);
+}
+
+TEST_CASE("gemm matches one gemv per input", "[policy][simd]") {
+    const int rows = 11, cols = 37, n = 5;   // odd sizes exercise every tail
+    std::vector<float> W(rows * cols), X(n * cols), b(rows);
+    for (size_t k = 0; k < W.size(); ++k) W[k] = 0.01f * (float)((k * 7) % 23) - 0.1f;
+    for (size_t k = 0; k < X.size(); ++k) X[k] = 0.05f * (float)((k * 3) % 11) - 0.2f;
+    for (int r = 0; r < rows; ++r) b[r] = 0.1f * (float)r;
+
+    simd::Isa original = simd::activeIsa();
+    for (simd::Isa isa : { simd::Isa::SCALAR, simd::Isa::SSE2, simd::Isa::AVX2 }) {
+        if (simd::setIsa(isa) != isa) continue;
+        INFO("isa " << simd::isaName(isa));
+        std::vector<float> Y(n * rows), y(rows);
+        simd::gemm(W.data(), rows, cols, X.data(), n, b.data(), Y.data());
+        for (int k = 0; k < n; ++k) {
+            simd::gemv(W.data(), rows, cols, X.data() + k * cols, b.data(), y.data());
+            for (int r = 0; r < rows; ++r) REQUIRE(Y[k * rows + r] == Approx(y[r]).margin(1e-6));
+        }
+    }
+    simd::setIsa(original);
+}
+
+TEST_CASE("forwardBatch matches per-sequence forward passes", "[policy][batch]") {
+    // the Trainer layout: embedding, dense, LSTM, dense, linear
+    Policy p;
+    p.addEmbedding(256, 16);
+    p.addDense(16, 24);
+    p.addLSTM(24, 20);
+    p.addDense(20, 8);
+    p.addLinear(8, 1);
+    p.initWeights(7);
+
+    // different lengths, including an empty sequence and a duplicate length
+    std::vector<std::vector<uint8_t>> seqs = {
+        { 0x20, 0x41, 0x6a, 0x0b },
+        { 0x41 },
+        {},
+        { 0x10, 0x20, 0x21, 0x22, 0x23, 0x41, 0x6b, 0x0f, 0x0b },
+        { 0x6a, 0x6b, 0x6c, 0x6d },
+    };
+
+    Policy::BatchState st;
+    p.prepare(st, (int)seqs.size());
+    std::vector<std::vector<float>> outputs;
+    p.forwardBatch(seqs, st, outputs);
+    REQUIRE(outputs.size() == seqs.size());
+
+    Policy ref = p;
+    SparseVector x;
+    for (size_t s = 0; s < seqs.size(); ++s) {
+        INFO("sequence " << s);
+        if (seqs[s].empty()) {
+            REQUIRE(outputs[s].empty());
+            continue;
+        }
+        ref.resetState();
+        std::vector<float> y;
+        for (uint8_t op : seqs[s]) {
+            x.setOneHot(op);
+            y = ref.forward(x);
+        }
+        REQUIRE(outputs[s].size() == y.size());
+        for (size_t k = 0; k < y.size(); ++k) REQUIRE(outputs[s][k] == Approx(y[k]).margin(1e-6));
+    }
+
+    // the shared model's own LSTM state is untouched
+    Policy fresh = p;
+    fresh.resetState();
+    x.setOneHot(0x41);
+    REQUIRE(p.forward(x) == fresh.forward(x));
+
+    // a second call resets the batch state first
+    std::vector<std::vector<float>> again;
+    p.forwardBatch(seqs, st, again);
+    REQUIRE(again == outputs);
+}
+
+TEST_CASE("forwardBatch leaves masked slots untouched", "[policy][batch]") {
+    Policy p;
+    p.addEmbedding(8, 4);
+    p.addLSTM(4, 4);
+    p.addLinear(4, 2);
+    p.initWeights(3);
+
+    Policy::BatchState st;
+    p.prepare(st, 3);
+    std::vector<SparseVector> in(3);
+    for (int b = 0; b < 3; ++b) in[b].setOneHot(b + 1);
+    std::vector<float> first = p.forwardBatch(in.data(), 3, st);
+    std::vector<float> h2 = st.h[1];
+
+    // only slots 0 and 1 are live: slot 2's state and output row stay put
+    const std::vector<float>& second = p.forwardBatch(in.data(), 2, st);
+    for (int k = 0; k < 2; ++k) REQUIRE(second[2 * 2 + k] == first[2 * 2 + k]);
+    for (int k = 0; k < 4; ++k) REQUIRE(st.h[1][2 * 4 + k] == h2[2 * 4 + k]);
+    REQUIRE(second[0] != first[0]);   // live slots advanced
+}
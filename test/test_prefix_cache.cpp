@@ -0,0 +1,103 @@
+#include <catch2/catch_test_macros.hpp>
+#include "nn/prefix_cache.h"
+#include "nn/train.h"
+#include "constants.h"  // KERNEL_GLOB
+
+#include <memory>
+#include <vector>
+
+namespace {
+
+std::shared_ptr<const QuantizedPolicy> trainedModel() {
+    Trainer t;
+    TelemetryEntry e;
+    e.kernelBase64 = KERNEL_GLOB;
+    for (int i = 0; i < 3; ++i) t.observe(e);
+    return std::make_shared<const QuantizedPolicy>(t.policy());
+}
+
+// the bundled kernels are only a handful of opcodes; evolved ones grow
+std::vector<uint8_t> kernelSequence() {
+    std::vector<uint8_t> seq(100);
+    for (size_t k = 0; k < seq.size(); ++k) seq[k] = (uint8_t)(0x20 + (k * 7) % 0x50);
+    return seq;
+}
+
+} // namespace
+
+TEST_CASE("PrefixStateCache scores exactly like a full pass", "[prefix_cache]") {
+    auto model = trainedModel();
+    auto parent = kernelSequence();
+
+    QuantizedPolicy::State st, refSt;
+    SparseVector scratch;
+    PrefixStateCache cache(8);
+
+    REQUIRE(cache.score(model, parent, st, scratch) == model->score(parent, refSt, scratch));
+    REQUIRE(cache.stepsComputed() == parent.size());
+    REQUIRE(cache.stepsReused() == 0);
+
+    // a child mutated at `at` reuses every checkpoint before it
+    const size_t at = 29;
+    auto child = parent;
+    child[at] = (uint8_t)(child[at] ^ 0x01);
+    uint64_t computed = cache.stepsComputed();
+    REQUIRE(cache.score(model, child, st, scratch) == model->score(child, refSt, scratch));
+    REQUIRE(cache.stepsComputed() - computed == child.size() - 24);   // resumed at 3 * 8
+    REQUIRE(cache.stepsReused() == 24);
+
+    // inserted and deleted opcodes share the prefix too
+    auto inserted = parent;
+    inserted.insert(inserted.begin() + at, 0x01);
+    REQUIRE(cache.score(model, inserted, st, scratch) == model->score(inserted, refSt, scratch));
+    auto shorter = parent;
+    shorter.erase(shorter.begin() + at);
+    REQUIRE(cache.score(model, shorter, st, scratch) == model->score(shorter, refSt, scratch));
+
+    // an exact repeat runs no steps
+    computed = cache.stepsComputed();
+    REQUIRE(cache.score(model, child, st, scratch) == model->score(child, refSt, scratch));
+    REQUIRE(cache.stepsComputed() == computed);
+
+    // a prefix of a cached sequence ending on a checkpoint, and an empty one
+    std::vector<uint8_t> prefix(parent.begin(), parent.begin() + 16);
+    REQUIRE(cache.score(model, prefix, st, scratch) == model->score(prefix, refSt, scratch));
+    REQUIRE(cache.score(model, {}, st, scratch) == 0.0f);
+}
+
+TEST_CASE("PrefixStateCache drops states from another model", "[prefix_cache]") {
+    auto seq = kernelSequence();
+    auto a = trainedModel();
+    auto b = std::make_shared<const QuantizedPolicy>(Trainer().policy());
+
+    QuantizedPolicy::State st, refSt;
+    SparseVector scratch;
+    PrefixStateCache cache(8);
+    cache.score(a, seq, st, scratch);
+    REQUIRE(cache.size() == 1);
+
+    uint64_t computed = cache.stepsComputed();
+    REQUIRE(cache.score(b, seq, st, scratch) == b->score(seq, refSt, scratch));
+    REQUIRE(cache.stepsComputed() - computed == seq.size());
+    REQUIRE(cache.size() == 1);
+}
+
+TEST_CASE("PrefixStateCache evicts the least recently used sequence", "[prefix_cache]") {
+    auto model = trainedModel();
+    QuantizedPolicy::State st;
+    SparseVector scratch;
+    PrefixStateCache cache(4, 2);
+
+    std::vector<uint8_t> s1(12, 0x20), s2(12, 0x41), s3(12, 0x6a);
+    cache.score(model, s1, st, scratch);
+    cache.score(model, s2, st, scratch);
+    cache.score(model, s1, st, scratch);   // s1 is now the most recent
+    cache.score(model, s3, st, scratch);   // evicts s2
+    REQUIRE(cache.size() == 2);
+
+    uint64_t computed = cache.stepsComputed();
+    cache.score(model, s1, st, scratch);
+    REQUIRE(cache.stepsComputed() == computed);
+    cache.score(model, s2, st, scratch);
+    REQUIRE(cache.stepsComputed() == computed + s2.size());
+}
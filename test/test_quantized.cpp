@@ -0,0 +1,128 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+using Catch::Approx;
+#include "nn/quantized.h"
+#include "nn/background_trainer.h"
+#include "nn/feature.h"
+#include "nn/simd.h"
+#include "nn/train.h"
+#include "constants.h"  // KERNEL_GLOB, KERNEL_SEQ
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+// fp32 reference: reset, feed `seq` one-hot, return the first output
+float scoreFp32(const Policy& model, const std::vector<uint8_t>& seq) {
+    Policy p = model;
+    p.resetState();
+    SparseVector in;
+    float out = 0.0f;
+    for (uint8_t op : seq) {
+        in.setOneHot(op);
+        auto y = p.forward(in);
+        out = y.empty() ? 0.0f : y[0];
+    }
+    return out;
+}
+
+std::vector<uint8_t> sequenceOf(const std::string& kernel) {
+    TelemetryEntry e;
+    e.kernelBase64 = kernel;
+    return Feature::extractSequence(e);
+}
+
+} // namespace
+
+TEST_CASE("gemvI8 kernels agree across ISAs", "[quantized][simd]") {
+    const int rows = 13, cols = 96;   // odd row count exercises the AVX2 tail
+    std::vector<int8_t> W((size_t)rows * cols), x(cols);
+    std::vector<float> scale(rows), b(rows);
+    for (size_t k = 0; k < W.size(); ++k) W[k] = (int8_t)((int)((k * 37) % 255) - 127);
+    for (int c = 0; c < cols; ++c) x[c] = (int8_t)((c * 11) % 255 - 127);
+    for (int r = 0; r < rows; ++r) {
+        scale[r] = 0.001f * (float)(r + 1);
+        b[r]     = 0.1f * (float)r - 0.5f;
+    }
+
+    simd::Isa original = simd::activeIsa();
+    simd::setIsa(simd::Isa::SCALAR);
+    std::vector<float> ref(rows);
+    simd::gemvI8(W.data(), rows, cols, x.data(), scale.data(), 0.02f, b.data(), ref.data());
+
+    // the scalar result is exact integer arithmetic before the rescale
+    for (int r = 0; r < rows; ++r) {
+        int32_t acc = 0;
+        for (int c = 0; c < cols; ++c) acc += (int32_t)W[(size_t)r * cols + c] * x[c];
+        REQUIRE(ref[r] == Approx(b[r] + (float)acc * scale[r] * 0.02f).margin(1e-4));
+    }
+
+    for (simd::Isa isa : { simd::Isa::SSE2, simd::Isa::AVX2 }) {
+        if (simd::setIsa(isa) != isa) continue;   // not supported on this CPU
+        INFO("isa " << simd::isaName(isa));
+        std::vector<float> y(rows);
+        simd::gemvI8(W.data(), rows, cols, x.data(), scale.data(), 0.02f, b.data(), y.data());
+        for (int r = 0; r < rows; ++r)
+            REQUIRE(y[r] == Approx(ref[r]).margin(1e-5));
+    }
+    simd::setIsa(original);
+}
+
+TEST_CASE("QuantizedPolicy tracks the fp32 policy", "[quantized]") {
+    // train a little so the weights are not just the initialisation
+    Trainer t;
+    TelemetryEntry e;
+    e.kernelBase64 = KERNEL_GLOB;
+    for (int i = 0; i < 4; ++i) t.observe(e);
+    e.kernelBase64 = KERNEL_SEQ;
+    for (int i = 0; i < 4; ++i) t.observe(e);
+
+    QuantizedPolicy q(t.policy());
+    REQUIRE(q.layerCount() == t.policy().layerCount());
+
+    QuantizedPolicy::State st;
+    SparseVector scratch;
+    float maxDelta = 0.0f;
+    for (const std::string* kernel : { &KERNEL_GLOB, &KERNEL_SEQ }) {
+        auto seq = sequenceOf(*kernel);
+        REQUIRE_FALSE(seq.empty());
+        float ref = scoreFp32(t.policy(), seq);
+        float got = q.score(seq, st, scratch);
+        maxDelta = std::max(maxDelta, std::fabs(got - ref));
+        // prefixes too, so the recurrence is checked at every length
+        for (size_t n = 1; n < seq.size(); n += 7) {
+            std::vector<uint8_t> prefix(seq.begin(), seq.begin() + n);
+            maxDelta = std::max(maxDelta, std::fabs(q.score(prefix, st, scratch) -
+                                                    scoreFp32(t.policy(), prefix)));
+        }
+    }
+    INFO("max |int8 - fp32| = " << maxDelta);
+    REQUIRE(maxDelta < 0.02f);
+
+    // repeated scoring is deterministic (score() resets the state)
+    auto seq = sequenceOf(KERNEL_GLOB);
+    REQUIRE(q.score(seq, st, scratch) == q.score(seq, st, scratch));
+}
+
+TEST_CASE("QuantizedPolicy stores weights in about a quarter of the space", "[quantized]") {
+    Trainer t;
+    const Policy& p = t.policy();
+    size_t fp32 = 0;
+    for (int l = 0; l < p.layerCount(); ++l)
+        fp32 += (p.layerWeights(l).size() + p.layerBiases(l).size()) * sizeof(float);
+    QuantizedPolicy q(p);
+    REQUIRE(q.bytes() < fp32 / 3);
+}
+
+TEST_CASE("Published trainer snapshots carry the quantized model", "[quantized][async]") {
+    Trainer t;
+    BackgroundTrainer bg(t);
+    bg.start();
+    auto snap = bg.snapshot();
+    REQUIRE(snap->quantized);
+    REQUIRE(snap->quantized->layerCount() == snap->policy->layerCount());
+    bg.stop();
+}
@@ -0,0 +1,113 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+using Catch::Approx;
+#include "nn/replay.h"
+#include "nn/feature.h"
+#include "nn/train.h"
+#include "constants.h"  // KERNEL_GLOB
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace {
+
+ReplayMemory::Item item(int generation) {
+    ReplayMemory::Item it;
+    it.generation = generation;
+    return it;
+}
+
+} // namespace
+
+TEST_CASE("ReplayMemory overwrites the oldest item when full", "[replay]") {
+    ReplayMemory mem(4);
+    REQUIRE(mem.empty());
+    for (int g = 0; g < 10; ++g) mem.push(item(g), 1.0f);
+    REQUIRE(mem.size() == 4);
+
+    std::vector<int> gens;
+    for (size_t s = 0; s < mem.size(); ++s) gens.push_back(mem.at(s).generation);
+    std::sort(gens.begin(), gens.end());
+    REQUIRE(gens == std::vector<int>{ 6, 7, 8, 9 });
+
+    // shrinking keeps the newest, growing keeps everything
+    mem.setCapacity(2);
+    REQUIRE(mem.size() == 2);
+    REQUIRE(mem.at(0).generation == 8);
+    REQUIRE(mem.at(1).generation == 9);
+    mem.setCapacity(8);
+    REQUIRE(mem.size() == 2);
+    REQUIRE(mem.push(item(10), 1.0f) == 2);
+
+    ReplayMemory none(0);
+    REQUIRE(none.push(item(1), 1.0f) == ReplayMemory::npos);
+    REQUIRE(none.empty());
+}
+
+TEST_CASE("ReplayMemory samples in proportion to priority", "[replay]") {
+    ReplayMemory mem(5);
+    const float losses[] = { 0.0f, 0.1f, 0.4f, 1.0f, 2.0f };
+    for (int k = 0; k < 5; ++k) mem.push(item(k), losses[k]);
+
+    double sum = 0.0;
+    for (size_t s = 0; s < mem.size(); ++s) {
+        REQUIRE(mem.priority(s) ==
+                Approx(std::pow(losses[s] + ReplayMemory::kEpsilon, ReplayMemory::kAlpha)));
+        sum += mem.priority(s);
+    }
+    REQUIRE(mem.total() == Approx(sum));
+
+    std::mt19937 rng(3);
+    const int draws = 200000;
+    std::vector<int> hits(mem.size(), 0);
+    for (int i = 0; i < draws; ++i) ++hits[mem.sample(rng)];
+    for (size_t s = 0; s < mem.size(); ++s)
+        REQUIRE((double)hits[s] / draws == Approx(mem.probability(s)).margin(0.005));
+    // zero loss is still drawable, and rarer items get the larger weight
+    REQUIRE(hits[0] > 0);
+    REQUIRE(mem.weight(0) > mem.weight(4));
+
+    // re-prioritising moves the mass and keeps the root consistent
+    mem.update(0, 5.0f);
+    sum = 0.0;
+    for (size_t s = 0; s < mem.size(); ++s) sum += mem.priority(s);
+    REQUIRE(mem.total() == Approx(sum));
+    REQUIRE(mem.probability(0) > mem.probability(4));
+}
+
+TEST_CASE("ReplayMemory stays consistent at large capacity", "[replay]") {
+    const size_t cap = 100000;
+    ReplayMemory mem(cap);
+    std::mt19937 rng(11);
+    for (size_t k = 0; k < cap + cap / 2; ++k)
+        mem.push(item((int)k), (float)(k % 7) * 0.1f);
+    REQUIRE(mem.size() == cap);
+    for (int i = 0; i < 1000; ++i) {
+        size_t s = mem.sample(rng);
+        REQUIRE(s < mem.size());
+        REQUIRE(mem.at(s).generation >= (int)(cap / 2));   // only live items
+        mem.update(s, 0.5f);
+    }
+}
+
+TEST_CASE("Trainer keeps replay entries as shared features", "[replay][train]") {
+    Trainer t;
+    t.seed(5);
+    TelemetryEntry e;
+    e.generation   = 3;
+    e.kernelBase64 = KERNEL_GLOB;
+    for (int i = 0; i < 6; ++i) t.observe(e);
+
+    const ReplayMemory& mem = t.test_replay();
+    REQUIRE(mem.size() == 6);
+    auto features = Feature::kernel(e);
+    for (size_t s = 0; s < mem.size(); ++s) {
+        REQUIRE(mem.at(s).features == features);   // one decode, shared
+        REQUIRE(mem.at(s).generation == 3);
+        REQUIRE(mem.priority(s) > 0.0);
+    }
+    t.reset();
+    REQUIRE(t.test_replaySize() == 0);
+}
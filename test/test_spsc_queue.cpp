@@ -0,0 +1,73 @@
+#include <catch2/catch_test_macros.hpp>
+#include "spsc_queue.h"
+
+#include <memory>
+#include <string>
+#include <thread>
+
+TEST_CASE("SpscQueue is FIFO and reports full and empty", "[spsc]") {
+    SpscQueue<int> q(3);
+    REQUIRE(q.capacity() == 4);   // rounded up to a power of two
+    int v = -1;
+    REQUIRE_FALSE(q.tryPop(v));
+
+    for (int i = 0; i < 4; ++i) REQUIRE(q.tryPush(int(i)));
+    REQUIRE(q.size() == 4);
+    REQUIRE_FALSE(q.tryPush(99));
+
+    for (int i = 0; i < 4; ++i) {
+        REQUIRE(q.tryPop(v));
+        REQUIRE(v == i);
+    }
+    REQUIRE_FALSE(q.tryPop(v));
+    REQUIRE(q.size() == 0);
+
+    // indices keep running past the ring size
+    for (int round = 0; round < 10; ++round) {
+        REQUIRE(q.tryPush(int(round)));
+        REQUIRE(q.tryPop(v));
+        REQUIRE(v == round);
+    }
+}
+
+TEST_CASE("SpscQueue moves elements and leaves them on a failed push", "[spsc]") {
+    SpscQueue<std::unique_ptr<std::string>> q(2);
+    REQUIRE(q.tryPush(std::make_unique<std::string>("a")));
+    REQUIRE(q.tryPush(std::make_unique<std::string>("b")));
+    auto c = std::make_unique<std::string>("c");
+    REQUIRE_FALSE(q.tryPush(std::move(c)));
+    REQUIRE(c);   // not consumed
+
+    std::unique_ptr<std::string> out;
+    REQUIRE(q.tryPop(out));
+    REQUIRE(*out == "a");
+    REQUIRE(q.tryPush(std::move(c)));
+    REQUIRE(q.tryPop(out));
+    REQUIRE(*out == "b");
+    REQUIRE(q.tryPop(out));
+    REQUIRE(*out == "c");
+}
+
+TEST_CASE("SpscQueue delivers every element across two threads in order", "[spsc][thread]") {
+    constexpr int kCount = 200000;
+    SpscQueue<int> q(64);
+
+    std::thread producer([&] {
+        for (int i = 0; i < kCount; ++i)
+            while (!q.tryPush(int(i))) std::this_thread::yield();
+    });
+
+    int expected = 0;
+    bool ordered = true;
+    while (expected < kCount) {
+        int v;
+        if (!q.tryPop(v)) { std::this_thread::yield(); continue; }
+        if (v != expected) ordered = false;
+        ++expected;
+    }
+    producer.join();
+
+    REQUIRE(ordered);
+    int v;
+    REQUIRE_FALSE(q.tryPop(v));
+}
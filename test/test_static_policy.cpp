@@ -0,0 +1,108 @@
+#include <catch2/catch_test_macros.hpp>
+#include "nn/static_policy.h"
+#include "nn/feature.h"
+#include "nn/train.h"
+#include "constants.h"  // KERNEL_GLOB, KERNEL_SEQ
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::vector<uint8_t> sequenceOf(const std::string& kernel) {
+    TelemetryEntry e;
+    e.kernelBase64 = kernel;
+    return Feature::extractSequence(e);
+}
+
+// a synthetic kernel long enough to cross several BPTT windows
+std::vector<uint8_t> syntheticSequence() {
+    std::vector<uint8_t> seq(100);
+    for (size_t k = 0; k < seq.size(); ++k) seq[k] = (uint8_t)((k * 37 + 11) % 256);
+    return seq;
+}
+
+float scoreDynamic(Policy p, const std::vector<uint8_t>& seq) {
+    p.resetState();
+    SparseVector x;
+    float out = 0.0f;
+    for (uint8_t op : seq) {
+        x.setOneHot(op);
+        out = p.forward(x)[0];
+    }
+    return out;
+}
+
+} // namespace
+
+TEST_CASE("StaticPolicy matches the Trainer architecture", "[static_policy]") {
+    Trainer t;
+    REQUIRE(Trainer::StaticNet::matches(t.policy()));
+    REQUIRE(Trainer::StaticNet::kInputs == kFeatSize);
+    REQUIRE(Trainer::StaticNet::kOutputs == 1);
+
+    // a different width is rejected and leaves the parameters alone
+    Policy other;
+    other.addEmbedding(kFeatSize, 16);
+    other.addLinear(16, 1);
+    auto net = std::make_unique<Trainer::StaticNet>();
+    REQUIRE_FALSE(Trainer::StaticNet::matches(other));
+    REQUIRE_FALSE(net->load(other));
+    REQUIRE(net->layer<0>().w[0] == 0.0f);
+}
+
+TEST_CASE("StaticPolicy output is bit-identical to Policy", "[static_policy]") {
+    Trainer t;
+    TelemetryEntry e;
+    e.generation   = 2;
+    e.kernelBase64 = KERNEL_GLOB;
+    for (int i = 0; i < 4; ++i) t.observe(e);
+
+    auto net = std::make_unique<Trainer::StaticNet>();
+    REQUIRE(net->load(t.policy()));
+    for (const auto& seq : { sequenceOf(KERNEL_GLOB), sequenceOf(KERNEL_SEQ), syntheticSequence() }) {
+        REQUIRE_FALSE(seq.empty());
+        REQUIRE(net->score(seq) == scoreDynamic(t.policy(), seq));
+    }
+
+    // step by step, with the LSTM state carried across calls
+    Policy p = t.policy();
+    p.resetState();
+    net->resetState();
+    SparseVector x;
+    for (uint8_t op : syntheticSequence()) {
+        x.setOneHot(op);
+        REQUIRE(net->forward(x)[0] == p.forward(x)[0]);
+    }
+}
+
+TEST_CASE("StaticPolicy round-trips through Policy and checkpoints", "[static_policy]") {
+    Trainer t;
+    TelemetryEntry e;
+    e.generation   = 3;
+    e.kernelBase64 = KERNEL_SEQ;
+    for (int i = 0; i < 3; ++i) t.observe(e);
+
+    auto net = std::make_unique<Trainer::StaticNet>();
+    REQUIRE(net->load(t.policy()));
+    Policy back = net->toPolicy();
+    REQUIRE(back.layerCount() == t.policy().layerCount());
+    for (int l = 0; l < back.layerCount(); ++l) {
+        REQUIRE(back.layerType(l) == t.policy().layerType(l));
+        REQUIRE(back.layerWeights(l) == t.policy().layerWeights(l));
+        REQUIRE(back.layerBiases(l) == t.policy().layerBiases(l));
+    }
+
+    // a checkpoint written by the Trainer loads into the static network
+    const std::string path = "static_policy.tmp";
+    REQUIRE(t.save(path));
+    Trainer restored;
+    REQUIRE(restored.load(path));
+    std::remove(path.c_str());
+    auto fromCkpt = std::make_unique<Trainer::StaticNet>();
+    REQUIRE(fromCkpt->load(restored.policy()));
+    auto seq = syntheticSequence();
+    REQUIRE(fromCkpt->score(seq) == net->score(seq));
+}
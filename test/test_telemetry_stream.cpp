@@ -0,0 +1,98 @@
+#include <catch2/catch_test_macros.hpp>
+#include "telemetry_stream.h"
+#include "app.h"
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <unistd.h>
+
+// unique per process so parallel ctest runs do not share a ring
+static std::string streamName(const char* tag) {
+    return std::string("wqb_test_") + tag + "_" + std::to_string(getpid());
+}
+
+TEST_CASE("shm ring delivers events in order and drops when full", "[stream]") {
+    std::string name = streamName("ring");
+    TelemetryPublisher pub;
+    REQUIRE(pub.openShm(name, 4));
+    REQUIRE(pub.transport() == StreamTransport::SHM);
+
+    TelemetrySubscriber sub;
+    REQUIRE(sub.openShm(name));
+
+    for (int g = 1; g <= 3; ++g) {
+        GenerationEvent ev;
+        ev.kind       = (uint32_t)StreamEventKind::GENERATION;
+        ev.generation = g;
+        ev.kernelSize = 100u + g;
+        setTrapCode(ev, "a trap code that is far too long to fit");
+        REQUIRE(pub.publish(ev));
+    }
+
+    GenerationEvent got;
+    for (int g = 1; g <= 3; ++g) {
+        REQUIRE(sub.poll(got));
+        REQUIRE(got.seq == (uint64_t)g);
+        REQUIRE(got.generation == g);
+        REQUIRE(got.kernelSize == 100u + g);
+        REQUIRE(got.timestampUs > 0);
+        REQUIRE(std::strlen(got.trapCode) == sizeof(got.trapCode) - 1);
+    }
+    REQUIRE_FALSE(sub.poll(got));
+
+    // capacity 4: the fifth unread event is dropped, never blocks
+    for (int i = 0; i < 4; ++i) REQUIRE(pub.publish(GenerationEvent{}));
+    REQUIRE_FALSE(pub.publish(GenerationEvent{}));
+    REQUIRE(pub.dropped() == 1);
+    REQUIRE(sub.dropped() == 1);
+}
+
+TEST_CASE("unix socket fallback carries the same events", "[stream]") {
+    std::string path = streamName("sock") + ".sock";
+    TelemetrySubscriber sub;
+    REQUIRE(sub.open("unix:" + path));
+    REQUIRE(sub.transport() == StreamTransport::SOCKET);
+
+    TelemetryPublisher pub;
+    REQUIRE(pub.open("unix:" + path));
+    REQUIRE(pub.transport() == StreamTransport::SOCKET);
+
+    GenerationEvent ev;
+    ev.kind       = (uint32_t)StreamEventKind::STATE;
+    ev.fromState  = (uint8_t)SystemState::IDLE;
+    ev.toState    = (uint8_t)SystemState::BOOTING;
+    REQUIRE(pub.publish(ev));
+
+    GenerationEvent got;
+    REQUIRE(sub.poll(got));
+    REQUIRE(got.seq == 1);
+    REQUIRE(got.toState == (uint8_t)SystemState::BOOTING);
+
+    sub.close();
+    REQUIRE_FALSE(std::filesystem::exists(path));
+    // nobody listening any more: the event is dropped, not queued
+    REQUIRE_FALSE(pub.publish(ev));
+}
+
+TEST_CASE("App publishes a generation event on reboot", "[stream][app]") {
+    CliOptions opts;
+    opts.telemetryLevel  = TelemetryLevel::NONE;
+    opts.telemetryDir    = "stream_test";
+    opts.telemetryStream = streamName("app");
+    App a(opts);
+
+    TelemetrySubscriber sub;
+    REQUIRE(sub.openShm(opts.telemetryStream));
+    a.doReboot(true);
+
+    GenerationEvent ev;
+    bool sawGen = false;
+    while (sub.poll(ev)) {
+        if (ev.kind == (uint32_t)StreamEventKind::GENERATION) {
+            sawGen = true;
+            REQUIRE(ev.generation == a.generation());
+            REQUIRE(ev.kernelSize == (uint32_t)a.kernelBytes());
+        }
+    }
+    REQUIRE(sawGen);
+}
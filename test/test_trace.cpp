@@ -0,0 +1,87 @@
+#include <catch2/catch_test_macros.hpp>
+#include "trace.h"
+#include "app.h"
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+
+static std::string slurp(const std::string& path) {
+    std::ifstream f(path);
+    return std::string((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+}
+
+static size_t countOf(const std::string& s, const std::string& needle) {
+    size_t n = 0;
+    for (size_t p = s.find(needle); p != std::string::npos; p = s.find(needle, p + 1)) ++n;
+    return n;
+}
+
+TEST_CASE("Disabled trace scopes record nothing", "[trace]") {
+    trace::stop();
+    REQUIRE_FALSE(trace::enabled());
+    { TRACE_SCOPE("ignored"); }
+    // nothing to check beyond "does not crash"; start() afterwards must
+    // produce a document without the ignored span
+    std::string path = "trace_disabled.json";
+    REQUIRE(trace::start(path));
+    trace::stop();
+    std::string doc = slurp(path);
+    REQUIRE(doc.find("ignored") == std::string::npos);
+    REQUIRE(doc.rfind("]}") != std::string::npos);
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Trace scopes produce complete events per thread", "[trace]") {
+    std::string path = "trace_spans.json";
+    REQUIRE(trace::start(path));
+    {
+        TRACE_SCOPE("outer", "test");
+        TraceScope phase("phase.a", "test");
+        phase.next("phase.b");
+    }
+    std::thread worker([] {
+        trace::setThreadName("worker");
+        TRACE_SCOPE("background", "test");
+    });
+    worker.join();
+    trace::stop();
+
+    std::string doc = slurp(path);
+    REQUIRE(doc.rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 0) == 0);
+    REQUIRE(doc.find("\n]}\n") != std::string::npos);
+    REQUIRE(countOf(doc, "\"ph\":\"X\"") == 4);
+    REQUIRE(doc.find("\"name\":\"phase.a\"") != std::string::npos);
+    REQUIRE(doc.find("\"name\":\"phase.b\"") != std::string::npos);
+    REQUIRE(doc.find("\"args\":{\"name\":\"worker\"}") != std::string::npos);
+
+    // the worker's span lives on a different track than "outer"
+    auto tidOf = [&](const std::string& name) {
+        size_t p = doc.find("\"name\":\"" + name + "\"");
+        size_t t = doc.find("\"tid\":", p) + 6;
+        return doc.substr(t, doc.find(',', t) - t);
+    };
+    REQUIRE(tidOf("outer") != tidOf("background"));
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("BootFsm states appear as slices on the FSM track", "[trace][app]") {
+    std::string path = "trace_fsm.json";
+    REQUIRE(trace::start(path));
+    {
+        CliOptions opts;
+        opts.telemetryLevel = TelemetryLevel::NONE;
+        opts.telemetryDir   = "trace_test";
+        App a(opts);
+        a.test_simulateFailure("boom", {});   // IDLE -> REPAIRING
+        a.doReboot(false);                    // REPAIRING -> IDLE
+    }
+    trace::stop();
+    std::string doc = slurp(path);
+    std::string track = "\"tid\":" + std::to_string(trace::kFsmTrack);
+    REQUIRE(doc.find("{\"name\":\"IDLE\",\"cat\":\"fsm\",\"ph\":\"X\",\"pid\":1," + track) != std::string::npos);
+    REQUIRE(doc.find("{\"name\":\"REPAIRING\",\"cat\":\"fsm\",\"ph\":\"X\",\"pid\":1," + track) != std::string::npos);
+    REQUIRE(doc.find("\"args\":{\"name\":\"BootFsm\"}") != std::string::npos);
+    REQUIRE(doc.find("\"name\":\"App::handleBootFailure\"") != std::string::npos);
+    std::filesystem::remove(path);
+}
@@ -12,6 +12,26 @@ using Catch::Approx;
 #include "nn/advisor.h"
 #include "constants.h"  // KERNEL_GLOB
 #include "nn/feature.h"    // kFeatSize
+#include "nn/background_trainer.h"
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <new>
+#include <sstream>
+
+// Count heap allocations made by this test binary so the training hot path
+// can be checked for zero allocations.
+static std::atomic<size_t> g_allocations{0};
+
+void* operator new(size_t n) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
 
 TEST_CASE("Trainer observation increments count and save/load", "[train]") {
     Trainer t;
@@ -183,3 +203,201 @@ TEST_CASE("Trainer reset clears stats and buffer without touching weights", "[tr
 
 }
 
+
+TEST_CASE("Trainer loads checkpoints with a dense first layer", "[train][sparse]") {
+    Trainer t;
+    TelemetryEntry e;
+    e.generation   = 6;
+    e.kernelBase64 = KERNEL_GLOB;
+    t.observe(e);
+    REQUIRE(t.policy().layerType(0) == Policy::LayerType::EMBEDDING);
+
+    std::string tmp = "train_legacy.tmp";
+    REQUIRE(t.saveText(tmp));
+
+    // rewrite layer 0 the way checkpoints looked before the embedding
+    // layer: type 0 and weights in out×in order
+    std::vector<std::string> lines;
+    {
+        std::ifstream in(tmp);
+        for (std::string line; std::getline(in, line);) lines.push_back(line);
+    }
+    const int ins = t.policy().layerInSize(0), outs = t.policy().layerOutSize(0);
+    REQUIRE(lines[2] == "2 " + std::to_string(ins) + " " + std::to_string(outs));
+    lines[2] = "0 " + std::to_string(ins) + " " + std::to_string(outs);
+    {
+        std::istringstream ws(lines[3]);
+        std::vector<float> w((size_t)ins * outs);
+        for (auto& v : w) ws >> v;
+        std::ostringstream dense;
+        dense.precision(9);
+        for (int o = 0; o < outs; ++o)
+            for (int i = 0; i < ins; ++i)
+                dense << w[(size_t)i * outs + o] << " ";
+        lines[3] = dense.str();
+    }
+    // and the output layer as it was before it became LINEAR (same layout)
+    const size_t outHeader = 2 + 3 * (size_t)(t.policy().layerCount() - 1);
+    REQUIRE(lines[outHeader].rfind("3 ", 0) == 0);
+    lines[outHeader][0] = '0';
+    {
+        std::ofstream out(tmp);
+        for (const auto& line : lines) out << line << "\n";
+    }
+
+    Trainer t2;
+    REQUIRE(t2.load(tmp));
+    REQUIRE(t2.policy().layerWeights(0) == t.policy().layerWeights(0));
+    std::remove(tmp.c_str());
+}
+
+TEST_CASE("Trainer batch step and workspace forward do not allocate", "[train][alloc]") {
+    Trainer t;
+    // two sequences, one longer than a BPTT window
+    std::vector<std::vector<uint8_t>> seqs(2);
+    for (int i = 0; i < Trainer::kBpttWindow + 9; ++i) seqs[0].push_back((uint8_t)(0x20 + i % 7));
+    for (int i = 0; i < 12; ++i) seqs[1].push_back((uint8_t)(0x41 + i % 3));
+    std::vector<float> targets = { 0.25f, 0.75f };
+    t.trainBatch(seqs, targets);   // warm-up
+
+    size_t before = g_allocations.load();
+    for (int i = 0; i < 20; ++i) t.trainBatch(seqs, targets);
+    size_t stepAllocs = g_allocations.load() - before;
+    REQUIRE(stepAllocs == 0);
+
+    SparseVector x;
+    x.setOneHot(7);
+    // the same holds for a bare Policy forward into a prepared workspace,
+    // sparse or dense
+    const Policy& p = t.policy();
+    Policy::Workspace ws;
+    p.prepare(ws);
+    std::vector<float> dense(kFeatSize, 0.0f);
+    dense[3] = 1.0f;
+    before = g_allocations.load();
+    float sum = 0.0f;
+    for (int i = 0; i < 10; ++i) {
+        sum += p.forward(x, ws)[0];
+        sum += p.forward(dense, ws)[0];
+    }
+    size_t forwardAllocs = g_allocations.load() - before;
+    REQUIRE(forwardAllocs == 0);
+    REQUIRE(std::isfinite(sum));
+}
+
+TEST_CASE("Trainer learns distinct targets for distinct sequences", "[train][backprop]") {
+    // Two kernels that differ only in their opcodes: backprop through the
+    // LSTM must separate them, which the old output-only update could not.
+    Trainer t;
+    std::vector<std::vector<uint8_t>> seqs(2);
+    for (int i = 0; i < 24; ++i) {
+        seqs[0].push_back((uint8_t)(i % 2 ? 0x20 : 0x6a));   // local.get / i32.add
+        seqs[1].push_back((uint8_t)(i % 2 ? 0x41 : 0x6c));   // i32.const / i32.mul
+    }
+    std::vector<float> targets = { 0.2f, 0.9f };
+
+    float first = t.trainBatch(seqs, targets);
+    float last  = first;
+    for (int i = 0; i < 300; ++i) last = t.trainBatch(seqs, targets);
+    REQUIRE(last < first * 0.1f);
+    REQUIRE(last < 0.01f);
+}
+
+TEST_CASE("Trainer data-parallel results do not depend on the thread count", "[train][parallel]") {
+    // a corpus of the two built-in kernels with varied rewards, plus one
+    // entry without a kernel
+    std::vector<TelemetryEntry> corpus;
+    for (int i = 0; i < 40; ++i) {
+        TelemetryEntry e;
+        e.generation   = 1 + (i * 7) % 13;
+        e.kernelBase64 = i % 3 ? KERNEL_GLOB : KERNEL_SEQ;
+        if (i == 17) e.kernelBase64.clear();
+        corpus.push_back(e);
+    }
+
+    auto run = [&](int threads) {
+        auto t = std::make_unique<Trainer>();
+        t->setThreads(threads);
+        t->seed(123);
+        float loss = t->trainCorpus(corpus, 16);
+        TelemetryEntry e;
+        e.generation   = 5;
+        e.kernelBase64 = KERNEL_GLOB;
+        for (int i = 0; i < 3; ++i) t->observe(e);   // replay sampling is seeded
+        return std::make_pair(std::move(t), loss);
+    };
+    auto serial   = run(1);
+    auto parallel = run(4);
+    REQUIRE(parallel.first->threads() == 4);
+
+    REQUIRE(serial.second == parallel.second);
+    REQUIRE(serial.first->observations() == 43);
+    REQUIRE(parallel.first->observations() == 43);
+    REQUIRE(serial.first->avgLoss() == parallel.first->avgLoss());
+    REQUIRE(serial.first->test_replaySize() == parallel.first->test_replaySize());
+    for (int l = 0; l < serial.first->policy().layerCount(); ++l) {
+        REQUIRE(serial.first->policy().layerWeights(l) == parallel.first->policy().layerWeights(l));
+        REQUIRE(serial.first->policy().layerBiases(l) == parallel.first->policy().layerBiases(l));
+    }
+
+    // shrinking the pool again keeps training working
+    parallel.first->setThreads(1);
+    REQUIRE(parallel.first->threads() == 1);
+    REQUIRE(parallel.first->trainCorpus(corpus, 8) >= 0.0f);
+}
+
+TEST_CASE("BackgroundTrainer trains submitted entries off the caller's thread", "[train][async]") {
+    Trainer t;
+    BackgroundTrainer bg(t);
+    REQUIRE_FALSE(bg.running());
+
+    bg.start();
+    REQUIRE(bg.running());
+    auto first = bg.snapshot();
+    REQUIRE(first);
+    REQUIRE(first->observations == 0);
+    simd::AlignedFloats w0 = first->policy->layerWeights(0);
+
+    for (int i = 0; i < 20; ++i) {
+        TelemetryEntry e;
+        e.generation   = 1 + i % 5;
+        e.kernelBase64 = i % 2 ? KERNEL_GLOB : KERNEL_SEQ;
+        REQUIRE(bg.submit(e));
+    }
+    bg.stop();   // drains what is still queued
+    REQUIRE_FALSE(bg.running());
+
+    REQUIRE(bg.trained() == 20);
+    REQUIRE(bg.dropped() == 0);
+    REQUIRE(bg.backlog() == 0);
+    REQUIRE(t.observations() == 20);
+
+    auto last = bg.snapshot();
+    REQUIRE(last->version > first->version);
+    REQUIRE(last->observations == 20);
+    REQUIRE(last->avgLoss == t.avgLoss());
+    REQUIRE(last->policy->layerWeights(0) == t.policy().layerWeights(0));
+    REQUIRE(last->policy->layerWeights(0) != w0);
+    // the earlier snapshot is an independent copy and is still intact
+    REQUIRE(first->policy->layerWeights(0) == w0);
+}
+
+TEST_CASE("BackgroundTrainer drops entries when its queue is full", "[train][async]") {
+    Trainer t;
+    BackgroundTrainer bg(t);   // not started: nothing drains the queue
+    size_t accepted = 0;
+    for (size_t i = 0; i < BackgroundTrainer::kQueueCapacity + 10; ++i) {
+        TelemetryEntry e;
+        e.generation = 1;
+        if (bg.submit(e)) ++accepted;
+    }
+    REQUIRE(accepted == BackgroundTrainer::kQueueCapacity);
+    REQUIRE(bg.dropped() == 10);
+    REQUIRE(bg.backlog() == BackgroundTrainer::kQueueCapacity);
+
+    // starting later still trains the backlog
+    bg.start();
+    bg.stop();
+    REQUIRE(bg.trained() == BackgroundTrainer::kQueueCapacity);
+    REQUIRE(bg.backlog() == 0);
+}
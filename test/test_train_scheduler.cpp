@@ -0,0 +1,90 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+using Catch::Approx;
+#include "nn/train_scheduler.h"
+
+TEST_CASE("TrainingScheduler waits for new telemetry and the interval", "[scheduler]") {
+    TrainingScheduler s;
+    const auto& c = s.config();
+    s.begin(0, 1000);
+
+    // nothing new: never due, however long evolution runs
+    REQUIRE_FALSE(s.due(10 * c.interval, 1000));
+    // a little new data: due on the regular cadence only
+    REQUIRE_FALSE(s.due(c.interval - 1, 1010));
+    REQUIRE(s.due(c.interval, 1010));
+    REQUIRE(s.newEntries(1010) == 10);
+}
+
+TEST_CASE("TrainingScheduler trains early on stale data", "[scheduler]") {
+    TrainingScheduler s;
+    const auto& c = s.config();
+    s.begin(0, 40);
+    // this run's own entries never make the model stale
+    REQUIRE_FALSE(s.due(c.minInterval, 60));
+
+    // 20 entries from other runs on a corpus of 60 is stale, but not
+    // before minInterval
+    s.addForeign(20);
+    REQUIRE_FALSE(s.due(c.minInterval - 1, 60));
+    REQUIRE(s.due(c.minInterval, 60));
+    // ... nor once they are a small share of the corpus
+    REQUIRE_FALSE(s.due(c.minInterval, 200));
+    // a new cycle starts counting from zero
+    s.begin(c.minInterval, 60);
+    REQUIRE(s.foreignEntries() == 0);
+
+    // too few foreign entries to count as stale
+    s.addForeign(c.minNewEntries - 1);
+    REQUIRE_FALSE(s.due(2 * c.minInterval, 60 + c.minNewEntries - 1));
+}
+
+TEST_CASE("TrainingScheduler budgets and stops on a loss plateau", "[scheduler]") {
+    TrainingScheduler s;
+    const auto& c = s.config();
+
+    // first cycle: the whole corpus, `epochs` times
+    auto plan = s.begin(0, 100);
+    REQUIRE(plan.window == 100);
+    REQUIRE(plan.steps == c.epochs * 100);
+
+    // warm-up window, then a falling loss keeps the cycle going
+    float loss = 1.0f;
+    int steps = 0;
+    for (; steps < 4 * c.plateauWindow; ++steps) {
+        loss *= 0.99f;
+        REQUIRE_FALSE(s.step(loss));
+    }
+    // a flat loss stops it after `patience` windows
+    bool stopped = false;
+    while (!stopped && steps < plan.steps) {
+        ++steps;
+        stopped = s.step(loss);
+    }
+    REQUIRE(stopped);
+    REQUIRE(steps == (4 + c.patience) * c.plateauWindow);
+    s.finish(steps);
+    REQUIRE(s.converged());
+
+    // after a plateau: sparser cadence, and the budget covers the new
+    // entries plus a rehearsal share of the old ones
+    REQUIRE_FALSE(s.due(c.interval, 110));
+    REQUIRE(s.due(c.convergedInterval, 110));
+    auto next = s.plan(110);
+    REQUIRE(next.window == 10 + (int)(c.rehearsal * 100));
+    REQUIRE(next.steps == c.epochs * next.window);
+
+    // a tiny cycle still gets the minimum budget
+    TrainingScheduler small;
+    REQUIRE(small.plan(2).steps == small.config().minSteps);
+}
+
+TEST_CASE("TrainingScheduler accumulates the evolution/training split", "[scheduler]") {
+    TrainingScheduler s;
+    REQUIRE(s.trainingShare() == 0.0);
+    s.account(false, 3.0);
+    s.account(true, 1.0);
+    REQUIRE(s.evolutionSeconds() == Approx(3.0));
+    REQUIRE(s.trainingSeconds() == Approx(1.0));
+    REQUIRE(s.trainingShare() == Approx(0.25));
+}
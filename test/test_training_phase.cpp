@@ -45,6 +45,16 @@ TEST_CASE("App headless mode bypasses training immediately", "[training]") {
     REQUIRE(app.trainingProgress() == Approx(1.0f));
 }
 
+TEST_CASE("App keeps no training workers outside the headless corpus pass", "[training]") {
+    CliOptions gui = freshOpts(true);
+    gui.trainThreads = 4;
+    REQUIRE(App(gui, []() -> uint64_t { return 0; }).trainer().threads() == 1);
+
+    CliOptions headless = freshOpts(false);
+    headless.trainThreads = 4;
+    REQUIRE(App(headless, []() -> uint64_t { return 0; }).trainer().threads() == 1);
+}
+
 // ── Progress is monotonically increasing ─────────────────────────────────────
 
 TEST_CASE("trainingProgress is monotonically increasing", "[training]") {
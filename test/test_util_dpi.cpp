@@ -118,7 +118,7 @@ TEST_CASE("AppLogger creates lock file during flush", "[log]") {
     fs::create_directories(logs);
     AppLogger logger;
     logger.init((logs / "test.log").string());
-    logger.log("hi","info");
+    logger.log("hi", LogType::INFO);
     logger.flush();
     REQUIRE(fs::exists((logs / "test.log.lock").string()));
     fs::remove_all(logs);